@@ -177,10 +177,10 @@ namespace Classifier
             //get the number of samples
             size_t numberOfSamples = sampleSet.Size( );
 
-            // Compute features
-            if ( !sampleSet.IsFeatureComputed( ) ) 
+            // Compute the features of the selected weak classifiers only
+            if ( !sampleSet.IsFeatureComputed( m_selectorList ) )
             {
-                m_featureVectorPtr->Compute( sampleSet );
+                m_featureVectorPtr->Compute( sampleSet, true, &m_selectorList );
             }
 
             //response list to store the response for each sample
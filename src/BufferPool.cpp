@@ -0,0 +1,127 @@
+#include "BufferPool.h"
+
+//planes kept per geometry; the excess goes back to the allocator
+#define BUFFER_POOL_MAXIMUM_FREE_PLANES_PER_GEOMETRY    8
+
+/********************************************************************
+BufferPool
+    Constructor.
+Exceptions:
+    None
+*********************************************************************/
+BufferPool::BufferPool( )
+    : m_freePlaneMap( ),
+    m_numberOfAllocations( 0 ),
+    m_numberOfReuses( 0 )
+{
+}
+
+/********************************************************************
+~BufferPool
+    Destructor. Frees the planes still in the free lists; the planes
+    in use belong to matrices that keep the pool alive.
+Exceptions:
+    None
+*********************************************************************/
+BufferPool::~BufferPool( )
+{
+    for ( std::map< PlaneGeometry, vector<FreePlane> >::iterator iter = m_freePlaneMap.begin(); iter != m_freePlaneMap.end(); iter++ )
+    {
+        for ( uint planeIndex = 0; planeIndex < iter->second.size(); planeIndex++ )
+        {
+            MatrixBackend::FreePlane( iter->second[planeIndex].m_pPlane );
+        }
+    }
+}
+
+/********************************************************************
+Acquire
+    Get a plane of the given geometry, recycled from the free list if
+    possible, otherwise taken from the allocator.
+Exceptions:
+    None
+*********************************************************************/
+void* BufferPool::Acquire( const int elementSize, const int cols, const int rows, int& step )
+{
+    ASSERT_TRUE( elementSize == sizeof(Ipp8u) || elementSize == sizeof(Ipp32f) || elementSize == sizeof(Ipp64f) );
+
+    PlaneGeometry geometry;
+    geometry.m_elementSize    = elementSize;
+    geometry.m_cols            = cols;
+    geometry.m_rows            = rows;
+
+    {
+        boost::mutex::scoped_lock lock( m_mutex );
+
+        vector<FreePlane>& freePlaneList = m_freePlaneMap[geometry];
+        if ( !freePlaneList.empty() )
+        {
+            FreePlane freePlane = freePlaneList.back();
+            freePlaneList.pop_back();
+            m_numberOfReuses++;
+
+            step = freePlane.m_step;
+            return freePlane.m_pPlane;
+        }
+
+        m_numberOfAllocations++;
+    }
+
+    return MatrixBackend::AllocPlane( elementSize, cols, rows, step );
+}
+
+/********************************************************************
+Release
+    Give a plane back to the free list of its geometry, or to the
+    allocator if that list is full.
+Exceptions:
+    None
+*********************************************************************/
+void BufferPool::Release( void* pPlane, const int elementSize, const int cols, const int rows, const int step )
+{
+    if ( pPlane == NULL )
+    {
+        return;
+    }
+
+    PlaneGeometry geometry;
+    geometry.m_elementSize    = elementSize;
+    geometry.m_cols            = cols;
+    geometry.m_rows            = rows;
+
+    FreePlane freePlane;
+    freePlane.m_pPlane    = pPlane;
+    freePlane.m_step    = step;
+
+    {
+        boost::mutex::scoped_lock lock( m_mutex );
+
+        vector<FreePlane>& freePlaneList = m_freePlaneMap[geometry];
+        if ( freePlaneList.size() < BUFFER_POOL_MAXIMUM_FREE_PLANES_PER_GEOMETRY )
+        {
+            freePlaneList.push_back( freePlane );
+            return;
+        }
+    }
+
+    MatrixBackend::FreePlane( pPlane );
+}
+
+/********************************************************************
+PlaneGeometry::operator<
+    Order of the geometries in the free list map.
+Exceptions:
+    None
+*********************************************************************/
+bool BufferPool::PlaneGeometry::operator< ( const PlaneGeometry& geometry ) const
+{
+    if ( m_elementSize != geometry.m_elementSize )
+    {
+        return m_elementSize < geometry.m_elementSize;
+    }
+    if ( m_cols != geometry.m_cols )
+    {
+        return m_cols < geometry.m_cols;
+    }
+    return m_rows < geometry.m_rows;
+}
@@ -0,0 +1,69 @@
+#ifndef BUFFER_POOL_HEADER
+#define BUFFER_POOL_HEADER
+
+#include "Public.h"
+#include "CommonMacros.h"
+
+#include <map>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+//Forward Declaration
+class BufferPool;
+
+//declarations of shared ptr
+typedef boost::shared_ptr<BufferPool>    BufferPoolPtr;
+
+/****************************************************************
+BufferPool
+    Recycles the IPP image planes of the matrices of a camera.
+    A plane given back by a matrix (when it is freed, resized or
+    drops its integral image) is kept in a free list for its
+    geometry and handed out again to the next matrix asking for
+    the same geometry, instead of going back to the allocator.
+    Each free list holds a few planes at most, so geometries that
+    were only needed for a burst don't pin their memory.
+    Matrices attached to the pool keep it alive (see
+    Matrix::setBufferPool). The pool may be used from several
+    threads at once.
+****************************************************************/
+class BufferPool
+{
+public:
+    BufferPool( );
+    ~BufferPool( );
+
+    //get a plane of cols x rows elements of the given size (1: 8u, 4: 32f or 32-bit integral, 8: 64-bit integral); step in bytes
+    void*    Acquire( const int elementSize, const int cols, const int rows, int& step );
+
+    //give a plane back for reuse
+    void    Release( void* pPlane, const int elementSize, const int cols, const int rows, const int step );
+
+    //number of planes allocated and recycled so far
+    long    GetNumberOfAllocations( ) const { return m_numberOfAllocations; }
+    long    GetNumberOfReuses( ) const { return m_numberOfReuses; }
+
+private:
+    DISALLOW_EVIL_CONSTRUCTORS( BufferPool );
+
+    struct PlaneGeometry
+    {
+        int    m_elementSize;
+        int    m_cols;
+        int    m_rows;
+
+        bool operator< ( const PlaneGeometry& geometry ) const;
+    };
+
+    struct FreePlane
+    {
+        void*    m_pPlane;
+        int        m_step;
+    };
+
+    boost::mutex                                        m_mutex;                //guards the free lists
+    std::map< PlaneGeometry, vector<FreePlane> >        m_freePlaneMap;            //free planes by geometry
+    long                                                m_numberOfAllocations;    //planes taken from the allocator
+    long                                                m_numberOfReuses;        //planes handed out again
+};
+#endif
@@ -1,9 +1,8 @@
 #include "Camera.h"
 #include "CommonMacros.h"
 #include "GeometryBasedInformationFuser.h"
-
-#define IMAGE_NAME_PREFIX "img"
-#define IMAGE_TYPE          "png"
+#include "FrameSourceFactory.h"
+#include "RawFrameFile.h"
 
 namespace MultipleCameraTracking
 {
@@ -15,13 +14,23 @@ namespace MultipleCameraTracking
     *********************************************************************/
     Camera::Camera( const int                        cameraId,
                     const vectori&                    objectIdList,
-                    CameraTrackingParametersPtr        cameraTrackingParametersPtr )
+                    const float                        processingScale,
+                    CameraTrackingParametersPtr        cameraTrackingParametersPtr,
+                    VideoEncoderPtr                    videoEncoderPtr )
         : m_pHomographyMatrix( cvCreateMat( 3, 3, CV_64FC1 ) ),
         m_cameraTrackingParametersPtr ( ASSERT_PRECONDITION_PARAMETER( cameraTrackingParametersPtr != NULL, cameraTrackingParametersPtr ) ), 
-        m_videoMatrix( ),
+        m_frameSourcePtr( ),
+        m_bufferPoolPtr( new BufferPool( ) ),
+        m_frameImageCachePtr( new FrameImageCache( m_bufferPoolPtr ) ),
         m_frameMatrix( ),
         m_initialState( ),
-        m_cameraID( cameraId )        
+        m_processingScale( processingScale ),
+        m_processingWidth( 0 ),
+        m_processingHeight( 0 ),
+        m_cameraID( cameraId ),
+        m_videoEncoderPtr( ASSERT_PRECONDITION_PARAMETER( videoEncoderPtr != NULL, videoEncoderPtr ) ),
+        m_trackedVideoId( -1 ),
+        m_trainingVideoId( -1 )
     {
         try
         {
@@ -38,6 +47,13 @@ namespace MultipleCameraTracking
             m_displayTrackedVideo        =    ( g_configInput.m_displayOutputVideo == 1);        //whether to display output video
             m_displayTrainingSamples    =    ( g_configInput.m_displayTrainingSamples == 1); //whether to display training examples
 
+            //frames for display are copied into recycled planes
+            m_frameDisplay.setBufferPool( m_bufferPoolPtr );
+            m_frameDisplayTraining.setBufferPool( m_bufferPoolPtr );
+            m_scaledFrame.setBufferPool( m_bufferPoolPtr );
+
+            ASSERT_TRUE( m_processingScale > 0 && m_processingScale <= 1 );
+
             //tracking parameters    
             if ( m_cameraTrackingParametersPtr->m_appearanceFusionType != NO_APPEARANCE_FUSION ||
                     m_cameraTrackingParametersPtr->m_trackerFeatureType == Features::CULTURE_COLOR_HISTOGRAM ||
@@ -94,11 +110,8 @@ namespace MultipleCameraTracking
         randinitalize(m_cameraTrackingParametersPtr->m_trialNumber);
 
         //Data directory location
-        string dataDir = string( m_cameraTrackingParametersPtr->m_inputDirectoryString );
+        string dataDir = GetDataDirectory( m_cameraTrackingParametersPtr );
         string outputDir = string( m_cameraTrackingParametersPtr->m_outputDirectoryString );
-        if( dataDir[dataDir.length()-2] != '/' ) dataDir+="/";
-        dataDir += m_cameraTrackingParametersPtr->m_dataNameString;
-        dataDir += "/";
 
         if( outputDir[outputDir.length()-2] != '/' ) outputDir+="/";
 
@@ -131,6 +144,13 @@ namespace MultipleCameraTracking
             m_pHomographyMatrix->data.db[objInd] = homoGraphy(objInd);
         }
 
+        //the homography maps processing coordinates: H * diag(1/scale, 1/scale, 1)
+        for ( int row = 0; row < 3; row++ )
+        {
+            m_pHomographyMatrix->data.db[row*3]        /= m_processingScale;
+            m_pHomographyMatrix->data.db[row*3 + 1]    /= m_processingScale;
+        }
+
         //Initialize the objects
         //create the list of objects inside the cameras
         for( int objInd = 0; objInd < objectIdList.size(); objInd++)
@@ -139,7 +159,8 @@ namespace MultipleCameraTracking
                                             m_cameraID,
                                             m_sourceIsColorImage,
                                             m_cameraTrackingParametersPtr,
-                                            m_pHomographyMatrix ) 
+                                            m_pHomographyMatrix,
+                                            m_frameImageCachePtr ) 
                                             );
 
             ASSERT_TRUE( objectPtr != NULL );
@@ -169,23 +190,32 @@ namespace MultipleCameraTracking
                 abortError(__LINE__,__FILE__,"Error: invalid classifier choice.");
         }
 
-        // Load the video into the memory
-        m_videoMatrix.clear();
-        if ( m_readImages )
-        {
-            m_videoMatrix = Matrixu::LoadVideo( (dataDir + "imgs" + int2str(m_cameraID,3) + "/").c_str(),
-                                                IMAGE_NAME_PREFIX,
-                                                IMAGE_TYPE,
-                                                (int)m_frameMatrix(0),
-                                                (int)m_frameMatrix(1),
-                                                5,m_sourceIsColorImage);
-        }
-        else
+        // Open the input video; the frame source decides whether it is loaded into the memory at once
+        FrameSourceType frameSourceType = (FrameSourceType)g_configInput.m_frameSourceType;
+        string            inputPath        = ( frameSourceType == LIVE_FRAME_SOURCE ) ?
+                                            GetLiveInputPath( dataDir, m_cameraID, (LiveInputFormat)g_configInput.m_liveInputFormat, m_sourceIsColorImage ) :
+                                            GetInputPath( dataDir, m_cameraID, m_readImages, frameSourceType == MAPPED_FRAME_SOURCE );
+
+        m_frameSourcePtr = FrameSourceFactory::CreateFrameSource( frameSourceType,
+                                                                  inputPath,
+                                                                  m_readImages,
+                                                                  (int)m_frameMatrix(0),
+                                                                  (int)m_frameMatrix(1),
+                                                                  m_sourceIsColorImage,
+                                                                  g_configInput.m_frameRingSize,
+                                                                  g_configInput.m_frameReadAheadSize,
+                                                                  g_configInput.m_liveInputFormat,
+                                                                  g_configInput.m_liveFrameWidth,
+                                                                  g_configInput.m_liveFrameHeight,
+                                                                  g_configInput.m_liveAlignmentWindow );
+
+        //frames are tracked, displayed and saved at the processing scale
+        m_processingWidth    = max( 1, cvRound( m_frameSourcePtr->GetFrameWidth() * m_processingScale ) );
+        m_processingHeight    = max( 1, cvRound( m_frameSourcePtr->GetFrameHeight() * m_processingScale ) );
+
+        if ( m_processingScale != 1.0f )
         {
-            m_videoMatrix = Matrixu::LoadVideoStream( (dataDir + "video" + int2str(m_cameraID,3) + ".avi").c_str(),
-                                                        (int)m_frameMatrix(0),
-                                                        (int)m_frameMatrix(1),
-                                                        m_sourceIsColorImage);
+            LOG( "Camera " << m_cameraID << " tracks at " << m_processingWidth << "x" << m_processingHeight << " (scale " << m_processingScale << ")" << endl );
         }
 
         // Load ground truth if necessary
@@ -203,20 +233,14 @@ namespace MultipleCameraTracking
         }
 
         //initialize all output video files if required
-        m_pVideoWriter = NULL;
-        m_pVideoWriterTraining = NULL;
         if ( m_saveTrackedVideo )
         { //save tracked frames
             string m_videoSave    =    outputDir +  m_cameraTrackingParametersPtr->m_nameInitilizationString +"/"+
                 "TR" + int2str(m_cameraTrackingParametersPtr->m_trialNumber,3) + "_C" + int2str(m_cameraID,3)+ paramname + ".avi";
             
-            m_pVideoWriter = cvCreateVideoWriter( m_videoSave.c_str(), 
-                CV_FOURCC('x','v','i','d'),
-                15, 
-                cvSize(m_videoMatrix[0].cols(), m_videoMatrix[0].rows() ),
-                3 );
+            m_trackedVideoId = m_videoEncoderPtr->OpenVideo( m_videoSave, m_processingWidth, m_processingHeight );
 
-            if ( m_pVideoWriter==NULL ) 
+            if ( m_trackedVideoId < 0 ) 
             {
                 abortError(__LINE__,__FILE__,"Error opening video file for output");
             }
@@ -228,13 +252,9 @@ namespace MultipleCameraTracking
             string m_videoTrainingExamples    =  outputDir +  m_cameraTrackingParametersPtr->m_nameInitilizationString +"/"+ 
                     "TR" + int2str(m_cameraTrackingParametersPtr->m_trialNumber,3) + "_C" + int2str(m_cameraID,3)+ paramname + "_Training.avi";
 
-            m_pVideoWriterTraining = cvCreateVideoWriter( m_videoTrainingExamples.c_str(), 
-                CV_FOURCC('x','v','i','d'),
-                15, 
-                cvSize(m_videoMatrix[0].cols(), m_videoMatrix[0].rows() ),
-                3 );
+            m_trainingVideoId = m_videoEncoderPtr->OpenVideo( m_videoTrainingExamples, m_processingWidth, m_processingHeight );
 
-            if ( m_pVideoWriterTraining==NULL ) 
+            if ( m_trainingVideoId < 0 ) 
             {
                 abortError(__LINE__,__FILE__,"Error opening video file for output");
             }
@@ -259,14 +279,120 @@ namespace MultipleCameraTracking
                 { //find the initial object state from the matrix m_initialState
                     for( int k = 0; k < 4; k++ )
                     {
-                        objectInitialState[k] = m_initialState( j, k );
+                        //the box is given in native coordinates
+                        objectInitialState[k] = m_initialState( j, k ) * m_processingScale;
                     }
                     objectInitialState[4] = m_initialState(j,5) - m_frameMatrix(0);
                     break;
                 }
             }
-            m_objectPtrList[objInd]->InitializeObjectParameters( objectInitialState,m_trajSaveStrBase );                    
+            m_objectPtrList[objInd]->InitializeObjectParameters( objectInitialState, m_trajSaveStrBase, m_processingScale );                    
+        }
+    }
+
+    /********************************************************************
+    ConvertInputToRawFrameFile
+        Tool mode. Decodes the input of the given camera once and 
+        writes it into a raw frame file, which MappedFrameSource maps
+        on later runs instead of decoding again.
+    Exceptions:
+        None
+    *********************************************************************/
+    void Camera::ConvertInputToRawFrameFile( const int cameraId, CameraTrackingParametersPtr cameraTrackingParametersPtr )
+    {
+        try
+        {
+            ASSERT_TRUE( cameraTrackingParametersPtr != NULL );
+
+            const bool readImages        = ( g_configInput.m_loadVideoFromImgs == 1 );
+            const int startFrameIndex    = g_configInput.m_startFrameIndex;
+            const int endFrameIndex        = g_configInput.m_startFrameIndex + g_configInput.m_numOfFrames - 1;
+            string dataDir                = GetDataDirectory( cameraTrackingParametersPtr );
+
+            //a ring of one frame is enough to read the input sequentially
+            FrameSourcePtr frameSourcePtr = FrameSourceFactory::CreateFrameSource( STREAMING_FRAME_SOURCE,
+                                                                                   GetInputPath( dataDir, cameraId, readImages, false ),
+                                                                                   readImages,
+                                                                                   startFrameIndex,
+                                                                                   endFrameIndex,
+                                                                                   g_configInput.m_loadVideoWithColor == 1,
+                                                                                   1,
+                                                                                   1,
+                                                                                   0,
+                                                                                   0,
+                                                                                   0,
+                                                                                   0 );
+
+            string rawFrameFileName = GetInputPath( dataDir, cameraId, readImages, true );
+            LOG( "Converting the input of camera " << cameraId << " to " << rawFrameFileName << endl );
+
+            RawFrameFile::Write( frameSourcePtr, startFrameIndex, rawFrameFileName );
+        }
+        EXCEPTION_CATCH_AND_ABORT( "Failed to convert the input to a raw frame file" );
+    }
+
+    /********************************************************************
+    GetDataDirectory
+        Directory holding the data files of the experiment.
+    Exceptions:
+        None
+    *********************************************************************/
+    string Camera::GetDataDirectory( CameraTrackingParametersPtr cameraTrackingParametersPtr )
+    {
+        string dataDir = string( cameraTrackingParametersPtr->m_inputDirectoryString );
+        if( dataDir[dataDir.length()-2] != '/' ) dataDir+="/";
+        dataDir += cameraTrackingParametersPtr->m_dataNameString;
+        dataDir += "/";
+
+        return dataDir;
+    }
+
+    /********************************************************************
+    GetInputPath
+        Input of the camera: the image directory, the video file or
+        the raw frame file converted from either of them.
+    Exceptions:
+        None
+    *********************************************************************/
+    string Camera::GetInputPath( const string& dataDir, const int cameraId, const bool readImages, const bool rawFrameFile )
+    {
+        string inputName = dataDir + ( readImages ? "imgs" : "video" ) + int2str( cameraId, 3 );
+
+        if ( rawFrameFile )
+        {
+            return inputName + RAW_FRAME_FILE_EXTENSION;
         }
+
+        return readImages ? ( inputName + "/" ) : ( inputName + ".avi" );
+    }
+
+    /********************************************************************
+    GetLiveInputPath
+        FIFO the live frames of the camera are written to.
+    Exceptions:
+        None
+    *********************************************************************/
+    string Camera::GetLiveInputPath( const string& dataDir, const int cameraId, const LiveInputFormat liveInputFormat, const bool isColor )
+    {
+        string inputName = dataDir + "live" + int2str( cameraId, 3 );
+
+        if ( liveInputFormat == LIVE_INPUT_Y4M )
+        {
+            return inputName + LIVE_Y4M_EXTENSION;
+        }
+
+        return inputName + ( isColor ? LIVE_RGB_EXTENSION : LIVE_GRAY_EXTENSION );
+    }
+
+    /********************************************************************
+    GetLiveFrameSource
+        Live frame source of the camera, NULL for the other sources.
+    Exceptions:
+        None
+    *********************************************************************/
+    LiveFrameSourcePtr Camera::GetLiveFrameSource( )
+    {
+        return boost::dynamic_pointer_cast<LiveFrameSource>( m_frameSourcePtr );
     }
 
     /********************************************************************
@@ -297,7 +423,7 @@ namespace MultipleCameraTracking
                 if( m_objectPtrList[i]->InitializeObjectTracker( m_pCurrentFrameImageMatrixColor,
                                                                  m_pCurrentFrameImageMatrixGray,
                                                                  frameInd, 
-                                                                 m_videoMatrix.size(),
+                                                                 m_frameSourcePtr->GetNumberOfFrames(),
                                                                  m_pFrameDisplay, 
                                                                  m_pFrameDisplayTraining,
                                                                  m_pCurrentFrameImageMatrixHSV, 
@@ -306,13 +432,8 @@ namespace MultipleCameraTracking
                     m_objectStatusList[i] = OBJECT_TRACKING_IN_PROGRESS;
                 }                            
             }
-            if ( ( m_cameraTrackingParametersPtr->m_trackerFeatureType == Features::HAAR_LIKE 
-                || m_cameraTrackingParametersPtr->m_trackerFeatureType == Features::HAAR_COLOR_HISTOGRAM ) 
-                && m_pCurrentFrameImageMatrixGray->isInitII() )
-            { 
-                //free the integral image
-                m_pCurrentFrameImageMatrixGray->FreeII();
-            }
+            //the integral image is no longer needed for this frame (its buffer is kept for the next one)
+            m_frameImageCachePtr->ReleaseIntegralImage();
 
             DisplayAndSaveTrackedFrame();
             DisplayAndSaveTrainingSamples();
@@ -360,7 +481,7 @@ namespace MultipleCameraTracking
                         if( m_objectPtrList[objInd]->InitializeObjectTracker(   m_pCurrentFrameImageMatrixColor,
                                                                                 m_pCurrentFrameImageMatrixGray,
                                                                                 frameInd, 
-                                                                                m_videoMatrix.size(),
+                                                                                m_frameSourcePtr->GetNumberOfFrames(),
                                                                                 m_pFrameDisplay, 
                                                                                 m_pFrameDisplayTraining,
                                                                                 m_pCurrentFrameImageMatrixHSV,
@@ -381,13 +502,8 @@ namespace MultipleCameraTracking
                 DisplayAndSaveTrackedFrame();
                 DisplayAndSaveTrainingSamples();
 
-                if( ( m_cameraTrackingParametersPtr->m_trackerFeatureType == Features::HAAR_LIKE 
-                    || m_cameraTrackingParametersPtr->m_trackerFeatureType == Features::HAAR_COLOR_HISTOGRAM )  
-                    && m_pCurrentFrameImageMatrixGray->isInitII() )
-                { 
-                    //free the integral image
-                    m_pCurrentFrameImageMatrixGray->FreeII();
-                }
+                //the integral image is no longer needed for this frame (its buffer is kept for the next one)
+                m_frameImageCachePtr->ReleaseIntegralImage();
             }
             //if fusion is enabled, frame display will be called inside StoreAllParticleFilterTrackerState
             //if fusion is enabled, sample display will be called inside LearnLocalAppearanceModel
@@ -404,6 +520,16 @@ namespace MultipleCameraTracking
     *********************************************************************/
     void Camera::PrepareCurrentFrameForTracking( int frameInd )
     {
+        Matrixu* pFrame = m_frameSourcePtr->GetFrame( frameInd );
+        ASSERT_TRUE( pFrame != NULL );
+
+        //downsample once, everything below works at the processing scale
+        if ( m_processingScale != 1.0f )
+        {
+            pFrame->imResizeBox( m_scaledFrame, m_processingHeight, m_processingWidth );
+            pFrame = &m_scaledFrame;
+        }
+
         m_pFrameDisplayTraining=NULL;
         m_pFrameDisplay = NULL;
         //create a frame for drawing (for either display or video saving)
@@ -411,14 +537,14 @@ namespace MultipleCameraTracking
         {
             if( m_sourceIsColorImage )
             {
-                ASSERT_TRUE( m_videoMatrix[frameInd].depth( ) == 3);
-                m_frameDisplay = m_videoMatrix[frameInd];
+                ASSERT_TRUE( pFrame->depth( ) == 3);
+                m_frameDisplay = *pFrame;
             }
             else
             {
-                m_videoMatrix[frameInd].conv2RGB(m_frameDisplay);
+                pFrame->conv2RGB(m_frameDisplay);
             }
-            m_frameDisplay.createIpl();
+            m_frameDisplay.createIpl( true );    //refreshed in place, the image is kept across frames
             m_frameDisplay._keepIpl = true;
             m_pFrameDisplay = & m_frameDisplay;
 
@@ -431,14 +557,14 @@ namespace MultipleCameraTracking
         {
             if( m_sourceIsColorImage )
             {
-                ASSERT_TRUE( m_videoMatrix[frameInd].depth( ) == 3);
-                m_frameDisplayTraining = m_videoMatrix[frameInd];
+                ASSERT_TRUE( pFrame->depth( ) == 3);
+                m_frameDisplayTraining = *pFrame;
             }
             else
             {
-                m_videoMatrix[frameInd].conv2RGB(m_frameDisplayTraining);
+                pFrame->conv2RGB(m_frameDisplayTraining);
             }
-            m_frameDisplayTraining.createIpl();
+            m_frameDisplayTraining.createIpl( true );    //refreshed in place, the image is kept across frames
             m_frameDisplayTraining._keepIpl = true;
             m_pFrameDisplayTraining = & m_frameDisplayTraining;
 
@@ -446,52 +572,85 @@ namespace MultipleCameraTracking
             m_frameDisplayTraining.drawText(("#"+int2str(frameInd,3)).c_str(),1,25,255,255,0);
         }
 
-        //convert the current frame to gray/color/hsv if necessary
+        const bool grayRequired = m_cameraTrackingParametersPtr->m_trackerFeatureType == Features::HAAR_LIKE 
+                                || m_cameraTrackingParametersPtr->m_trackerFeatureType == Features::HAAR_COLOR_HISTOGRAM;
+
+        //only the parts of the frame read by the trackers are prepared, if possible
+        vector<IppiRect>    regionOfInterestList;
+        const bool            isRestrictedToRegionsOfInterest = ComputeRegionsOfInterest( regionOfInterestList );
+
+        //gray image, its integral image and the HSV image are derived once per frame by the cache;
+        //the other products are computed on first use by the features
+        m_frameImageCachePtr->SetFrame( pFrame, frameInd );
+
         if( m_sourceIsColorImage )
         {
-            ASSERT_TRUE(m_videoMatrix[frameInd].depth() == 3);
+            ASSERT_TRUE(pFrame->depth() == 3);
 
-            m_pCurrentFrameImageMatrixColor    = & (m_videoMatrix[frameInd]);        
+            m_frameImageCachePtr->Prepare( grayRequired, 
+                                           m_cameraTrackingParametersPtr->m_HSVRequired, 
+                                           isRestrictedToRegionsOfInterest ? &regionOfInterestList : NULL );
 
-            if (  m_cameraTrackingParametersPtr->m_trackerFeatureType == Features::HAAR_LIKE 
-                || m_cameraTrackingParametersPtr->m_trackerFeatureType == Features::HAAR_COLOR_HISTOGRAM )
-            {  
-                //create a temporary gray image
-                m_videoMatrix[frameInd].conv2BW( m_grayScaleImageMatrix );
-                m_pCurrentFrameImageMatrixGray  = & m_grayScaleImageMatrix;
-            }
-            else
-            {    
-                m_pCurrentFrameImageMatrixGray = NULL;
-            }
+            m_pCurrentFrameImageMatrixColor    = m_frameImageCachePtr->GetColorImage( );
+            m_pCurrentFrameImageMatrixGray  = grayRequired ? m_frameImageCachePtr->GetGrayImage( ) : NULL;
+            m_pCurrentFrameImageMatrixHSV    = m_cameraTrackingParametersPtr->m_HSVRequired ? m_frameImageCachePtr->GetHSVImage( ) : NULL;
         }
         else
         {
-            m_pCurrentFrameImageMatrixGray    =  & (m_videoMatrix[frameInd]);
+            ASSERT_TRUE ( !m_cameraTrackingParametersPtr->m_HSVRequired );
+
+            m_frameImageCachePtr->Prepare( grayRequired, 
+                                           false, 
+                                           isRestrictedToRegionsOfInterest ? &regionOfInterestList : NULL );
+
+            m_pCurrentFrameImageMatrixGray    = m_frameImageCachePtr->GetGrayImage( );
             m_pCurrentFrameImageMatrixColor = NULL;
+            m_pCurrentFrameImageMatrixHSV    = NULL;
         }
 
-        if( m_cameraTrackingParametersPtr->m_HSVRequired )
+        if ( grayRequired )
         {
-            ASSERT_TRUE ( m_pCurrentFrameImageMatrixColor != NULL );
-            m_pCurrentFrameImageMatrixColor->conv2HSV( m_HSVImageMatrix );
-            m_pCurrentFrameImageMatrixHSV = &m_HSVImageMatrix;
-        }        
-        else
+            ASSERT_TRUE( m_pCurrentFrameImageMatrixGray->isInitII() );
+        }
+    }
+
+    /********************************************************************
+    ComputeRegionsOfInterest
+        Collect the regions of the current frame read by the trackers of
+        all the objects. The whole frame is needed when the restriction
+        is disabled, when fusion reads the frames outside the trackers,
+        or when any object is not tracked yet or can read anywhere.
+    Exceptions:
+        None
+    *********************************************************************/
+    bool Camera::ComputeRegionsOfInterest( vector<IppiRect>& regionOfInterestList )
+    {
+        regionOfInterestList.clear();
+
+        if ( !g_configInput.m_restrictFramePreparationToROI 
+            || m_cameraTrackingParametersPtr->m_geometricFusionType != NO_GEOMETRIC_FUSION 
+            || m_cameraTrackingParametersPtr->m_appearanceFusionType != NO_APPEARANCE_FUSION )
         {
-            m_pCurrentFrameImageMatrixHSV = NULL;
+            return false;
         }
 
-        if (  m_cameraTrackingParametersPtr->m_trackerFeatureType == Features::HAAR_LIKE 
-            || m_cameraTrackingParametersPtr->m_trackerFeatureType == Features::HAAR_COLOR_HISTOGRAM )
-        {  
-            //initialize integral image
-            if( !m_pCurrentFrameImageMatrixGray->isInitII() )
+        for ( int objInd = 0; objInd < m_objectPtrList.size(); objInd++ )
+        {
+            IppiRect regionOfInterest;
+
+            if ( m_objectStatusList[objInd] != OBJECT_TRACKING_IN_PROGRESS 
+                || !m_objectPtrList[objInd]->ComputeRegionOfInterest( m_processingWidth, 
+                                                                      m_processingHeight, 
+                                                                      regionOfInterest ) )
             {
-                m_pCurrentFrameImageMatrixGray->initII();    // Initialize Image Integral     
-                ASSERT_TRUE( m_pCurrentFrameImageMatrixGray->isInitII() );
-            }                
+                regionOfInterestList.clear();
+                return false;
+            }
+
+            regionOfInterestList.push_back( regionOfInterest );
         }
+
+        return !regionOfInterestList.empty();
     }
 
     /********************************************************************
@@ -505,18 +664,11 @@ namespace MultipleCameraTracking
         if( m_displayTrackedVideo )
         {    // display the tracked frame on screen
             m_frameDisplay.display( m_cameraID );
-            cvWaitKey(1);
         }
 
         if( m_saveTrackedVideo )
-        {    //save the tracked frame to video file
-            Matrixu::WriteFrame( m_pVideoWriter, m_frameDisplay );
-        }
-
-        if( m_displayTrackedVideo || m_saveTrackedVideo)
-        {    
-            m_frameDisplay._keepIpl = false;
-            m_frameDisplay.freeIpl();
+        {    //queue a snapshot of the tracked frame for the video file
+            m_videoEncoderPtr->WriteFrame( m_trackedVideoId, m_frameDisplay );
         }
     }
 
@@ -533,16 +685,10 @@ namespace MultipleCameraTracking
             m_frameDisplayTraining.display(
                 ("TrainingExamples"+int2str(m_cameraID,3)).c_str()
                 );
-            cvWaitKey(1);
         }
         if( m_saveVideoTrainingExamples )
         {
-            Matrixu::WriteFrame( m_pVideoWriterTraining, m_frameDisplayTraining );
-        }
-        if( m_displayTrainingSamples || m_saveVideoTrainingExamples)
-        {
-            m_frameDisplayTraining._keepIpl = false;
-            m_frameDisplayTraining.freeIpl();
+            m_videoEncoderPtr->WriteFrame( m_trainingVideoId, m_frameDisplayTraining );
         }
     }
     /********************************************************************
@@ -620,13 +766,8 @@ namespace MultipleCameraTracking
                 }
             }
 
-            if( ( m_cameraTrackingParametersPtr->m_trackerFeatureType == Features::HAAR_LIKE 
-                || m_cameraTrackingParametersPtr->m_trackerFeatureType == Features::HAAR_COLOR_HISTOGRAM )  
-                && m_pCurrentFrameImageMatrixGray->isInitII() )
-            { 
-                //free the integral image as they are no longer needed.
-                m_pCurrentFrameImageMatrixGray->FreeII();
-            }
+            //the integral image is no longer needed for this frame (its buffer is kept for the next one)
+            m_frameImageCachePtr->ReleaseIntegralImage();
         }
         EXCEPTION_CATCH_AND_ABORT( "Error in Camera.UpdateParticleFilterTrackerAppearanceModel" ); 
     }
@@ -645,17 +786,14 @@ namespace MultipleCameraTracking
         }
         
         // clean up
-        if ( m_pVideoWriter != NULL )
-        {
-            //release the videoList writer
-            cvReleaseVideoWriter( &m_pVideoWriter );
-        }
-
-        if( m_pVideoWriterTraining != NULL)
-        {
-            //release the videoList writer
-            cvReleaseVideoWriter( &m_pVideoWriterTraining );
-        }
+        //finish encoding and close the videos
+        m_videoEncoderPtr->CloseVideo( m_trackedVideoId );
+        m_videoEncoderPtr->CloseVideo( m_trainingVideoId );
+        m_trackedVideoId    = -1;
+        m_trainingVideoId    = -1;
+
+        LOG( "Camera " << m_cameraID << " buffer pool: " << m_bufferPoolPtr->GetNumberOfAllocations() << " allocations, "
+             << m_bufferPoolPtr->GetNumberOfReuses() << " reuses" << endl );
     }
 
     /********************************************************************
@@ -9,6 +9,10 @@
 #include "CameraNetworkBase.h"
 #include "DefaultParameters.h"
 #include "Config.h"
+#include "FrameSource.h"
+#include "LiveFrameSource.h"
+#include "FrameImageCache.h"
+#include "VideoEncoder.h"
 
 #include <boost/shared_ptr.hpp>
 
@@ -36,7 +40,9 @@ namespace MultipleCameraTracking
         //Constructor
         Camera( const int                        cameraId,
                 const vectori&                    objectIdList,
-                CameraTrackingParametersPtr        cameraTrackingParametersPtr );
+                const float                        processingScale,
+                CameraTrackingParametersPtr        cameraTrackingParametersPtr,
+                VideoEncoderPtr                    videoEncoderPtr );
 
         ~Camera( ){ }
 
@@ -45,7 +51,7 @@ namespace MultipleCameraTracking
 
         Matrixu*    GetColorImageMatrix( ){ return m_pCurrentFrameImageMatrixColor; }
         Matrixu*    GetGrayImageMatrix( ){ return m_pCurrentFrameImageMatrixGray; }
-        Matrixu*    GetHSVImageMatrix( ){ return &m_HSVImageMatrix; }
+        Matrixu*    GetHSVImageMatrix( ){ return m_pCurrentFrameImageMatrixHSV; }
 
         //Learn global appearance model using the appearance fuser
         void LearnGlobalAppearanceModel( CameraNetworkBasePtr cameraNetworkBasePtr );
@@ -81,6 +87,12 @@ namespace MultipleCameraTracking
         //draw object's predicted foot points on the image
         void    DrawAllObjectFootPoints( );
 
+        //live frame source of the camera (NULL unless LIVE_FRAME_SOURCE)
+        LiveFrameSourcePtr GetLiveFrameSource( );
+
+        //convert the camera's input to a raw frame file for MAPPED_FRAME_SOURCE (tool mode)
+        static void ConvertInputToRawFrameFile( const int cameraId, CameraTrackingParametersPtr cameraTrackingParametersPtr );
+
     private:
 
         DISALLOW_IMPLICIT_CONSTRUCTORS( Camera );
@@ -97,6 +109,14 @@ namespace MultipleCameraTracking
         // create temporary frame image for displaying, tracking, initialization integral image etc. when necessary
         void    PrepareCurrentFrameForTracking( int frameInd );
 
+        //regions of the current frame read by the trackers (false: the whole frame is needed)
+        bool    ComputeRegionsOfInterest( vector<IppiRect>& regionOfInterestList );
+
+        //input file locations
+        static string    GetDataDirectory( CameraTrackingParametersPtr cameraTrackingParametersPtr );
+        static string    GetInputPath( const string& dataDir, const int cameraId, const bool readImages, const bool rawFrameFile );
+        static string    GetLiveInputPath( const string& dataDir, const int cameraId, const LiveInputFormat liveInputFormat, const bool isColor );
+
         //camera property
         CvMat*                        m_pHomographyMatrix;        //Stores the Homography
         int                            m_cameraID;                    //Camera ID
@@ -105,17 +125,21 @@ namespace MultipleCameraTracking
         
 
         //input data parameters
-        vector<Matrixu>                m_videoMatrix;                //Input video Sequence for tracking
+        FrameSourcePtr                m_frameSourcePtr;            //Input video Sequence for tracking
         bool                        m_sourceIsColorImage;        //read input video as color 
         bool                        m_readImages;                //read images or video stream
         Matrixf                        m_frameMatrix;                //Stores starting and ending frame numbers
         Matrixf                        m_initialState;                //Initial states for all objects
+        float                        m_processingScale;            //tracking resolution relative to the native frames
+        int                            m_processingWidth;            //frame size at the processing scale
+        int                            m_processingHeight;
+        Matrixu                        m_scaledFrame;                //current frame downsampled to the processing scale
     
         Matrixu*                    m_pCurrentFrameImageMatrixGray;    //a pointer to the currently tracked frame (Gray image)
         Matrixu*                    m_pCurrentFrameImageMatrixHSV;    //a pointer to the currently tracked frame (HSV image)
         Matrixu*                    m_pCurrentFrameImageMatrixColor;//a pointer to the currently tracked frame (Color image)
-        Matrixu                        m_grayScaleImageMatrix;            //a temporary black and white image for Haar feature calculation if raw video is color
-        Matrixu                        m_HSVImageMatrix;                //a temporal HSV image matrix for HSV related feature calculation if hsv is needed.
+        BufferPoolPtr                m_bufferPoolPtr;                //recycled image planes and integral buffers of this camera
+        FrameImageCachePtr            m_frameImageCachePtr;            //gray/HSV/color bin images derived from the current frame, shared with the objects
 
         //tracking parameters                
         //the following parameters "typically" passed from the owner CameraNetwork class
@@ -125,13 +149,14 @@ namespace MultipleCameraTracking
         const char*                    m_outputDirectoryCstr;  //Directory for output result
         bool                        m_displayTrackedVideo;    // display video with tracker state (colored box)
         bool                        m_saveTrackedVideo;        // save video with tracking box
-        CvVideoWriter*                m_pVideoWriter;            // if m_saveTrackedVideo == true
+        VideoEncoderPtr                m_videoEncoderPtr;        //encodes the output videos off the tracking thread
+        int                            m_trackedVideoId;        // if m_saveTrackedVideo == true
         Matrixu                        m_frameDisplay;            //for displaying and saving tracked frame
         Matrixu*                    m_pFrameDisplay;
 
         bool                        m_displayTrainingSamples;    // display video with training examples
         bool                        m_saveVideoTrainingExamples;//save the training examples    
-        CvVideoWriter*                m_pVideoWriterTraining;        //for saving training example on frame
+        int                            m_trainingVideoId;            //for saving training example on frame
         Matrixu                        m_frameDisplayTraining;        //for displaying and saving training examples on frame        
         Matrixu*                    m_pFrameDisplayTraining;
 
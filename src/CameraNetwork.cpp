@@ -13,15 +13,23 @@ namespace MultipleCameraTracking
     **********************************************************************/
     CameraNetwork::CameraNetwork(    const vectori    cameraIdList, 
                                     const vectori    objectIdList,                        
+                                    const vectorf    processingScaleList,
                                     CameraTrackingParametersPtr    cameraTrackingParametersPtr )
         : m_numberOfCameras( cameraIdList.size() ),
         m_numberOfObjects( objectIdList.size() ),
         m_cameraIdList( cameraIdList ),
         m_objectIdList( objectIdList ),
-        m_videoWriterListKFDistribution( m_numberOfObjects, NULL ), 
-        m_videoWriterListGroundParticlesAfterFusion ( m_numberOfObjects, NULL ), 
-        m_videoWriterListGroundParticles( m_numberOfObjects, NULL ),
-        m_cameraTrackingParametersPtr ( ASSERT_PRECONDITION_PARAMETER( cameraTrackingParametersPtr != NULL, cameraTrackingParametersPtr ) )
+        m_processingScaleList( ASSERT_PRECONDITION_PARAMETER( processingScaleList.size() == cameraIdList.size(), processingScaleList ) ),
+        m_cameraTrackingParametersPtr ( ASSERT_PRECONDITION_PARAMETER( cameraTrackingParametersPtr != NULL, cameraTrackingParametersPtr ) ),
+        m_videoEncoderPtr( new VideoEncoder( g_configInput.m_videoEncodingThreads,
+                                             g_configInput.m_videoEncodingQueueSize,
+                                             g_configInput.m_dropFramesWhenEncoderIsBehind == 1 ) ),
+        m_videoIdListKFDistribution( m_numberOfObjects, -1 ), 
+        m_videoIdListGroundParticlesAfterFusion ( m_numberOfObjects, -1 ),
+        m_isLive( g_configInput.m_frameSourceType == LIVE_FRAME_SOURCE ),
+        m_numberOfLiveFrames( 0 ),
+        m_liveLatencySum( 0 ),
+        m_liveLatencyMax( 0 )
     {
         try
         {
@@ -53,32 +61,11 @@ namespace MultipleCameraTracking
                     cvReleaseMat( &(m_groundPlaneParticlesPtrList[objectInd]) );
                 }
 
-                //release the video writers
-                if ( m_cameraTrackingParametersPtr->m_saveGroundParticlesImage )
-                {
-                    for ( int objectInd = 0; objectInd < m_numberOfObjects; objectInd++ )
-                    {
-                        if ( m_videoWriterListGroundParticles[objectInd] != NULL)    
-                        {
-                            cvReleaseVideoWriter( &(m_videoWriterListGroundParticles[objectInd]) );
-                        }
-                        if ( m_videoWriterListGroundParticlesAfterFusion[objectInd] != NULL )
-                        {
-                            cvReleaseVideoWriter( &(m_videoWriterListGroundParticlesAfterFusion[objectInd]) );
-                        }
-                    }
-                }
-
-                //release video writer
-                if ( m_cameraTrackingParametersPtr->m_saveGroundPlaneKFImage )
+                //finish encoding and close the videos
+                for ( int objectInd = 0; objectInd < m_numberOfObjects; objectInd++ )
                 {
-                    for ( int objectInd = 0; objectInd < m_numberOfObjects; objectInd++ )
-                    {
-                        if( m_videoWriterListKFDistribution[objectInd] != NULL )
-                        {
-                            cvReleaseVideoWriter( &(m_videoWriterListKFDistribution[objectInd]) );
-                        }
-                    }
+                    m_videoEncoderPtr->CloseVideo( m_videoIdListGroundParticlesAfterFusion[objectInd] );
+                    m_videoEncoderPtr->CloseVideo( m_videoIdListKFDistribution[objectInd] );
                 }
             }
         }
@@ -151,12 +138,11 @@ namespace MultipleCameraTracking
                     if( m_cameraTrackingParametersPtr->m_displayGroundParticlesImage )
                     {
                         pMatrixGroundParticles->display( ("Ground Particles After feedback for Object"+int2str( m_objectIdList[objectInd], 3 )).c_str(), 1 );
-                        cvWaitKey(1);
                     }
 
                     if( m_cameraTrackingParametersPtr->m_saveGroundParticlesImage )
                     {
-                        Matrixu::WriteFrame( m_videoWriterListGroundParticlesAfterFusion[objectInd], *pMatrixGroundParticles );
+                        m_videoEncoderPtr->WriteFrame( m_videoIdListGroundParticlesAfterFusion[objectInd], *pMatrixGroundParticles );
                     }
 
                 }
@@ -242,12 +228,11 @@ namespace MultipleCameraTracking
                     if( m_cameraTrackingParametersPtr->m_displayGroundPlaneKFImage )
                     {
                         pMatrixKFImage->display(("Kalman Filter for Object"+int2str( m_objectIdList[objectInd], 3 )).c_str(), 1 );
-                        cvWaitKey(1);
                     }
 
                     if( m_cameraTrackingParametersPtr->m_saveGroundPlaneKFImage )
                     {
-                        Matrixu::WriteFrame( m_videoWriterListKFDistribution[objectInd], *pMatrixKFImage );
+                        m_videoEncoderPtr->WriteFrame( m_videoIdListKFDistribution[objectInd], *pMatrixKFImage );
                     }
 
                     cvReleaseMat(&pMeanMatrix);     
@@ -260,7 +245,6 @@ namespace MultipleCameraTracking
                         DisplayGMMGroundParticles( frameIndex, m_groundPlaneParticlesPtrList[objectInd] );
 
                     pMatrixGMMImage->display(("GMM Centers for Object"+int2str( m_objectIdList[objectInd], 3 )).c_str(), 1 );
-                    cvWaitKey(1);
                 }
             }
         }
@@ -360,7 +344,9 @@ namespace MultipleCameraTracking
             {
                 CameraPtr cameraPtr( new Camera( m_cameraIdList[cameraInd], 
                                                  m_objectIdList,
-                                                 m_cameraTrackingParametersPtr ));    
+                                                 m_processingScaleList[cameraInd],
+                                                 m_cameraTrackingParametersPtr,
+                                                 m_videoEncoderPtr ));    
 
                 //push back the object into the list
                 m_cameraPtrList.push_back( cameraPtr );
@@ -467,12 +453,10 @@ namespace MultipleCameraTracking
                             "TR" + int2str(m_cameraTrackingParametersPtr->m_trialNumber,3) +
                             "_Obj" + int2str( m_objectIdList[objectInd], 3 )+ "_GP2.avi";
                         
-                        m_videoWriterListGroundParticlesAfterFusion[objectInd] = cvCreateVideoWriter( 
-                            m_videoGeoFusionGroundParticles.c_str(), 
-                            CV_FOURCC('x','v','i','d'),
-                            15, 
-                            cvSize(pMatrixGroundParticles[0].cols(), pMatrixGroundParticles[0].rows() ),
-                            3 );                
+                        m_videoIdListGroundParticlesAfterFusion[objectInd] = m_videoEncoderPtr->OpenVideo( 
+                            m_videoGeoFusionGroundParticles, 
+                            pMatrixGroundParticles[0].cols(),
+                            pMatrixGroundParticles[0].rows() );
                     }
                 }
 
@@ -486,7 +470,6 @@ namespace MultipleCameraTracking
                     if( m_cameraTrackingParametersPtr->m_displayGroundPlaneKFImage )
                     {
                         pMatrixKFImage->display(("Kalman Filter for Object"+int2str( m_objectIdList[objectInd], 3 )).c_str(), 1 );
-                        cvWaitKey(1);
                     }
 
                     if( m_cameraTrackingParametersPtr->m_saveGroundPlaneKFImage )
@@ -499,14 +482,12 @@ namespace MultipleCameraTracking
                                                 "TR" + int2str(m_cameraTrackingParametersPtr->m_trialNumber,3) +
                                                 "_Obj" + int2str( m_objectIdList[objectInd], 3 )+ "_.avi";
 
-                        m_videoWriterListKFDistribution[objectInd] = cvCreateVideoWriter( 
-                                                                    m_videoGeoFusionKF.c_str(), 
-                                                                    CV_FOURCC('x','v','i','d'),
-                                                                    15, 
-                                                                    cvSize(pMatrixKFImage[0].cols(), pMatrixKFImage[0].rows() ),
-                                                                    3 );
+                        m_videoIdListKFDistribution[objectInd] = m_videoEncoderPtr->OpenVideo( 
+                                                                    m_videoGeoFusionKF, 
+                                                                    pMatrixKFImage[0].cols(),
+                                                                    pMatrixKFImage[0].rows() );
 
-                        Matrixu::WriteFrame( m_videoWriterListKFDistribution[objectInd], *pMatrixKFImage );
+                        m_videoEncoderPtr->WriteFrame( m_videoIdListKFDistribution[objectInd], *pMatrixKFImage );
                     }
 
                     cvReleaseMat(&pMeanMatrix);     
@@ -521,7 +502,6 @@ namespace MultipleCameraTracking
                         DisplayGMMGroundParticles( 0, m_groundPlaneParticlesPtrList[objectInd] );
 
                     pMatrixGMMImage->display(("GMM Centers for Object"+int2str( m_objectIdList[objectInd], 3 )).c_str(), 1 );
-                    cvWaitKey(1);
                 }
             }
         }
@@ -612,6 +592,79 @@ namespace MultipleCameraTracking
         EXCEPTION_CATCH_AND_ABORT( "Camera Network Analysis Failed.")
     }
 
+    /**********************************************************************
+    AcquireFrames
+        Live sources only: waits for a new frame of every camera, then
+        aligns the cameras on the newest frame of the slowest one. Each
+        camera tracks its kept frame closest in time to it, the older
+        ones are dropped. The other sources have every frame ready.
+    Exceptions:
+        None
+    **********************************************************************/
+    bool CameraNetwork::AcquireFrames( const int frameIndex )
+    {
+        try
+        {
+            if ( !m_isLive )
+            {
+                return true;
+            }
+
+            long long targetTimestamp = 0;
+            for ( int cameraInd = 0; cameraInd < m_numberOfCameras; cameraInd++ )
+            {
+                long long newestTimestamp = 0;
+                if ( !m_cameraPtrList[cameraInd]->GetLiveFrameSource()->WaitForFrame( newestTimestamp ) )
+                {
+                    LOG( "Live input of camera " << m_cameraPtrList[cameraInd]->GetCameraID() << " ended at frame " << frameIndex << endl );
+                    return false;
+                }
+
+                if ( cameraInd == 0 || newestTimestamp < targetTimestamp )
+                {
+                    targetTimestamp = newestTimestamp;
+                }
+            }
+
+            for ( int cameraInd = 0; cameraInd < m_numberOfCameras; cameraInd++ )
+            {
+                m_cameraPtrList[cameraInd]->GetLiveFrameSource()->SelectFrame( frameIndex, targetTimestamp );
+            }
+
+            return true;
+        }
+        EXCEPTION_CATCH_AND_ABORT( "Failed to acquire the live frames" );
+    }
+
+    /**********************************************************************
+    ReportLiveLatency
+        Live sources only: logs the time from the ingestion of the
+        oldest frame tracked to now, when its results are ready.
+    Exceptions:
+        None
+    **********************************************************************/
+    void CameraNetwork::ReportLiveLatency( const int frameIndex )
+    {
+        if ( !m_isLive )
+        {
+            return;
+        }
+
+        const long long now = LiveFrameSource::GetWallClockTime( );
+
+        long long latency = 0;
+        for ( int cameraInd = 0; cameraInd < m_numberOfCameras; cameraInd++ )
+        {
+            latency = max( latency, now - m_cameraPtrList[cameraInd]->GetLiveFrameSource()->GetFrameIngestTime() );
+        }
+
+        m_numberOfLiveFrames++;
+        m_liveLatencySum += (double)latency;
+        m_liveLatencyMax = max( m_liveLatencyMax, latency );
+
+        LOG( "Live latency of frame " << frameIndex << ": " << latency / 1000.0 << " ms" << endl );
+    }
+
     /**********************************************************************
     SaveCameraNetworkState
         Save Camera Network State.
@@ -630,5 +683,20 @@ namespace MultipleCameraTracking
             }
             EXCEPTION_CATCH_AND_ABORT( "failed to save the states" );
         }
+
+        if ( m_isLive )
+        {
+            if ( m_numberOfLiveFrames > 0 )
+            {
+                LOG( "Live latency over " << m_numberOfLiveFrames << " frames: mean " << m_liveLatencySum / m_numberOfLiveFrames / 1000.0
+                     << " ms, max " << m_liveLatencyMax / 1000.0 << " ms" << endl );
+            }
+
+            for ( int cameraInd = 0; cameraInd < m_numberOfCameras; cameraInd++ )
+            {
+                LOG( "Live frames dropped by camera " << m_cameraPtrList[cameraInd]->GetCameraID() << ": "
+                     << m_cameraPtrList[cameraInd]->GetLiveFrameSource()->GetNumberOfDroppedFrames() << endl );
+            }
+        }
     }
 }
\ No newline at end of file
@@ -4,6 +4,7 @@
 #include "CameraNetworkBase.h"
 #include "Camera.h"
 #include "GeometryBasedInformationFuser.h"
+#include "VideoEncoder.h"
 #include <boost/shared_ptr.hpp>
 
 using namespace boost;
@@ -23,6 +24,7 @@ namespace MultipleCameraTracking
         //Constructor
         CameraNetwork(    const vectori                    cameraIdList, 
                         const vectori                    objectIdList,                        
+                        const vectorf                    processingScaleList,
                         CameraTrackingParametersPtr        cameraTrackingParametersPtr );
 
         //Destructor
@@ -38,6 +40,12 @@ namespace MultipleCameraTracking
 
         //Save Camera Network state in a file(if enabled)
         virtual void SaveCameraNetworkState( );
+
+        //Select the live frames of all cameras to track as the given frame; false once a live stream ended
+        bool AcquireFrames( const int frameInd );
+
+        //Log the latency from the ingestion of the live frames to the end of their tracking
+        void ReportLiveLatency( const int frameInd );
     
     private :
 
@@ -55,13 +63,18 @@ namespace MultipleCameraTracking
         const int                                        m_numberOfObjects;
         const vectori                                    m_cameraIdList;
         const vectori                                    m_objectIdList;
+        const vectorf                                    m_processingScaleList;                        //processing scale of each camera
         CameraPtrList                                    m_cameraPtrList;
         CameraTrackingParametersPtr                        m_cameraTrackingParametersPtr;        
         vector<CvMat*>                                    m_groundPlaneParticlesPtrList;                            
         GeometryBasedInformationFuserPtrList            m_geometricInformationFuserPtrList;
-        vector<CvVideoWriter*>                            m_videoWriterListGroundParticles;            
-        vector<CvVideoWriter*>                            m_videoWriterListKFDistribution;            
-        vector<CvVideoWriter*>                            m_videoWriterListGroundParticlesAfterFusion;
+        VideoEncoderPtr                                    m_videoEncoderPtr;                            //encodes all the output videos of the network
+        vectori                                            m_videoIdListKFDistribution;            
+        vectori                                            m_videoIdListGroundParticlesAfterFusion;
+        bool                                            m_isLive;                                    //the cameras read live frame sources
+        int                                                m_numberOfLiveFrames;                        //live frames tracked so far
+        double                                            m_liveLatencySum;                            //in microseconds
+        long long                                        m_liveLatencyMax;
     };
 
     //typedef for CameraNetwork pointer
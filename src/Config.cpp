@@ -21,8 +21,18 @@ namespace MultipleCameraTracking
         {"Input_Data_FilesName",                        &g_configInput.m_dataFilesNameCstr,                             1,      0.0,        0,      0,      0},
         {"Camera_Set",                                  &g_configInput.m_cameraSetCstr,                                 1,      0.0,        0,      0,      0},
         {"Object_Set",                                  &g_configInput.m_objectSetCstr,                                 1,      0.0,        0,      0,      0},        
+        {"Processing_Scale_Set",                        &g_configInput.m_processingScaleSetCstr,                        1,      0.0,        0,      0,      0},
         {"Load_Video_With_Color",                       &g_configInput.m_loadVideoWithColor,                            0,      0,          1,      0,      1},
         {"Load_Video_From_Images",                      &g_configInput.m_loadVideoFromImgs,                             0,      1,          1,      0,      1},        
+        {"Frame_Source_Type",                           &g_configInput.m_frameSourceType,                               0,      0,          1,      0,      4},
+        {"Frame_Ring_Size",                             &g_configInput.m_frameRingSize,                                 0,      4,          2,      1,      0},
+        {"Frame_Read_Ahead_Size",                       &g_configInput.m_frameReadAheadSize,                            0,      8,          2,      1,      0},
+        {"Live_Input_Format",                           &g_configInput.m_liveInputFormat,                               0,      0,          1,      0,      1},
+        {"Live_Frame_Width",                            &g_configInput.m_liveFrameWidth,                                0,      640,        2,      1,      0},
+        {"Live_Frame_Height",                           &g_configInput.m_liveFrameHeight,                               0,      480,        2,      1,      0},
+        {"Live_Alignment_Window",                       &g_configInput.m_liveAlignmentWindow,                           0,      2,          2,      1,      0},
+        {"Convert_Input_To_Raw_Frames",                 &g_configInput.m_convertInputToRawFrames,                       0,      0,          1,      0,      1},
+        {"Restrict_Frame_Preparation_To_ROI",           &g_configInput.m_restrictFramePreparationToROI,                 0,      0,          1,      0,      1},
         {"Number_of_Frames",                            &g_configInput.m_numOfFrames,                                   0,      1,          2,      1,      0},
         {"Starting_Frame_Index",                        &g_configInput.m_startFrameIndex,                               0,      1,          2,      1,      0},
         {"Enable_Interative_Mode",                      &g_configInput.m_interactiveModeEnabled,                        0,      0,          1,      0,      1},
@@ -36,6 +46,11 @@ namespace MultipleCameraTracking
         {"Whether_Display_Training_Samples",            &g_configInput.m_displayTrainingSamples,                        0,      0,          1,      0,      1},  
         {"Display_Training_Center_Only",                &g_configInput.m_displayTrainingExampCenterOnly,                0,      0,          1,      0,      1},  
         {"Whether_Save_Training_Samples",               &g_configInput.m_saveTrainingSamplesVideo,                      0,      0,          1,      0,      1},  
+        {"Video_Encoding_Threads",                      &g_configInput.m_videoEncodingThreads,                          0,      1,          2,      0,      0},
+        {"Video_Encoding_Queue_Size",                   &g_configInput.m_videoEncodingQueueSize,                        0,      8,          2,      1,      0},
+        {"Drop_Frames_When_Encoder_Is_Behind",          &g_configInput.m_dropFramesWhenEncoderIsBehind,                 0,      0,          1,      0,      1},
+        {"Trajectory_Sync_Interval",                    &g_configInput.m_trajectorySyncInterval,                        0,      25,         2,      0,      0},
+        {"Save_Text_Trajectories",                      &g_configInput.m_saveTextTrajectories,                          0,      1,          1,      0,      1},
         {"Whether_Display_Output_Video",                &g_configInput.m_displayOutputVideo,                            0,      0,          1,      0,      1},  
         {"Wait_Before_TrackingEnd",                     &g_configInput.m_waitBeforeFinishTracking,                      0,      0,          1,      0,      1},        
         {"Whether_Calculate_Tracking_Error",            &g_configInput.m_calculateTrackingError,                        0,      0,          1,      0,      1},  
@@ -45,6 +60,8 @@ namespace MultipleCameraTracking
         {"Use_HSV_Color",                               &g_configInput.m_useHSVColor,                                   0,      0,          1,      0,      1.0},
         {"Color_Number_Of_Bins",                        &g_configInput.m_numofBinsColor,                                0,      8,          1,      4,      16.0},
         {"Tracker_Feature_Parameter",                   &g_configInput.m_trackerFeatureParameter,                       0,      0,          0,      0,      0},  
+        {"Haar_Scale_Quantization_Step",                &g_configInput.m_haarScaleQuantizationStep,                     2,      0.02,       1,      0,      0.5},
+        {"Cache_Feature_Values",                        &g_configInput.m_cacheFeatureValues,                            0,      1,          1,      0,      1},
         {"Tracker_Strong_Classifier_Type",              &g_configInput.m_trackerStrongClassifierType,                   0,      1,          2,      1,      4.0},
         {"Tracker_Weak_Classifier_Type",                &g_configInput.m_trackerWeakClassifierType,                     0,      1,          1,      1,      3.0},
         {"Percentage_Of_Weak_Classifiers_Selected",     &g_configInput.m_percentageOfWeakClassifiersSelected,           0,      20,         1,      1,      100},
@@ -58,6 +75,7 @@ namespace MultipleCameraTracking
         {"Number_Of_Negative_Examples",                 &g_configInput.m_numNegExamples,                                0,       65,        2,      10,     0},  
         {"Search_Window_Size",                          &g_configInput.m_searchWindowSize,                              0,       25,        2,      1,      0},  
         {"Negative_Sampling_Strategy",                  &g_configInput.m_negSampleStrategy,                             0,       0,         1,      0,      1},  
+        {"Dense_Haar_Search",                           &g_configInput.m_denseHaarSearch,                               0,       1,         1,      0,      1},  
     
         // Particle filter tracker parameters
         {"Num_Of_Particles",                            &g_configInput.m_numOfParticles,                                0,        50,       2,      1,      0}, 
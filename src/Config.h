@@ -31,6 +31,7 @@ namespace MultipleCameraTracking
         int        m_startFrameIndex;                        // Starting frame index
         char    m_cameraSetCstr[STRING_SIZE];            // The set of Cameras, e.g., "1,3,4"
         char    m_objectSetCstr[STRING_SIZE];            // The set of object (ID) being tracked, e.g. "1,2"
+        char    m_processingScaleSetCstr[STRING_SIZE];    // Tracking resolution of each camera relative to its frames, e.g. "0.5,1"
         char    m_inputDirectoryNameCstr[STRING_SIZE];    // Root directory address;
         char    m_dataFilesNameCstr[STRING_SIZE];        // Directory name to hold data files
         char    m_intializationDirectoryCstr[STRING_SIZE];// The local directory (inside the experiment directory)
@@ -38,6 +39,17 @@ namespace MultipleCameraTracking
         int        m_loadVideoWithColor;    //  [0-default]: Load image as gray scale image; [1]: load as RGB color image
         bool    m_interactiveModeEnabled;//  [0-default]: pause after each frame.
         int        m_loadVideoFromImgs;    //    [0]: Load video as image sequences; [1-default]: load from a video file
+        int        m_frameSourceType;        //    [0-default]: Preload the whole video; [1]: Stream frames through a bounded ring;
+                                        //    [2]: Decode ahead on a background thread; [3]: Memory map a raw frame file;
+                                        //    [4]: Read live frames from a FIFO, dropping frames to bound the latency
+        int        m_frameRingSize;        //    Number of decoded frames held by the streaming frame source
+        int        m_frameReadAheadSize;    //    Number of frames decoded ahead by the prefetching frame source
+        int        m_liveInputFormat;        //    [0-default]: YUV4MPEG2 live stream; [1]: headerless RGB24 (or gray) frames
+        int        m_liveFrameWidth;        //    Frame width of the raw live stream
+        int        m_liveFrameHeight;        //    Frame height of the raw live stream
+        int        m_liveAlignmentWindow;    //    Number of newest live frames kept per camera for timestamp alignment
+        int        m_convertInputToRawFrames;//    [0-default]: Track; [1]: Convert the input to raw frame files for Frame_Source_Type = 3 and exit
+        int        m_restrictFramePreparationToROI;//    [0-default]: Prepare whole frames; [1]: Convert/integrate only the regions read by the trackers
         
     /*********** Output Information**************/        
         char    m_outputDirectoryNameCstr[STRING_SIZE];
@@ -47,6 +59,11 @@ namespace MultipleCameraTracking
         int        m_displayOutputVideo;            // [0-default]: No; [1]: Yes; Display output video (with tracked blobs)
         int        m_displayTrainingSamples;        // [0-default]: No; [1]: Yes
         int        m_saveTrainingSamplesVideo;        // [0-default]: No; [1]: Yes
+        int        m_videoEncodingThreads;            // Number of threads encoding the output videos; [0]: encode on the tracking thread
+        int        m_videoEncodingQueueSize;        // Number of frames queued per encoding thread
+        int        m_dropFramesWhenEncoderIsBehind;// [0-default]: Wait for the encoder; [1]: Drop the frame when the queue is full
+        int        m_trajectorySyncInterval;        // Number of frames between two syncs of the binary trajectory files to the disk; [0]: at the end only
+        int        m_saveTextTrajectories;            // [1-default]: Also convert the binary trajectory files to text at the end; [0]: No
         int        m_displayTrainingExampCenterOnly;//[0-default]: No; [1]: Yes; Display only the center of the training Samples        
         int        m_waitBeforeFinishTracking;        // [1]: Hold the process before exit at the end of tracking; [0-default]:No.
         int        m_calculateTrackingError;        // [1]: Calculate the tracking error from groundTruth; [0-default]:No.
@@ -57,6 +74,8 @@ namespace MultipleCameraTracking
         int        m_useHSVColor;                    // use HSV color instead of RGB for MultiDimensional color
         int        m_numofBinsColor;                // number of bins for each dimension of the color histogram
         int        m_trackerFeatureParameter;        // Number of Haar features if Tracker_Feature_Type = 1; Otherwise: ignored
+        double    m_haarScaleQuantizationStep;    // Haar features: relative step of the scale buckets the sample scales are rounded down to (0: exact)
+        int        m_cacheFeatureValues;            // [1]: reuse the feature values of samples of the same frame covering the same pixels; [0]: No
         int        m_trackerStrongClassifierType;    // [1-default]: MilBoost; [2]: AdaBoost; [3]: MilEnsemble; [4]: MilBoost with AnyBoost;
         int        m_trackerWeakClassifierType;    // For MilBoost/AdaBoost, [1-default]: STUMP; [2]: Weighted STUMP; [3]: Perceptron
                                                 // For MilEnsemble, this parameter is ignored, as only Perceptron is allowed
@@ -77,6 +96,7 @@ namespace MultipleCameraTracking
         int        m_searchWindowSize; // Applicable to simple tracker only
                                     // Also used by particle filter during initialization
         int        m_negSampleStrategy;// [0]: all over image; [1 - default] close to the search window        
+        int        m_denseHaarSearch;  // Simple tracker with Haar features: [1]: evaluate the search window as dense feature response maps; [0]: one sample per location
 
     /***********  Particle filter tracker parameters **************/        
         int        m_numOfParticles;            // Number of particles
@@ -23,10 +23,23 @@ namespace Features
         None.    
     ****************************************************************/
     void CultureColorHistogram::Compute( const Classifier::Sample& sample, vectorf& featureValueList ) const
+    {
+        ComputeHistogram( sample, featureValueList );
+    }
+
+    /****************************************************************
+    CultureColorHistogram::ComputeHistogram
+        Compute the histogram of every part of the sample
+    Exception:
+        None.    
+    ****************************************************************/
+    void CultureColorHistogram::ComputeHistogram( const Classifier::Sample& sample, vectorf& featureValueList ) const
     {        
         uint scaled_height = cvRound( static_cast<float>(sample.m_height) * sample.m_scaleY );
         uint scaled_width =cvRound( static_cast<float>(sample.m_width) * sample.m_scaleX );
 
+        //the HSV image comes from the frame image cache when the sample has one, so the
+        //conversion below only runs for samples that carry neither
         if( sample.GetHSVImage() == NULL )
         {
             cv::Mat sampleImgHSV;
@@ -22,6 +22,9 @@ namespace Features
                                     { abortError( __LINE__, __FILE__, "CultureCoor is of more than one dimension" );; return 0.0f; }
         
         virtual void            Compute( const Classifier::Sample& sample, vectorf& featureValueList ) const;
+
+        //the same, called directly by the feature vector (no virtual dispatch)
+        void                    ComputeHistogram( const Classifier::Sample& sample, vectorf& featureValueList ) const;
         
         virtual void            Generate( FeatureParametersPtr featureParametersPtr ); 
 
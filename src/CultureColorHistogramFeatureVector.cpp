@@ -1,5 +1,4 @@
 #include "CultureColorHistogramFeatureVector.h"
-#include "CultureColorHistogram.h"
 
 namespace Features
 {
@@ -20,13 +19,9 @@ namespace Features
 
             m_featureParametersPtr = featureParametersPtr;
 
-            m_featurePtr = boost::shared_ptr<CultureColorHistogram>( new CultureColorHistogram() );
-
-            ASSERT_TRUE( m_featurePtr != NULL );
-
             m_numberOfCultureColorFeatures = m_featureParametersPtr->GetColorFeatureDimension( );
 
-            m_featurePtr->Generate( m_featureParametersPtr );
+            m_cultureColorHistogram.Generate( m_featureParametersPtr );
 
             //Update the feature generated flag
             m_isFeatureGenerated = true;
@@ -37,15 +32,15 @@ namespace Features
     }
 
         /****************************************************************
-    CultureColorHistogramFeatureVector::Compute
+    CultureColorHistogramFeatureVector::ComputeFeatures
         Iterate over each sample in the given Classifier::SampleSet
-        and compute the featurePtr. Store the computed featurePtr value 
-        in the featurePtr vector.
+        and compute its histogram into a buffer of the thread. Store
+        the computed histogram in the feature matrix.
         Classifier calls this method with a set of samples for each type.
     Exception:
         None
     ****************************************************************/
-    void    CultureColorHistogramFeatureVector::Compute( Classifier::SampleSet& sampleSet, bool shouldResizeFeatureMatrix )
+    void    CultureColorHistogramFeatureVector::ComputeFeatures( Classifier::SampleSet& sampleSet, bool shouldResizeFeatureMatrix, const vectori* pFeatureIndices )
     {
         size_t numberOfSamples    = sampleSet.Size( );
 
@@ -58,25 +53,42 @@ namespace Features
             return;
         }
 
+        //a dense grid has no sample per location to take the histogram of
+        ASSERT_TRUE( !sampleSet.IsDenseGrid() );
+
         if ( shouldResizeFeatureMatrix )
         {
             //resize the feature matrix size to the number of features
             sampleSet.ResizeFeatures( m_numberOfCultureColorFeatures );
         }
 
-        #pragma omp parallel for
-        for ( int sampleIndex = 0; sampleIndex < numberOfSamples; sampleIndex++ )
+        //the whole histogram is computed at once, if any of its bins is needed
+        if ( !IsAnyFeatureToCompute( sampleSet, m_startingIndexForFeatureMatrix, m_numberOfCultureColorFeatures, pFeatureIndices ) )
         {
+            return;
+        }
+
+        #pragma omp parallel
+        {
+            //one histogram buffer per thread
             vectorf histVector( m_numberOfCultureColorFeatures, 0.0f );
-            m_featurePtr->Compute( sampleSet[sampleIndex], histVector );
 
-            ASSERT_TRUE( histVector.size( ) == m_numberOfCultureColorFeatures );
-            
-            for ( uint featureIndex = m_startingIndexForFeatureMatrix; featureIndex < (m_startingIndexForFeatureMatrix+m_numberOfCultureColorFeatures); featureIndex++ )
+            #pragma omp for
+            for ( int sampleIndex = 0; sampleIndex < (int)numberOfSamples; sampleIndex++ )
             {
-                //store the feature value in the feature matrix
-                sampleSet.GetFeatureValue( sampleIndex, featureIndex ) = histVector[featureIndex];
+                m_cultureColorHistogram.ComputeHistogram( sampleSet[sampleIndex], histVector );
+
+                for ( uint featureIndex = m_startingIndexForFeatureMatrix; featureIndex < (m_startingIndexForFeatureMatrix+m_numberOfCultureColorFeatures); featureIndex++ )
+                {
+                    //store the feature value in the feature matrix
+                    sampleSet.GetFeatureValue( sampleIndex, featureIndex ) = histVector[featureIndex];
+                }
             }
         }
+
+        for ( uint featureIndex = m_startingIndexForFeatureMatrix; featureIndex < (m_startingIndexForFeatureMatrix+m_numberOfCultureColorFeatures); featureIndex++ )
+        {
+            sampleSet.SetFeatureComputed( featureIndex );
+        }
     }
 }
\ No newline at end of file
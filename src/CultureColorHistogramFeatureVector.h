@@ -2,25 +2,29 @@
 #define CULTURE_COLOR_FEATURE_VECTOR_H
 
 #include "FeatureVector.h"
+#include "CultureColorHistogram.h"
 
 namespace Features
 {
     /****************************************************************
     CultureColorHistogramFeatureVector
         This is a wrapper class for CultureColorHistogram.
+        The histogram feature is held by value and called directly.
     ****************************************************************/
     class CultureColorHistogramFeatureVector :virtual public FeatureVector
     {
     public:
         virtual void    Generate( FeatureParametersPtr featureParametersPtr );
-        virtual void    Compute( Classifier::SampleSet& sampleSet, bool shouldResizeFeatureMatrix = true );
         virtual void    SaveVisualizedFeatureVector( const char *dirName ){}
 
 
         virtual const uint GetNumberOfFeatures( ) const { return m_numberOfCultureColorFeatures; }
 
+    protected:
+        virtual void    ComputeFeatures( Classifier::SampleSet& sampleSet, bool shouldResizeFeatureMatrix, const vectori* pFeatureIndices );
+
     private:
-        FeaturePtr                m_featurePtr;
+        CultureColorHistogram    m_cultureColorHistogram;
         uint                    m_numberOfCultureColorFeatures;
         uint                    m_startingIndexForFeatureMatrix;
     };
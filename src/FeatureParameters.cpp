@@ -7,11 +7,12 @@ namespace Features
     HaarFeatureParameters: Haar-Like Feature Parameters
         Default Constructor
     ****************************************************************/
-    HaarFeatureParameters::HaarFeatureParameters( uint featureDimensionHaar )
+    HaarFeatureParameters::HaarFeatureParameters( uint featureDimensionHaar, float scaleQuantizationStep )
         : m_minimumNumberOfRectangles ( DEFAULT_HAAR_MINIMUM_NUMBER_OF_RECTANGLES ),
           m_maximumNumberOfRectangles ( DEFAULT_HAAR_MAXIMUM_NUMBER_OF_RECTANGLES ),
           m_numberOfChannels( DEFAULT_HAAR_NUMBER_OF_CHANNELS ),
-          m_featureDimensionHaar( featureDimensionHaar )
+          m_featureDimensionHaar( featureDimensionHaar ),
+          m_scaleQuantizationStep( scaleQuantizationStep )
     {
         for ( int channelIndex = 0; channelIndex < 1024; channelIndex++ )
         {
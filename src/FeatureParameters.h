@@ -36,6 +36,13 @@ namespace Features
     class FeatureParameters
     {
     public:
+        FeatureParameters( )
+            : m_width( 0 ),
+            m_height( 0 ),
+            m_shouldCacheFeatureValues( false )
+        {
+        }
+
         virtual FeatureType    GetFeatureType( )        const            = 0;
         virtual uint        GetFeatureDimension( )    const            = 0;
 
@@ -44,6 +51,7 @@ namespace Features
         
         uint                m_width;        // original width of the rectangular blob on which the feature is calculated
         uint                m_height;        // original height of the rectangular blob on which the feature is calculated
+        bool                m_shouldCacheFeatureValues;    // reuse the values of samples of the same frame covering the same pixels
     };
 
     /****************************************************************
@@ -53,7 +61,7 @@ namespace Features
     class HaarFeatureParameters : virtual public FeatureParameters
     {
     public:
-        HaarFeatureParameters( uint featureDimensionHaar );
+        HaarFeatureParameters( uint featureDimensionHaar, float scaleQuantizationStep = 0.0f );
 
         virtual FeatureType    GetFeatureType() const { return HAAR_LIKE; }
 
@@ -62,6 +70,9 @@ namespace Features
         virtual uint GetColorFeatureDimension( )    const    { return 0;}
         virtual uint GetHaarFeatureDimension( )        const    { return m_featureDimensionHaar; }
 
+        //relative step of the scale buckets of the compiled haar features (0: exact scales)
+        float                GetScaleQuantizationStep( ) const { return m_scaleQuantizationStep; }
+
         friend class HaarFeature;
 
     protected:        
@@ -70,6 +81,7 @@ namespace Features
         int                    m_useChannels[1024];    // >=0: used; <0:not used
         int                    m_numberOfChannels;        // number of channels used for the computation of feature
         uint                m_featureDimensionHaar;
+        float                m_scaleQuantizationStep;
     };
 
     /****************************************************************
@@ -136,8 +148,8 @@ namespace Features
                                                     public MultiDimensionalColorHistogramParameters
     {
     public:
-        HaarAndColorHistogramFeatureParameters( uint featureDimensionHaar, bool useHSVColor = false, uint numberOfBins    = 8 )
-            : HaarFeatureParameters( featureDimensionHaar ),
+        HaarAndColorHistogramFeatureParameters( uint featureDimensionHaar, bool useHSVColor = false, uint numberOfBins    = 8, float scaleQuantizationStep = 0.0f )
+            : HaarFeatureParameters( featureDimensionHaar, scaleQuantizationStep ),
             MultiDimensionalColorHistogramParameters( useHSVColor, numberOfBins )            
         {}
 
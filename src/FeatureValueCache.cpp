@@ -0,0 +1,185 @@
+#include "FeatureValueCache.h"
+
+#include <cstring>
+
+//entries are not added beyond this many samples per frame
+#define FEATURE_VALUE_CACHE_MAXIMUM_NUMBER_OF_SAMPLES    4096
+
+namespace
+{
+    /****************************************************************
+    FloatBits
+        Bit pattern of a float, so scales compare exactly.
+    Exception:
+        None
+    ****************************************************************/
+    uint FloatBits( const float value )
+    {
+        uint bits;
+        memcpy( &bits, &value, sizeof(bits) );
+        return bits;
+    }
+}
+
+namespace Features
+{
+    /****************************************************************
+    FeatureValueCache::SampleKey::SampleKey
+        C'tor
+    Exception:
+        None
+    ****************************************************************/
+    FeatureValueCache::SampleKey::SampleKey( const Classifier::Sample& sample )
+        : m_pFrameImageCache( sample.m_pFrameImageCache ),
+        m_row( sample.m_row ),
+        m_col( sample.m_col ),
+        m_width( sample.m_width ),
+        m_height( sample.m_height ),
+        m_scaleXBits( FloatBits( sample.m_scaleX ) ),
+        m_scaleYBits( FloatBits( sample.m_scaleY ) )
+    {
+    }
+
+    /****************************************************************
+    FeatureValueCache::SampleKey::operator <
+        Lexicographic order of camera, row, column, width, height,
+        scale.
+    Exception:
+        None
+    ****************************************************************/
+    bool FeatureValueCache::SampleKey::operator < ( const SampleKey& key ) const
+    {
+        if ( m_pFrameImageCache != key.m_pFrameImageCache ) return m_pFrameImageCache < key.m_pFrameImageCache;
+        if ( m_row != key.m_row ) return m_row < key.m_row;
+        if ( m_col != key.m_col ) return m_col < key.m_col;
+        if ( m_width != key.m_width ) return m_width < key.m_width;
+        if ( m_height != key.m_height ) return m_height < key.m_height;
+        if ( m_scaleXBits != key.m_scaleXBits ) return m_scaleXBits < key.m_scaleXBits;
+        return m_scaleYBits < key.m_scaleYBits;
+    }
+
+    /****************************************************************
+    FeatureValueCache::FeatureValueCache
+        C'tor
+    Exception:
+        None
+    ****************************************************************/
+    FeatureValueCache::FeatureValueCache( )
+        : m_numberOfFeatures( 0 ),
+        m_entryMap( ),
+        m_featureValues( ),
+        m_isFeatureCached( ),
+        m_frameImageCacheList( ),
+        m_frameIndexList( )
+    {
+    }
+
+    /****************************************************************
+    FeatureValueCache::SetNumberOfFeatures
+        Set the number of features of an entry; the entries are
+        dropped if it changes.
+    Exception:
+        None
+    ****************************************************************/
+    void FeatureValueCache::SetNumberOfFeatures( const uint numberOfFeatures )
+    {
+        if ( numberOfFeatures != m_numberOfFeatures )
+        {
+            Clear( );
+            m_numberOfFeatures = numberOfFeatures;
+        }
+    }
+
+    /****************************************************************
+    FeatureValueCache::Clear
+        Drop all the entries.
+    Exception:
+        None
+    ****************************************************************/
+    void FeatureValueCache::Clear( )
+    {
+        m_entryMap.clear( );
+        m_featureValues.clear( );
+        m_isFeatureCached.clear( );
+        m_frameImageCacheList.clear( );
+        m_frameIndexList.clear( );
+    }
+
+    /****************************************************************
+    FeatureValueCache::Validate
+        Check the frame of the camera the sample originates against
+        the frame the entries are for; all the entries are dropped
+        if it has advanced. Samples without a frame image cache
+        can't be cached.
+    Exception:
+        None
+    ****************************************************************/
+    bool FeatureValueCache::Validate( const Classifier::Sample& sample )
+    {
+        if ( sample.m_pFrameImageCache == NULL || m_numberOfFeatures == 0 )
+        {
+            return false;
+        }
+
+        const int frameIndex = sample.m_pFrameImageCache->GetFrameIndex( );
+
+        for ( uint k = 0; k < m_frameImageCacheList.size(); k++ )
+        {
+            if ( m_frameImageCacheList[k] == sample.m_pFrameImageCache )
+            {
+                if ( m_frameIndexList[k] != frameIndex )
+                {
+                    Clear( );
+                    break;
+                }
+                return true;
+            }
+        }
+
+        m_frameImageCacheList.push_back( sample.m_pFrameImageCache );
+        m_frameIndexList.push_back( frameIndex );
+        return true;
+    }
+
+    /****************************************************************
+    FeatureValueCache::Find
+        Entry of the sample, -1 if none.
+    Exception:
+        None
+    ****************************************************************/
+    int FeatureValueCache::Find( const Classifier::Sample& sample ) const
+    {
+        EntryMap::const_iterator it = m_entryMap.find( SampleKey( sample ) );
+        return it == m_entryMap.end() ? -1 : it->second;
+    }
+
+    /****************************************************************
+    FeatureValueCache::FindOrAdd
+        Entry of the sample, added with no feature cached if missing;
+        -1 if the cache is full.
+    Exception:
+        None
+    ****************************************************************/
+    int FeatureValueCache::FindOrAdd( const Classifier::Sample& sample )
+    {
+        const SampleKey key( sample );
+
+        EntryMap::const_iterator it = m_entryMap.find( key );
+        if ( it != m_entryMap.end() )
+        {
+            return it->second;
+        }
+
+        if ( m_entryMap.size() >= FEATURE_VALUE_CACHE_MAXIMUM_NUMBER_OF_SAMPLES )
+        {
+            return -1;
+        }
+
+        const int entry = (int)m_entryMap.size();
+        m_entryMap.insert( EntryMap::value_type( key, entry ) );
+        m_featureValues.resize( ( entry + 1 ) * m_numberOfFeatures, 0.0f );
+        m_isFeatureCached.resize( ( entry + 1 ) * m_numberOfFeatures, 0 );
+
+        return entry;
+    }
+}
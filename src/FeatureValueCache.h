@@ -0,0 +1,83 @@
+#ifndef FEATURE_VALUE_CACHE_H
+#define FEATURE_VALUE_CACHE_H
+
+#include "Sample.h"
+
+#include <map>
+
+namespace Features
+{
+    /****************************************************************
+    FeatureValueCache
+        Feature values of the samples of the current frame, keyed by
+        the camera, row, col, width, height and the exact scale of the
+        sample. Within a frame the same locations are featurized
+        several times (re-weighting of the particles, training samples
+        around the estimate, appearance fusion); a sample identical to
+        an earlier one in all of those reuses its values. The scale is
+        compared bitwise: samples of the same rounded size but another
+        scale (or scale bucket) evaluate different feature
+        rectangles. Only samples stamped with the frame image cache
+        of their camera are cached; all the entries are dropped when
+        the frame of one of those cameras advances. Each entry keeps
+        a flag per feature, as a sample may have been computed on
+        a subset of the features.
+    ****************************************************************/
+    class FeatureValueCache
+    {
+    public:
+        FeatureValueCache( );
+
+        //drop the entries if the frame of the sample's camera has advanced; false if the sample can't be cached
+        bool            Validate( const Classifier::Sample& sample );
+
+        //entry of the sample, -1 if none
+        int                Find( const Classifier::Sample& sample ) const;
+
+        //entry of the sample, added if missing; -1 if the cache is full
+        int                FindOrAdd( const Classifier::Sample& sample );
+
+        void            Clear( );
+        void            SetNumberOfFeatures( const uint numberOfFeatures );
+
+        bool            IsFeatureCached( const int entry, const int featureIndex ) const { return m_isFeatureCached[entry*m_numberOfFeatures+featureIndex] != 0; }
+        float            GetFeatureValue( const int entry, const int featureIndex ) const { return m_featureValues[entry*m_numberOfFeatures+featureIndex]; }
+        void            SetFeatureValue( const int entry, const int featureIndex, const float value )
+        {
+            m_featureValues[entry*m_numberOfFeatures+featureIndex]        = value;
+            m_isFeatureCached[entry*m_numberOfFeatures+featureIndex]    = 1;
+        }
+
+    private:
+        DISALLOW_EVIL_CONSTRUCTORS( FeatureValueCache );
+
+        /****************************************************************
+        SampleKey
+            Camera, position, size and scale (bit pattern) of a sample.
+        ****************************************************************/
+        struct SampleKey
+        {
+            SampleKey( const Classifier::Sample& sample );
+
+            bool    operator < ( const SampleKey& key ) const;
+
+            const FrameImageCache*    m_pFrameImageCache;
+            int                        m_row;
+            int                        m_col;
+            int                        m_width;
+            int                        m_height;
+            uint                    m_scaleXBits;
+            uint                    m_scaleYBits;
+        };
+
+        typedef std::map<SampleKey,int>    EntryMap;
+
+        uint                                m_numberOfFeatures;
+        EntryMap                            m_entryMap;
+        vectorf                                m_featureValues;        //m_numberOfFeatures per entry
+        vector<char>                        m_isFeatureCached;
+        vector<const FrameImageCache*>        m_frameImageCacheList;    //cameras of the entries
+        vectori                                m_frameIndexList;        //frame of each camera the entries are for
+    };
+}
+#endif
@@ -0,0 +1,146 @@
+#include "FeatureVector.h"
+
+namespace Features
+{
+    /****************************************************************
+    FeatureVector::Compute
+        Compute the listed features (all if NULL) of the samples
+        that are not computed yet. With the feature value cache on,
+        the samples of the current frame whose values are cached
+        (an earlier sample covered the same pixels) are filled from
+        the cache, the others are computed together and their
+        values are added to the cache. Dense sample grids are
+        computed directly.
+    Exception:
+        None
+    ****************************************************************/
+    void    FeatureVector::Compute( Classifier::SampleSet& sampleSet, bool shouldResizeFeatureMatrix, const vectori* pFeatureIndices )
+    {
+        try
+        {
+            const uint numberOfSamples    = (uint)sampleSet.Size( );
+            const uint numberOfFeatures    = GetNumberOfFeatures( );
+
+            if ( m_featureParametersPtr == NULL || !m_featureParametersPtr->m_shouldCacheFeatureValues || numberOfSamples == 0 || sampleSet.IsDenseGrid() )
+            {
+                ComputeFeatures( sampleSet, shouldResizeFeatureMatrix, pFeatureIndices );
+                return;
+            }
+
+            if ( shouldResizeFeatureMatrix )
+            {
+                sampleSet.ResizeFeatures( numberOfFeatures );
+            }
+
+            m_featureValueCache.SetNumberOfFeatures( numberOfFeatures );
+
+            //the requested features not computed yet
+            m_featuresToFill.clear( );
+            const uint numberOfRequestedFeatures = ( pFeatureIndices == NULL ) ? numberOfFeatures : (uint)pFeatureIndices->size();
+            for ( uint k = 0; k < numberOfRequestedFeatures; k++ )
+            {
+                const int featureIndex = ( pFeatureIndices == NULL ) ? (int)k : (*pFeatureIndices)[k];
+                if ( !sampleSet.IsFeatureComputed( featureIndex ) )
+                {
+                    m_featuresToFill.push_back( featureIndex );
+                }
+            }
+
+            if ( m_featuresToFill.empty() )
+            {
+                return;
+            }
+
+            //fill the samples whose values are all cached
+            m_uncachedSamples.clear( );
+            for ( uint sampleIndex = 0; sampleIndex < numberOfSamples; sampleIndex++ )
+            {
+                const int entry = m_featureValueCache.Validate( sampleSet[sampleIndex] ) ? m_featureValueCache.Find( sampleSet[sampleIndex] ) : -1;
+
+                bool isCached = ( entry >= 0 );
+                for ( uint k = 0; k < m_featuresToFill.size() && isCached; k++ )
+                {
+                    isCached = m_featureValueCache.IsFeatureCached( entry, m_featuresToFill[k] );
+                }
+
+                if ( !isCached )
+                {
+                    m_uncachedSamples.push_back( sampleIndex );
+                    continue;
+                }
+
+                for ( uint k = 0; k < m_featuresToFill.size(); k++ )
+                {
+                    sampleSet.GetFeatureValue( sampleIndex, m_featuresToFill[k] ) = m_featureValueCache.GetFeatureValue( entry, m_featuresToFill[k] );
+                }
+            }
+
+            //compute the others
+            if ( m_uncachedSamples.size() == numberOfSamples )
+            {
+                ComputeFeatures( sampleSet, false/*shouldResizeFeatureMatrix*/, pFeatureIndices );
+                StoreFeatureValues( sampleSet );
+            }
+            else if ( !m_uncachedSamples.empty() )
+            {
+                Classifier::SampleSet uncachedSampleSet;
+                for ( uint k = 0; k < m_uncachedSamples.size(); k++ )
+                {
+                    uncachedSampleSet.PushBackSample( sampleSet[m_uncachedSamples[k]] );
+                }
+
+                ComputeFeatures( uncachedSampleSet, true/*shouldResizeFeatureMatrix*/, pFeatureIndices );
+
+                for ( uint k = 0; k < m_uncachedSamples.size(); k++ )
+                {
+                    for ( uint j = 0; j < m_featuresToFill.size(); j++ )
+                    {
+                        sampleSet.GetFeatureValue( m_uncachedSamples[k], m_featuresToFill[j] ) = uncachedSampleSet.GetFeatureValue( k, m_featuresToFill[j] );
+                    }
+                }
+
+                StoreFeatureValues( uncachedSampleSet );
+            }
+
+            for ( uint k = 0; k < m_featuresToFill.size(); k++ )
+            {
+                sampleSet.SetFeatureComputed( m_featuresToFill[k] );
+            }
+        }
+        EXCEPTION_CATCH_AND_ABORT( "Error While Computing the Feature Vector" );
+    }
+
+    /****************************************************************
+    FeatureVector::StoreFeatureValues
+        Store the computed features of the samples of the set in the
+        cache, as long as it is not full.
+    Exception:
+        None
+    ****************************************************************/
+    void    FeatureVector::StoreFeatureValues( Classifier::SampleSet& sampleSet )
+    {
+        const uint numberOfFeatures = GetNumberOfFeatures( );
+
+        for ( uint sampleIndex = 0; sampleIndex < (uint)sampleSet.Size(); sampleIndex++ )
+        {
+            if ( !m_featureValueCache.Validate( sampleSet[sampleIndex] ) )
+            {
+                continue;
+            }
+
+            const int entry = m_featureValueCache.FindOrAdd( sampleSet[sampleIndex] );
+            if ( entry < 0 )
+            {
+                return;
+            }
+
+            for ( uint featureIndex = 0; featureIndex < numberOfFeatures; featureIndex++ )
+            {
+                if ( sampleSet.IsFeatureComputed( featureIndex ) )
+                {
+                    m_featureValueCache.SetFeatureValue( entry, featureIndex, sampleSet.GetFeatureValue( sampleIndex, featureIndex ) );
+                }
+            }
+        }
+    }
+}
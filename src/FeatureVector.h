@@ -4,6 +4,7 @@
 #include "FeatureParameters.h"
 #include "Feature.h"
 #include "SampleSet.h"
+#include "FeatureValueCache.h"
 #include "CommonMacros.h"
 
 namespace Features
@@ -30,20 +31,49 @@ namespace Features
     public:
         FeatureVector( )
             : m_featureParametersPtr( ),
-            m_isFeatureGenerated( false )
+            m_isFeatureGenerated( false ),
+            m_featureValueCache( )
         {
         }
 
         //Pure virtual functions
         virtual void        Generate( FeatureParametersPtr featureParametersPtr ) = 0;
-        virtual void        Compute( Classifier::SampleSet& sampleSet, bool shouldResizeFeatureMatrix = true ) = 0;
+
+        //compute the listed features (all if NULL) of the samples that are not computed yet, reusing the values cached for the frame
+        void                Compute( Classifier::SampleSet& sampleSet, bool shouldResizeFeatureMatrix = true, const vectori* pFeatureIndices = NULL );
         virtual void        SaveVisualizedFeatureVector( const char *dirName ) = 0;
 
         virtual const uint GetNumberOfFeatures( ) const = 0;
         
     protected:
+        //compute the listed features (all if NULL) of the samples that are not computed yet
+        virtual void        ComputeFeatures( Classifier::SampleSet& sampleSet, bool shouldResizeFeatureMatrix, const vectori* pFeatureIndices ) = 0;
+
+        //true if a feature in [firstFeature, firstFeature+numberOfFeatures) is requested (all if NULL) and not computed yet
+        static bool                IsAnyFeatureToCompute( const Classifier::SampleSet& sampleSet, const uint firstFeature, const uint numberOfFeatures, const vectori* pFeatureIndices )
+        {
+            for ( uint featureIndex = firstFeature; pFeatureIndices == NULL && featureIndex < firstFeature+numberOfFeatures; featureIndex++ )
+            {
+                if ( !sampleSet.IsFeatureComputed( featureIndex ) ) return true;
+            }
+            for ( uint k = 0; pFeatureIndices != NULL && k < pFeatureIndices->size(); k++ )
+            {
+                const uint featureIndex = (*pFeatureIndices)[k];
+                if ( featureIndex >= firstFeature && featureIndex < firstFeature+numberOfFeatures && !sampleSet.IsFeatureComputed( featureIndex ) ) return true;
+            }
+            return false;
+        }
+
         FeatureParametersPtr    m_featureParametersPtr;
         bool                    m_isFeatureGenerated;
+
+    private:
+        //store the computed features of the samples of the set in the cache
+        void                    StoreFeatureValues( Classifier::SampleSet& sampleSet );
+
+        FeatureValueCache        m_featureValueCache;    //values of the samples of the current frame
+        vectori                    m_featuresToFill;        //requested features not computed yet, of the current Compute call
+        vectori                    m_uncachedSamples;        //samples of the current Compute call missing from the cache
     };
 }
 #endif
\ No newline at end of file
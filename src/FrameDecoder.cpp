@@ -0,0 +1,98 @@
+#include "FrameDecoder.h"
+
+namespace MultipleCameraTracking
+{
+    /********************************************************************
+    FrameDecoder
+        Constructor. Opens the video stream and skips the frames
+        before the starting frame.
+    Exceptions:
+        None
+    *********************************************************************/
+    FrameDecoder::FrameDecoder( const string&    inputPath,
+                                const bool        readImages,
+                                const int        startFrameIndex,
+                                const bool        isColor )
+        : m_inputPath( inputPath ),
+        m_readImages( readImages ),
+        m_startFrameIndex( startFrameIndex ),
+        m_isColor( isColor ),
+        m_nextFrameIndex( 0 )
+    {
+        if ( !m_readImages )
+        {
+            if ( !m_videoCapture.open( m_inputPath ) )
+            {
+                abortError( __LINE__, __FILE__, "Fail to load input video video stream" );
+            }
+
+            //skip the frames before the starting frame
+            for ( int fr = 1; fr < m_startFrameIndex; fr++ )
+            {
+                m_videoCapture.grab();
+            }
+        }
+    }
+
+    /********************************************************************
+    ~FrameDecoder
+        Destructor. Releases the video stream.
+    Exceptions:
+        None
+    *********************************************************************/
+    FrameDecoder::~FrameDecoder( )
+    {
+        if ( m_videoCapture.isOpened() )
+        {
+            m_videoCapture.release();
+        }
+    }
+
+    /********************************************************************
+    DecodeFrame
+        Decode the frame at the given index into the given matrix.
+        The integral image of the previous content is invalidated, its
+        buffer is kept for the new frame.
+    Exceptions:
+        None
+    *********************************************************************/
+    void FrameDecoder::DecodeFrame( const int frameInd, Matrixu& frame )
+    {
+        ASSERT_TRUE( frameInd >= 0 );
+
+        frame.InvalidateII();
+
+        if ( m_readImages )
+        {
+            char format[1024];
+            char fname[1024];
+            sprintf_s( format, "%s/%s%%0%ii.%s", m_inputPath.c_str(), IMAGE_NAME_PREFIX, IMAGE_NAME_DIGITS, IMAGE_TYPE );
+            sprintf_s( fname, format, m_startFrameIndex + frameInd );
+            frame.LoadImage( fname, m_isColor );
+        }
+        else
+        {
+            ASSERT_TRUE( frameInd >= m_nextFrameIndex );
+
+            //skip the frames that are not required
+            while ( m_nextFrameIndex < frameInd )
+            {
+                m_videoCapture.grab();
+                m_nextFrameIndex++;
+            }
+
+            cv::Mat        capturedFrame;
+
+            if ( !m_videoCapture.grab() || !m_videoCapture.retrieve( capturedFrame ) )
+            {
+                abortError( __LINE__, __FILE__, "Fail to load input video video stream" );
+            }
+
+            //convert straight into the planes of the frame
+            frame.Resize( capturedFrame.rows, capturedFrame.cols, m_isColor ? 3 : 1 );
+            frame.CaptureMat2Matrix( capturedFrame );
+        }
+
+        m_nextFrameIndex = frameInd + 1;
+    }
+}
@@ -0,0 +1,44 @@
+#ifndef FRAME_DECODER_HEADER
+#define FRAME_DECODER_HEADER
+
+#include "FrameSource.h"
+#include "CommonMacros.h"
+
+namespace MultipleCameraTracking
+{
+    /****************************************************************
+    FrameDecoder
+        Decodes single frames of an image sequence or a video file.
+        Images can be decoded in any order; a video stream can only
+        be decoded forward, one frame after the other.
+    ****************************************************************/
+    class FrameDecoder
+    {
+    public:
+        FrameDecoder( const string&    inputPath,
+                      const bool    readImages,
+                      const int        startFrameIndex,
+                      const bool    isColor );
+
+        ~FrameDecoder( );
+
+        //decode the frame at the given index (0 is the starting frame)
+        void                DecodeFrame( const int frameInd, Matrixu& frame );
+
+        //index of the next frame a video stream can deliver
+        int                    GetNextFrameIndex( ) const { return m_nextFrameIndex; }
+
+        bool                IsRandomAccess( ) const { return m_readImages; }
+
+    private:
+        DISALLOW_IMPLICIT_CONSTRUCTORS( FrameDecoder );
+
+        string                m_inputPath;            //image directory or video file name
+        bool                m_readImages;            //read images or video stream
+        int                    m_startFrameIndex;        //index of the first frame in the input
+        bool                m_isColor;                //decode as RGB color image
+        cv::VideoCapture    m_videoCapture;            //opened video stream if !m_readImages
+        int                    m_nextFrameIndex;        //next frame of the video stream
+    };
+}
+#endif
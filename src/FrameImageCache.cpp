@@ -0,0 +1,290 @@
+#include "FrameImageCache.h"
+
+/********************************************************************
+FrameImageCache
+    Constructor.
+Exceptions:
+    None
+*********************************************************************/
+FrameImageCache::FrameImageCache( BufferPoolPtr bufferPoolPtr )
+    : m_bufferPoolPtr( bufferPoolPtr ),
+    m_pFrame( NULL ),
+    m_frameInd( -1 ),
+    m_isColor( false ),
+    m_grayImage( ),
+    m_HSVImage( ),
+    m_isGrayReady( false ),
+    m_isHSVReady( false ),
+    m_isRestrictedToRegions( false ),
+    m_regionList( ),
+    m_colorBinImageMap( )
+{
+    m_grayImage.setBufferPool( m_bufferPoolPtr );
+    m_HSVImage.setBufferPool( m_bufferPoolPtr );
+}
+
+/********************************************************************
+SetFrame
+    Start a new frame. The products of the previous frame are dropped,
+    their buffers are kept for the next frame.
+Exceptions:
+    None
+*********************************************************************/
+void FrameImageCache::SetFrame( Matrixu* pFrame, const int frameInd )
+{
+    ASSERT_TRUE( pFrame != NULL );
+    ASSERT_TRUE( pFrame->depth() == 1 || pFrame->depth() == 3 );
+
+    boost::mutex::scoped_lock lock( m_mutex );
+
+    m_pFrame        = pFrame;
+    m_frameInd        = frameInd;
+    m_isColor        = ( pFrame->depth() == 3 );
+    m_isGrayReady    = !m_isColor;    //a gray frame is its own gray image
+    m_isHSVReady    = false;
+    m_isRestrictedToRegions = false;
+    m_regionList.clear();
+
+    //the integral image of a gray frame is taken from (and given back to) the pool too
+    pFrame->setBufferPool( m_bufferPoolPtr );
+
+    //the integral buffers are kept, to be rebuilt in place for the new frame
+    m_grayImage.InvalidateII();
+    if ( !m_isColor )
+    {
+        pFrame->InvalidateII();
+    }
+
+    for ( std::map<int, ColorBinImage>::iterator iter = m_colorBinImageMap.begin(); iter != m_colorBinImageMap.end(); iter++ )
+    {
+        iter->second.m_isReady = false;
+    }
+}
+
+/********************************************************************
+Prepare
+    Compute the missing gray (with its integral image) and HSV images
+    of the current frame in a single pass. The regions restrict the
+    conversion to the parts of the frame read by the trackers; the
+    color bin images of the frame are restricted to them as well.
+Exceptions:
+    None
+*********************************************************************/
+void FrameImageCache::Prepare( const bool grayRequired, const bool HSVRequired, const vector<IppiRect>* pRegionList )
+{
+    ASSERT_TRUE( m_pFrame != NULL );
+    ASSERT_TRUE( m_isColor || !HSVRequired );
+
+    boost::mutex::scoped_lock lock( m_mutex );
+
+    if ( pRegionList != NULL )
+    {
+        m_isRestrictedToRegions    = true;
+        m_regionList            = *pRegionList;
+    }
+
+    ComputeGrayAndHSV( grayRequired, grayRequired, HSVRequired, pRegionList );
+}
+
+/********************************************************************
+GetGrayImage
+    Get the gray image of the current frame, converting a color frame
+    on first use.
+Exceptions:
+    None
+*********************************************************************/
+Matrixu* FrameImageCache::GetGrayImage( )
+{
+    ASSERT_TRUE( m_pFrame != NULL );
+
+    boost::mutex::scoped_lock lock( m_mutex );
+
+    ComputeGrayAndHSV( true, false, false, NULL );
+
+    return m_isColor ? &m_grayImage : m_pFrame;
+}
+
+/********************************************************************
+GetHSVImage
+    Get the HSV image of the current frame, converting it on first
+    use. NULL for a gray frame.
+Exceptions:
+    None
+*********************************************************************/
+Matrixu* FrameImageCache::GetHSVImage( )
+{
+    ASSERT_TRUE( m_pFrame != NULL );
+
+    if ( !m_isColor )
+    {
+        return NULL;
+    }
+
+    boost::mutex::scoped_lock lock( m_mutex );
+
+    ComputeGrayAndHSV( false, false, true, NULL );
+
+    return &m_HSVImage;
+}
+
+/********************************************************************
+GetColorBinImage
+    Get the per pixel color histogram bin index of the current frame,
+    computing it on first use. NULL for a gray frame.
+Exceptions:
+    None
+*********************************************************************/
+const int* FrameImageCache::GetColorBinImage( const int numberOfBins, const bool useHSVColorSpace )
+{
+    ASSERT_TRUE( m_pFrame != NULL );
+    ASSERT_TRUE( numberOfBins > 0 );
+
+    if ( !m_isColor )
+    {
+        return NULL;
+    }
+
+    boost::mutex::scoped_lock lock( m_mutex );
+
+    ColorBinImage& colorBinImage = m_colorBinImageMap[ 2 * numberOfBins + ( useHSVColorSpace ? 1 : 0 ) ];
+
+    if ( !colorBinImage.m_isReady )
+    {
+        ComputeColorBinImage( numberOfBins, useHSVColorSpace, colorBinImage );
+    }
+
+    return &colorBinImage.m_binIndexList[0];
+}
+
+/********************************************************************
+ReleaseIntegralImage
+    Called once the trackers of the current frame are done with the
+    integral image. A gray frame gives its buffer back to the pool,
+    for the next frame of the source; the buffer of the gray image
+    of a color frame stays for the next frame.
+Exceptions:
+    None
+*********************************************************************/
+void FrameImageCache::ReleaseIntegralImage( )
+{
+    ASSERT_TRUE( m_pFrame != NULL );
+
+    boost::mutex::scoped_lock lock( m_mutex );
+
+    if ( m_isColor )
+    {
+        m_grayImage.InvalidateII();
+    }
+    else
+    {
+        m_pFrame->FreeII();
+    }
+}
+
+/********************************************************************
+ComputeGrayAndHSV
+    Compute the requested products that are not ready yet with one
+    call to the fused conversion. Called with the lock held.
+Exceptions:
+    None
+*********************************************************************/
+void FrameImageCache::ComputeGrayAndHSV( const bool                grayRequired,
+                                         const bool                integralRequired,
+                                         const bool                HSVRequired,
+                                         const vector<IppiRect>*    pRegionList )
+{
+    Matrixu* pGray    = ( grayRequired && !m_isGrayReady ) ? &m_grayImage : NULL;
+    Matrixu* pHSV    = ( HSVRequired && !m_isHSVReady ) ? &m_HSVImage : NULL;
+
+    if ( pGray != NULL || pHSV != NULL )
+    {
+        ASSERT_TRUE( m_isColor );
+
+        m_pFrame->conv2BWHSV( pGray, pHSV, integralRequired, pRegionList );
+
+        m_isGrayReady    = m_isGrayReady || pGray != NULL;
+        m_isHSVReady    = m_isHSVReady || pHSV != NULL;
+    }
+
+    //the integral image of a gray frame (already done by the conversion of a color frame)
+    Matrixu* pGrayImage = m_isColor ? &m_grayImage : m_pFrame;
+    if ( integralRequired && !pGrayImage->isInitII() )
+    {
+        if ( pRegionList != NULL )
+        {
+            pGrayImage->initII( *pRegionList );
+        }
+        else
+        {
+            pGrayImage->initII();
+        }
+        ASSERT_TRUE( pGrayImage->isInitII() );
+    }
+}
+
+/********************************************************************
+ComputeColorBinImage
+    Quantize the pixels of the color (or HSV) image into the bin
+    index used by MultiDimensionalColorHistogram: all of them, or only
+    those inside the prepared regions, where the HSV image is valid.
+    Called with the lock held.
+Exceptions:
+    None
+*********************************************************************/
+void FrameImageCache::ComputeColorBinImage( const int numberOfBins, const bool useHSVColorSpace, ColorBinImage& colorBinImage )
+{
+    const vector<IppiRect>* pRegionList = m_isRestrictedToRegions ? &m_regionList : NULL;
+
+    ComputeGrayAndHSV( false, false, useHSVColorSpace, pRegionList );
+
+    const Matrixu&    image    = useHSVColorSpace ? m_HSVImage : *m_pFrame;
+    const int        rows    = image.rows();
+    const int        cols    = image.cols();
+
+    vector<IppiRect> regionList;
+    if ( pRegionList != NULL )
+    {
+        regionList = *pRegionList;
+    }
+    else
+    {
+        IppiRect wholeImage = { 0, 0, cols, rows };
+        regionList.push_back( wholeImage );
+    }
+
+    //same quantization as MultiDimensionalColorHistogram::Compute
+    const float    binWidth = static_cast<float>( 256 / numberOfBins );
+    int            binLookupTable[3][256];
+    for ( int value = 0; value < 256; value++ )
+    {
+        const int bin = (int)floor( value / binWidth );
+        binLookupTable[0][value] = bin;
+        binLookupTable[1][value] = numberOfBins * bin;
+        binLookupTable[2][value] = numberOfBins * numberOfBins * bin;
+    }
+
+    colorBinImage.m_binIndexList.resize( rows * cols );
+
+    //one region after the other, so overlapping regions are not written concurrently
+    for ( uint regionIndex = 0; regionIndex < regionList.size(); regionIndex++ )
+    {
+        const int firstRow    = max( 0, regionList[regionIndex].y );
+        const int endRow    = min( rows, regionList[regionIndex].y + regionList[regionIndex].height );
+        const int firstCol    = max( 0, regionList[regionIndex].x );
+        const int endCol    = min( cols, regionList[regionIndex].x + regionList[regionIndex].width );
+
+        #pragma omp parallel for
+        for ( int row = firstRow; row < endRow; row++ )
+        {
+            int* pBinIndex = &colorBinImage.m_binIndexList[row * cols];
+            for ( int col = firstCol; col < endCol; col++ )
+            {
+                pBinIndex[col] = binLookupTable[0][image( row, col, 0 )]
+                                + binLookupTable[1][image( row, col, 1 )]
+                                + binLookupTable[2][image( row, col, 2 )];
+            }
+        }
+    }
+
+    colorBinImage.m_isReady = true;
+}
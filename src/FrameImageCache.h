@@ -0,0 +1,85 @@
+#ifndef FRAME_IMAGE_CACHE_HEADER
+#define FRAME_IMAGE_CACHE_HEADER
+
+#include "Matrix.h"
+#include "Public.h"
+#include "CommonMacros.h"
+
+#include <map>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+//Forward Declaration
+class FrameImageCache;
+
+//declarations of shared ptr
+typedef boost::shared_ptr<FrameImageCache>    FrameImageCachePtr;
+
+/****************************************************************
+FrameImageCache
+    Images derived from the current frame of a camera: the gray
+    image (with its integral image), the HSV image and the
+    quantized color bin index images of the color histograms.
+    Each product is computed at most once per frame, on first
+    use, and is shared by the trackers, the fusers and the
+    features through the samples. The cache is owned by the
+    camera; objects and trackers hold a reference to it.
+    The getters may be called from several threads at once.
+    The planes of the products and of the integral images come
+    from the buffer pool of the camera. The integral buffer of the
+    gray image of a color frame persists across frames and is
+    rebuilt in place; that of a gray frame (owned by the frame
+    source) goes back to the pool when it is released.
+****************************************************************/
+class FrameImageCache
+{
+public:
+    FrameImageCache( BufferPoolPtr bufferPoolPtr );
+    ~FrameImageCache( ) { }
+
+    //start a new frame; the products of the previous frame are dropped
+    void        SetFrame( Matrixu* pFrame, const int frameInd );
+
+    //compute the missing gray (with its integral image) and HSV images in one pass, restricted to the given regions
+    void        Prepare( const bool grayRequired, const bool HSVRequired, const vector<IppiRect>* pRegionList = NULL );
+
+    //the integral image of the current frame is no longer needed
+    void        ReleaseIntegralImage( );
+
+    int            GetFrameIndex( ) const { return m_frameInd; }
+    Matrixu*    GetColorImage( ) const { return m_isColor ? m_pFrame : NULL; }
+    Matrixu*    GetGrayImage( );
+    Matrixu*    GetHSVImage( );
+
+    //per pixel bin index (r + n*g + n*n*b) of the color histogram with n bins per channel; inside the prepared regions only, if any
+    const int*    GetColorBinImage( const int numberOfBins, const bool useHSVColorSpace );
+
+private:
+    DISALLOW_EVIL_CONSTRUCTORS( FrameImageCache );
+
+    struct ColorBinImage
+    {
+        ColorBinImage( ) : m_isReady( false ) { }
+
+        bool        m_isReady;            //computed for the current frame
+        vectori        m_binIndexList;        //row-major bin index of each pixel
+    };
+
+    //compute the missing products while holding the lock
+    void        ComputeGrayAndHSV( const bool grayRequired, const bool integralRequired, const bool HSVRequired, const vector<IppiRect>* pRegionList );
+    void        ComputeColorBinImage( const int numberOfBins, const bool useHSVColorSpace, ColorBinImage& colorBinImage );
+
+    boost::mutex                m_mutex;                //guards the lazy computation of the products
+    BufferPoolPtr                m_bufferPoolPtr;        //recycled planes of the camera
+    Matrixu*                    m_pFrame;                //current frame, owned by the frame source
+    int                            m_frameInd;                //index of the current frame
+    bool                        m_isColor;                //the frame is an RGB color image
+    Matrixu                        m_grayImage;            //gray image of a color frame
+    Matrixu                        m_HSVImage;                //HSV image of a color frame
+    bool                        m_isGrayReady;
+    bool                        m_isHSVReady;
+    bool                        m_isRestrictedToRegions;    //the frame is prepared inside m_regionList only
+    vector<IppiRect>            m_regionList;            //regions of the frame read by the trackers
+    std::map<int, ColorBinImage>    m_colorBinImageMap;    //keyed by (numberOfBins, useHSVColorSpace); nodes stay put across frames
+};
+#endif
@@ -0,0 +1,67 @@
+#ifndef FRAME_SOURCE_HEADER
+#define FRAME_SOURCE_HEADER
+
+#include "Matrix.h"
+#include "Public.h"
+
+#include <boost/shared_ptr.hpp>
+
+//naming convention of the input image sequences: <dir>/img00001.png
+#define IMAGE_NAME_PREFIX    "img"
+#define IMAGE_TYPE            "png"
+#define IMAGE_NAME_DIGITS    5
+
+namespace MultipleCameraTracking
+{
+    enum FrameSourceType
+    {
+        PRELOADED_FRAME_SOURCE    = 0,    //decode the whole sequence into memory before tracking
+        STREAMING_FRAME_SOURCE    = 1,    //decode on demand into a bounded ring of frames
+        PREFETCHING_FRAME_SOURCE= 2,    //decode ahead on a background thread
+        MAPPED_FRAME_SOURCE        = 3,    //memory map a raw frame file (see RawFrameFile)
+        LIVE_FRAME_SOURCE        = 4        //read a FIFO or a pipe, keeping only the newest frames (see LiveFrameSource)
+    };
+
+    //Forward Declaration
+    class FrameSource;
+
+    //declarations of shared ptr
+    typedef boost::shared_ptr<FrameSource>    FrameSourcePtr;
+
+    /****************************************************************
+    FrameSource
+        Base class for all the frame sources of a camera.
+        A frame source hands out the input frames by their index
+        relative to the starting frame. The returned frame is owned
+        by the source and remains valid until a later frame is
+        requested.
+    ****************************************************************/
+    class FrameSource
+    {
+    public:
+        virtual ~FrameSource( ) { }
+
+        //get the frame at the given index (0 is the starting frame)
+        virtual Matrixu*    GetFrame( const int frameInd ) = 0;
+
+        int                    GetNumberOfFrames( ) const { return m_numberOfFrames; }
+        int                    GetFrameWidth( ) const { return m_frameWidth; }
+        int                    GetFrameHeight( ) const { return m_frameHeight; }
+        bool                IsColor( ) const { return m_isColor; }
+
+    protected:
+        FrameSource( const bool isColor )
+            : m_numberOfFrames( 0 ),
+            m_frameWidth( 0 ),
+            m_frameHeight( 0 ),
+            m_isColor( isColor )
+        {
+        }
+
+        int                    m_numberOfFrames;    //number of frames available from this source
+        int                    m_frameWidth;        //frame width in pixels
+        int                    m_frameHeight;        //frame height in pixels
+        bool                m_isColor;            //frames are decoded as RGB color images
+    };
+}
+#endif
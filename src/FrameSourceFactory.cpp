@@ -0,0 +1,69 @@
+#include "FrameSourceFactory.h"
+#include "PreloadedFrameSource.h"
+#include "StreamingFrameSource.h"
+#include "PrefetchingFrameSource.h"
+#include "MappedFrameSource.h"
+#include "LiveFrameSource.h"
+
+namespace MultipleCameraTracking
+{
+    /****************************************************************
+    CreateFrameSource
+        Creates a frame source according to the specified type.
+        inputPath is the raw frame file for MAPPED_FRAME_SOURCE, the
+        FIFO for LIVE_FRAME_SOURCE, otherwise the image directory if
+        readImages is set, or the video file name. The live frame size
+        is only used by raw live input, Y4M carries its own.
+    ****************************************************************/
+    FrameSourcePtr    FrameSourceFactory::CreateFrameSource(    const FrameSourceType    frameSourceType,
+                                                            const string&            inputPath,
+                                                            const bool                readImages,
+                                                            const int                startFrameIndex,
+                                                            const int                endFrameIndex,
+                                                            const bool                isColor,
+                                                            const int                ringSize,
+                                                            const int                readAheadSize,
+                                                            const int                liveInputFormat,
+                                                            const int                liveFrameWidth,
+                                                            const int                liveFrameHeight,
+                                                            const int                liveAlignmentWindowSize )
+    {
+        try
+        {
+            FrameSourcePtr frameSourcePtr;
+
+            switch ( frameSourceType )
+            {
+                case PRELOADED_FRAME_SOURCE:
+                    frameSourcePtr = FrameSourcePtr( new PreloadedFrameSource( inputPath, readImages, startFrameIndex, endFrameIndex, isColor ) );
+                    break;
+                case STREAMING_FRAME_SOURCE:
+                    frameSourcePtr = FrameSourcePtr( new StreamingFrameSource( inputPath, readImages, startFrameIndex, endFrameIndex, isColor, ringSize ) );
+                    break;
+                case PREFETCHING_FRAME_SOURCE:
+                    frameSourcePtr = FrameSourcePtr( new PrefetchingFrameSource( inputPath, readImages, startFrameIndex, endFrameIndex, isColor, readAheadSize ) );
+                    break;
+                case MAPPED_FRAME_SOURCE:
+                    frameSourcePtr = FrameSourcePtr( new MappedFrameSource( inputPath, startFrameIndex, endFrameIndex, isColor ) );
+                    break;
+                case LIVE_FRAME_SOURCE:
+                    frameSourcePtr = FrameSourcePtr( new LiveFrameSource( inputPath,
+                                                                          (LiveInputFormat)liveInputFormat,
+                                                                          liveFrameWidth,
+                                                                          liveFrameHeight,
+                                                                          startFrameIndex,
+                                                                          endFrameIndex,
+                                                                          isColor,
+                                                                          liveAlignmentWindowSize ) );
+                    break;
+                default:
+                    abortError(__LINE__,__FILE__,"Incorrect frame source type!");
+            }
+
+            ASSERT_TRUE( frameSourcePtr.get( ) != NULL );
+
+            return frameSourcePtr;
+        }
+        EXCEPTION_CATCH_AND_ABORT("Failed to create the frame source" )
+    }
+}
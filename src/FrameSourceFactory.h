@@ -0,0 +1,26 @@
+#ifndef FRAME_SOURCE_FACTORY_HEADER
+#define FRAME_SOURCE_FACTORY_HEADER
+
+#include "FrameSource.h"
+
+namespace MultipleCameraTracking
+{
+    class FrameSourceFactory
+    {
+    public:
+        //static functions
+        static FrameSourcePtr    CreateFrameSource(    const FrameSourceType    frameSourceType,
+                                                    const string&            inputPath,
+                                                    const bool                readImages,
+                                                    const int                startFrameIndex,
+                                                    const int                endFrameIndex,
+                                                    const bool                isColor,
+                                                    const int                ringSize,
+                                                    const int                readAheadSize,
+                                                    const int                liveInputFormat,
+                                                    const int                liveFrameWidth,
+                                                    const int                liveFrameHeight,
+                                                    const int                liveAlignmentWindowSize );
+    };
+}
+#endif
@@ -25,21 +25,89 @@ namespace Features
     }
 
     /****************************************************************
-    HaarAndColorHistogramFeatureVector::Compute
-
+    HaarAndColorHistogramFeatureVector::ComputeFeatures
+        Compute the haar features and the color histogram in one
+        sweep over the samples: tile by tile of nearby samples, the
+        requested haar features of the tile, then the histograms of
+        its samples while their pixels are still in the cache, with
+        one histogram buffer per thread. If only one of the two is
+        requested (or the samples are a dense grid), its own pass is
+        used.
     Exception:
         None
     ****************************************************************/
-    void    HaarAndColorHistogramFeatureVector::Compute( Classifier::SampleSet& sampleSet, bool /*shouldResizeFeatureMatrix*/ )
+    void    HaarAndColorHistogramFeatureVector::ComputeFeatures( Classifier::SampleSet& sampleSet, bool /*shouldResizeFeatureMatrix*/, const vectori* pFeatureIndices )
     {
         try
         {
             //resize the feature matrix for efficiency
             sampleSet.ResizeFeatures( m_numberOfHaarColorFeatures );
 
-            HaarFeatureVector::Compute( sampleSet, false/*shouldResizeFeatureMatrix*/ );
-            MultiDimensionalColorHistogramFeatureVector::Compute( sampleSet, false/*shouldResizeFeatureMatrix*/ );
+            if ( sampleSet.Size() == 0 )
+            {
+                return;
+            }
+
+            CollectFeaturesToCompute( sampleSet, pFeatureIndices );
+
+            const bool isColorToCompute = IsAnyFeatureToCompute( sampleSet, m_startingIndexForFeatureMatrix, m_numberOfColorFeatures, pFeatureIndices );
+
+            //a dense grid only carries the Haar response maps
+            ASSERT_TRUE( !sampleSet.IsDenseGrid() || !isColorToCompute );
+
+            if ( !isColorToCompute )
+            {
+                HaarFeatureVector::ComputeFeatures( sampleSet, false/*shouldResizeFeatureMatrix*/, pFeatureIndices );
+                return;
+            }
+
+            if ( m_featuresToCompute.empty() )
+            {
+                MultiDimensionalColorHistogramFeatureVector::ComputeFeatures( sampleSet, false/*shouldResizeFeatureMatrix*/, pFeatureIndices );
+                return;
+            }
+
+            //rectangle geometry of the sample scales, and tiles of nearby samples
+            m_haarFeatureBank.PrepareSamples( sampleSet );
+
+            const int numberOfTiles = (int)m_haarFeatureBank.GetNumberOfTiles();
+
+            #pragma omp parallel
+            {
+                //one histogram buffer per thread
+                vectorf colorHistogramVector( m_numberOfColorFeatures, 0.0f );
+
+                #pragma omp for schedule(dynamic)
+                for ( int tileIndex = 0; tileIndex < numberOfTiles; tileIndex++ )
+                {
+                    m_haarFeatureBank.ComputeTile( tileIndex, sampleSet, m_featuresToCompute );
+
+                    const uint* pTileSamples        = m_haarFeatureBank.GetTileSamples( tileIndex );
+                    const uint numberOfTileSamples    = m_haarFeatureBank.GetNumberOfTileSamples( tileIndex );
+
+                    for ( uint tileSampleIndex = 0; tileSampleIndex < numberOfTileSamples; tileSampleIndex++ )
+                    {
+                        const uint sampleIndex = pTileSamples[tileSampleIndex];
+
+                        m_colorHistogram.ComputeHistogram( sampleSet[sampleIndex], &colorHistogramVector[0] );
+
+                        for ( uint k = 0; k < m_numberOfColorFeatures; k++ )
+                        {
+                            sampleSet.GetFeatureValue( sampleIndex, m_startingIndexForFeatureMatrix + k ) = colorHistogramVector[k];
+                        }
+                    }
+                }
+            }
+
+            for ( uint k = 0; k < m_featuresToCompute.size(); k++ )
+            {
+                sampleSet.SetFeatureComputed( m_featuresToCompute[k] );
+            }
+            for ( uint k = 0; k < m_numberOfColorFeatures; k++ )
+            {
+                sampleSet.SetFeatureComputed( m_startingIndexForFeatureMatrix + k );
+            }
         }
-        EXCEPTION_CATCH_AND_ABORT( "Error While Generating MultiDimensionalColorHistogram Feature Vector" );
+        EXCEPTION_CATCH_AND_ABORT( "Error While Computing the Haar and Color Histogram Feature Vector" );
     }
 }
\ No newline at end of file
@@ -17,7 +17,6 @@ namespace Features
     public:
         
         virtual void    Generate( FeatureParametersPtr featureParametersPtr );
-        virtual void    Compute( Classifier::SampleSet& sampleSet, bool shouldResizeFeatureMatrix = true );
         virtual void    SaveVisualizedFeatureVector( const char *dirName ){}
 
         virtual const uint GetNumberOfFeatures( ) const
@@ -25,6 +24,9 @@ namespace Features
             ASSERT_TRUE( m_numberOfHaarColorFeatures !=  0 ); return m_numberOfHaarColorFeatures;
         }
 
+    protected:
+        virtual void    ComputeFeatures( Classifier::SampleSet& sampleSet, bool shouldResizeFeatureMatrix, const vectori* pFeatureIndices );
+
     private:
         uint m_numberOfHaarColorFeatures;
     };
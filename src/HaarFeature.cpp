@@ -94,7 +94,6 @@ namespace Features
         if ( featureIndex >= 0 )
         {
             v.display(  ("HaarFeature-" +  int2str(featureIndex,3)).c_str(), 2 );
-            cvWaitKey(1);            
         }
 
         v._keepIpl = false;
@@ -26,6 +26,11 @@ namespace Features
 
         float                    GetExpectedValue() const;
 
+        //geometry in the original scale, for compiling the feature into a HaarFeatureBank
+        uint                    GetChannel( ) const { return m_channel; }
+        const vector<IppiRect>&    GetRectangles( ) const { return m_rects; }
+        const vectorf&            GetWeights( ) const { return m_weights; }
+
         // Haar-like feature is of one dim
         virtual float            Compute( const Classifier::Sample& sample ) const;    
         virtual void            Compute( const Classifier::Sample& sample, vectorf& featureValueList ) const
@@ -0,0 +1,537 @@
+#include "HaarFeatureBank.h"
+#include "HaarFeature.h"
+
+#if defined(__AVX2__)
+#define HAAR_BANK_USE_AVX2
+#include <immintrin.h>
+#endif
+
+//the buckets are dropped and rebuilt on demand when there are more than this
+#define HAAR_BANK_MAXIMUM_NUMBER_OF_SCALE_BUCKETS    256
+
+//samples are evaluated in tiles of nearby samples (pixels, number of samples)
+#define HAAR_BANK_TILE_SIZE                            16
+#define HAAR_BANK_MAXIMUM_SAMPLES_PER_TILE            32
+
+namespace Features
+{
+    /****************************************************************
+    FindOrAddCorner
+        Index of the corner with the given edges among the corners
+        of the feature starting at firstCorner, appended if new.
+    Exception:
+        None
+    ****************************************************************/
+    static uint FindOrAddCorner( const int x, const int width, const int y, const int height, const uint firstCorner,
+                                 vector<int>& cornerX, vector<int>& cornerWidth, vector<int>& cornerY, vector<int>& cornerHeight )
+    {
+        for ( uint corner = firstCorner; corner < cornerX.size(); corner++ )
+        {
+            if ( cornerX[corner] == x && cornerWidth[corner] == width && cornerY[corner] == y && cornerHeight[corner] == height )
+            {
+                return corner - firstCorner;
+            }
+        }
+
+        cornerX.push_back( x );
+        cornerWidth.push_back( width );
+        cornerY.push_back( y );
+        cornerHeight.push_back( height );
+
+        return (uint)cornerX.size() - 1 - firstCorner;
+    }
+
+    /****************************************************************
+    GatherCorners
+        values[c] = pOrigin[pOffsets[c]] for the corners of a feature
+    Exception:
+        None
+    ****************************************************************/
+    static inline void GatherCorners( const IntegralType* pOrigin, const int* pOffsets, const uint numberOfCorners, IntegralType* pValues )
+    {
+        uint corner = 0;
+
+#ifdef HAAR_BANK_USE_AVX2
+#ifdef INTEGRAL_IMAGE_64BIT
+        for ( ; corner + 4 <= numberOfCorners; corner += 4 )
+        {
+            __m128i offsets = _mm_loadu_si128( (const __m128i*)(pOffsets + corner) );
+            _mm256_storeu_si256( (__m256i*)(pValues + corner), _mm256_i32gather_epi64( (const long long*)pOrigin, offsets, 8 ) );
+        }
+#else
+        for ( ; corner + 8 <= numberOfCorners; corner += 8 )
+        {
+            __m256i offsets = _mm256_loadu_si256( (const __m256i*)(pOffsets + corner) );
+            _mm256_storeu_si256( (__m256i*)(pValues + corner), _mm256_i32gather_epi32( (const int*)pOrigin, offsets, 4 ) );
+        }
+#endif
+#endif
+        for ( ; corner < numberOfCorners; corner++ )
+        {
+            pValues[corner] = pOrigin[pOffsets[corner]];
+        }
+    }
+
+    /****************************************************************
+    ComputeResponseRow
+        Responses of a feature at consecutive locations of a row:
+        the corners of the locations are consecutive in the integral
+        image, so each rectangle is four shifted row loads. The last
+        locations of the row go through the same multiply and add
+        instructions, on zero padded lanes. Computed the same way as
+        HaarFeatureBank::ComputeTile, location by location (the box
+        sums are below 2^31, so converting them as signed integers
+        gives the same floats); the results match bit for bit as long
+        as the compiler does not contract a multiply and add into a
+        fused one (-ffp-contract=off in the Makefile).
+    Exception:
+        None
+    ****************************************************************/
+    static inline void ComputeResponseRow( const IntegralType* pOrigin, const int* pOffsets, const uint* pRectangleCorners, const float* pRectangleWeights,
+                                           const uint numberOfRectangles, const float area, const int numberOfColumns, float* pResponses )
+    {
+        int col = 0;
+
+#if defined(HAAR_BANK_USE_AVX2) && !defined(INTEGRAL_IMAGE_64BIT)
+        const __m256 areas = _mm256_set1_ps( area );
+        for ( ; col + 8 <= numberOfColumns; col += 8 )
+        {
+            __m256 sums = _mm256_setzero_ps();
+            const uint* pCorners = pRectangleCorners;
+            for ( uint rectangleIndex = 0; rectangleIndex < numberOfRectangles; rectangleIndex++, pCorners += 4 )
+            {
+                const __m256i topLeft        = _mm256_loadu_si256( (const __m256i*)(pOrigin + col + pOffsets[pCorners[0]]) );
+                const __m256i topRight        = _mm256_loadu_si256( (const __m256i*)(pOrigin + col + pOffsets[pCorners[1]]) );
+                const __m256i bottomLeft    = _mm256_loadu_si256( (const __m256i*)(pOrigin + col + pOffsets[pCorners[2]]) );
+                const __m256i bottomRight    = _mm256_loadu_si256( (const __m256i*)(pOrigin + col + pOffsets[pCorners[3]]) );
+                const __m256i boxSums        = _mm256_sub_epi32( _mm256_sub_epi32( _mm256_add_epi32( bottomRight, topLeft ), topRight ), bottomLeft );
+
+                sums = _mm256_add_ps( sums, _mm256_mul_ps( _mm256_set1_ps( pRectangleWeights[rectangleIndex] ), _mm256_cvtepi32_ps( boxSums ) ) );
+            }
+            _mm256_storeu_ps( pResponses + col, _mm256_div_ps( sums, areas ) );
+        }
+
+        if ( col < numberOfColumns )
+        {
+            const int numberOfLocations = numberOfColumns - col;
+
+            __m256 sums = _mm256_setzero_ps();
+            const uint* pCorners = pRectangleCorners;
+            for ( uint rectangleIndex = 0; rectangleIndex < numberOfRectangles; rectangleIndex++, pCorners += 4 )
+            {
+                int boxSumList[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+                for ( int location = 0; location < numberOfLocations; location++ )
+                {
+                    const IntegralType* pLocation = pOrigin + col + location;
+                    boxSumList[location] = (int)( pLocation[pOffsets[pCorners[3]]] + pLocation[pOffsets[pCorners[0]]] - pLocation[pOffsets[pCorners[1]]] - pLocation[pOffsets[pCorners[2]]] );
+                }
+
+                sums = _mm256_add_ps( sums, _mm256_mul_ps( _mm256_set1_ps( pRectangleWeights[rectangleIndex] ), _mm256_cvtepi32_ps( _mm256_loadu_si256( (const __m256i*)boxSumList ) ) ) );
+            }
+
+            float responseList[8];
+            _mm256_storeu_ps( responseList, _mm256_div_ps( sums, areas ) );
+            memcpy( pResponses + col, responseList, numberOfLocations * sizeof(float) );
+            col = numberOfColumns;
+        }
+#endif
+        for ( ; col < numberOfColumns; col++ )
+        {
+            float sum = 0.0f;
+            const uint* pCorners = pRectangleCorners;
+            for ( uint rectangleIndex = 0; rectangleIndex < numberOfRectangles; rectangleIndex++, pCorners += 4 )
+            {
+                const IntegralType* pLocation    = pOrigin + col;
+                const IntegralType boxSum        = pLocation[pOffsets[pCorners[3]]] + pLocation[pOffsets[pCorners[0]]] - pLocation[pOffsets[pCorners[1]]] - pLocation[pOffsets[pCorners[2]]];
+                sum += pRectangleWeights[rectangleIndex] * (float)boxSum;
+            }
+            pResponses[col] = sum/area;
+        }
+    }
+
+    /****************************************************************
+    HaarFeatureBank::HaarFeatureBank
+        Constructor
+    Exception:
+        None
+    ****************************************************************/
+    HaarFeatureBank::HaarFeatureBank( )
+        : m_maximumNumberOfCorners( 0 ),
+        m_scaleQuantizationStep( 0.0f ),
+        m_lastScaleBucket( 0 )
+    {
+    }
+
+    /****************************************************************
+    HaarFeatureBank::Compile
+        Flatten the rectangles of the haar features into the corner
+        and rectangle tables. A rectangle's right edge is kept as
+        (x, width) rather than x+width, since the scaled rectangle
+        is round(x*scale) + round(width*scale).
+    Exception:
+        None
+    ****************************************************************/
+    void    HaarFeatureBank::Compile( const FeatureList& featureList, const float scaleQuantizationStep )
+    {
+        try
+        {
+            ASSERT_TRUE( scaleQuantizationStep >= 0.0f );
+
+            const uint numberOfFeatures = (uint)featureList.size();
+
+            m_scaleQuantizationStep = scaleQuantizationStep;
+            m_scaleBuckets.clear();
+            m_sampleScaleBuckets.clear();
+            m_lastScaleBucket = 0;
+
+            m_channel.resize( numberOfFeatures );
+            m_firstCorner.assign( 1, 0 );
+            m_firstRectangle.assign( 1, 0 );
+            m_cornerX.clear();
+            m_cornerWidth.clear();
+            m_cornerY.clear();
+            m_cornerHeight.clear();
+            m_rectangleCorners.clear();
+            m_rectangleWeights.clear();
+            m_maximumNumberOfCorners = 0;
+
+            for ( uint featureIndex = 0; featureIndex < numberOfFeatures; featureIndex++ )
+            {
+                ASSERT_TRUE( featureList[featureIndex] != NULL );
+                ASSERT_TRUE( featureList[featureIndex]->GetFeatureType() == HAAR_LIKE );
+
+                const HaarFeature& haarFeature            = static_cast<const HaarFeature&>( *featureList[featureIndex] );
+                const vector<IppiRect>& rectangles        = haarFeature.GetRectangles();
+                const vectorf& weights                    = haarFeature.GetWeights();
+                const uint firstCorner                    = (uint)m_cornerX.size();
+
+                m_channel[featureIndex] = haarFeature.GetChannel();
+
+                for ( uint rectangleIndex = 0; rectangleIndex < rectangles.size(); rectangleIndex++ )
+                {
+                    const IppiRect& r = rectangles[rectangleIndex];
+
+                    m_rectangleCorners.push_back( FindOrAddCorner( r.x, 0,       r.y, 0,        firstCorner, m_cornerX, m_cornerWidth, m_cornerY, m_cornerHeight ) );
+                    m_rectangleCorners.push_back( FindOrAddCorner( r.x, r.width, r.y, 0,        firstCorner, m_cornerX, m_cornerWidth, m_cornerY, m_cornerHeight ) );
+                    m_rectangleCorners.push_back( FindOrAddCorner( r.x, 0,       r.y, r.height, firstCorner, m_cornerX, m_cornerWidth, m_cornerY, m_cornerHeight ) );
+                    m_rectangleCorners.push_back( FindOrAddCorner( r.x, r.width, r.y, r.height, firstCorner, m_cornerX, m_cornerWidth, m_cornerY, m_cornerHeight ) );
+                    m_rectangleWeights.push_back( weights[rectangleIndex] );
+                }
+
+                m_firstCorner.push_back( (uint)m_cornerX.size() );
+                m_firstRectangle.push_back( (uint)m_rectangleWeights.size() );
+                m_maximumNumberOfCorners = max( m_maximumNumberOfCorners, (uint)m_cornerX.size() - firstCorner );
+            }
+        }
+        EXCEPTION_CATCH_AND_ABORT( "Error While Compiling Haar Feature Bank" );
+    }
+
+    /****************************************************************
+    HaarFeatureBank::ScaleCorners
+        Offsets of the given corners in the integral image, relative
+        to the top left corner of the sample; rounded the same way
+        as HaarFeature::Compute scales its rectangles.
+    Exception:
+        None
+    ****************************************************************/
+    void    HaarFeatureBank::ScaleCorners( const uint firstCorner, const uint endCorner, const float scaleX, const float scaleY, const int pixStep, int* pOffsets ) const
+    {
+        for ( uint corner = firstCorner; corner < endCorner; corner++ )
+        {
+            int x = cvRound( float(m_cornerX[corner]) * scaleX );
+            int y = cvRound( float(m_cornerY[corner]) * scaleY );
+
+            if ( m_cornerWidth[corner] != 0 )
+            {
+                x += cvRound( float(m_cornerWidth[corner]) * scaleX );
+            }
+            if ( m_cornerHeight[corner] != 0 )
+            {
+                y += cvRound( float(m_cornerHeight[corner]) * scaleY );
+            }
+
+            *pOffsets++ = y*pixStep + x;
+        }
+    }
+
+    /****************************************************************
+    HaarFeatureBank::FindOrAddScaleBucket
+        Index of the bucket of the given scale, built if new.
+    Exception:
+        None
+    ****************************************************************/
+    uint    HaarFeatureBank::FindOrAddScaleBucket( const int scaleIndexX, const int scaleIndexY, const int pixStep )
+    {
+        //consecutive samples mostly share a bucket
+        if ( m_lastScaleBucket < m_scaleBuckets.size() )
+        {
+            const ScaleBucket& lastBucket = m_scaleBuckets[m_lastScaleBucket];
+            if ( lastBucket.m_scaleIndexX == scaleIndexX && lastBucket.m_scaleIndexY == scaleIndexY && lastBucket.m_pixStep == pixStep )
+            {
+                return m_lastScaleBucket;
+            }
+        }
+
+        for ( uint bucketIndex = 0; bucketIndex < m_scaleBuckets.size(); bucketIndex++ )
+        {
+            const ScaleBucket& bucket = m_scaleBuckets[bucketIndex];
+            if ( bucket.m_scaleIndexX == scaleIndexX && bucket.m_scaleIndexY == scaleIndexY && bucket.m_pixStep == pixStep )
+            {
+                m_lastScaleBucket = bucketIndex;
+                return bucketIndex;
+            }
+        }
+
+        const float scaleX    = (float)pow( 1.0 + m_scaleQuantizationStep, scaleIndexX );
+        const float scaleY    = (float)pow( 1.0 + m_scaleQuantizationStep, scaleIndexY );
+
+        m_scaleBuckets.push_back( ScaleBucket() );
+        ScaleBucket& bucket        = m_scaleBuckets.back();
+        bucket.m_scaleIndexX    = scaleIndexX;
+        bucket.m_scaleIndexY    = scaleIndexY;
+        bucket.m_pixStep        = pixStep;
+        bucket.m_area            = scaleX*scaleY;
+        bucket.m_offsets.resize( m_cornerX.size() + 1 );
+
+        ScaleCorners( 0, (uint)m_cornerX.size(), scaleX, scaleY, pixStep, &bucket.m_offsets[0] );
+
+        m_lastScaleBucket = (uint)m_scaleBuckets.size() - 1;
+        return m_lastScaleBucket;
+    }
+
+    /****************************************************************
+    HaarFeatureBank::PrepareSamples
+        Round the scale of every sample of the set down to its bucket,
+        building the buckets not used before (with scale quantization),
+        and order the samples into tiles: samples whose top left corners
+        fall in the same HAAR_BANK_TILE_SIZE square, row by row, at most
+        HAAR_BANK_MAXIMUM_SAMPLES_PER_TILE to a tile.
+    Exception:
+        None
+    ****************************************************************/
+    void    HaarFeatureBank::PrepareSamples( Classifier::SampleSet& sampleSet )
+    {
+        const uint numberOfSamples = (uint)sampleSet.Size();
+
+        if ( m_scaleQuantizationStep > 0.0f )
+        {
+            if ( m_scaleBuckets.size() > HAAR_BANK_MAXIMUM_NUMBER_OF_SCALE_BUCKETS )
+            {
+                m_scaleBuckets.clear();
+            }
+
+            const double logScaleStep = log( 1.0 + m_scaleQuantizationStep );
+
+            m_sampleScaleBuckets.resize( numberOfSamples );
+
+            for ( uint sampleIndex = 0; sampleIndex < numberOfSamples; sampleIndex++ )
+            {
+                const Classifier::Sample& sample = sampleSet[sampleIndex];
+
+                //Integral image should be initialized
+                if ( !sample.m_pImgGray->isInitII() )
+                {
+                    abortError( __LINE__, __FILE__, "Integral image not initialized before called Compute()" );
+                }
+
+                //rounded down: the rectangles of a sample never grow past it
+                m_sampleScaleBuckets[sampleIndex] = FindOrAddScaleBucket( cvFloor( log( sample.m_scaleX ) / logScaleStep ),
+                                                                          cvFloor( log( sample.m_scaleY ) / logScaleStep ),
+                                                                          sample.m_pImgGray->iiPixStep() );
+            }
+        }
+
+        //sort the samples by tile, then by position within the tile
+        vector< pair< pair<uint,uint>, uint > > sampleOrder( numberOfSamples );
+        for ( uint sampleIndex = 0; sampleIndex < numberOfSamples; sampleIndex++ )
+        {
+            const Classifier::Sample& sample    = sampleSet[sampleIndex];
+            const uint tile                        = ( (uint)sample.m_row/HAAR_BANK_TILE_SIZE << 16 ) | ( (uint)sample.m_col/HAAR_BANK_TILE_SIZE );
+            const uint position                    = ( (uint)sample.m_row << 16 ) | (uint)sample.m_col;
+
+            sampleOrder[sampleIndex] = make_pair( make_pair( tile, position ), sampleIndex );
+        }
+        sort( sampleOrder.begin(), sampleOrder.end() );
+
+        m_tileSamples.resize( numberOfSamples );
+        m_firstTileSample.clear();
+
+        for ( uint orderIndex = 0; orderIndex < numberOfSamples; orderIndex++ )
+        {
+            const bool isNewTile = orderIndex == 0
+                                || sampleOrder[orderIndex].first.first != sampleOrder[orderIndex-1].first.first
+                                || orderIndex - m_firstTileSample.back() == HAAR_BANK_MAXIMUM_SAMPLES_PER_TILE;
+            if ( isNewTile )
+            {
+                m_firstTileSample.push_back( orderIndex );
+            }
+
+            m_tileSamples[orderIndex] = sampleOrder[orderIndex].second;
+        }
+        m_firstTileSample.push_back( numberOfSamples );
+    }
+
+    /****************************************************************
+    HaarFeatureBank::ComputeTile
+        Compute the listed features on the samples of one tile, feature by
+        feature, so the part of the integral image under the tile and
+        the tables of the feature are reused by all its samples. The
+        corner offsets come from the bucket of the sample; without
+        scale quantization they are rescaled whenever the scale (or
+        the image) of the sample differs from the previous one.
+    Exception:
+        None
+    ****************************************************************/
+    void    HaarFeatureBank::ComputeTile( const uint tileIndex, Classifier::SampleSet& sampleSet, const vectori& featureIndices ) const
+    {
+        ASSERT_TRUE( tileIndex < GetNumberOfTiles() );
+
+        const uint* pTileSamples            = &m_tileSamples[0] + m_firstTileSample[tileIndex];
+        const uint numberOfTileSamples        = m_firstTileSample[tileIndex+1] - m_firstTileSample[tileIndex];
+        const bool isQuantized                = m_scaleQuantizationStep > 0.0f;
+
+        ASSERT_TRUE( !isQuantized || m_sampleScaleBuckets.size() == sampleSet.Size() );
+
+        vector<int>                offsets( m_maximumNumberOfCorners + 1 );
+        vector<IntegralType>    values( m_maximumNumberOfCorners + 1 );
+
+        for ( uint k = 0; k < featureIndices.size(); k++ )
+        {
+            const uint featureIndex                = featureIndices[k];
+            ASSERT_TRUE( featureIndex < GetNumberOfFeatures() );
+
+            const uint channel                    = m_channel[featureIndex];
+            const uint firstCorner                = m_firstCorner[featureIndex];
+            const uint numberOfCorners            = m_firstCorner[featureIndex+1] - firstCorner;
+            const uint* pRectangleCorners        = &m_rectangleCorners[0] + 4*m_firstRectangle[featureIndex];
+            const float* pRectangleWeights        = &m_rectangleWeights[0] + m_firstRectangle[featureIndex];
+            const uint numberOfRectangles        = m_firstRectangle[featureIndex+1] - m_firstRectangle[featureIndex];
+
+            const int* pOffsets                = &offsets[0];
+            const Matrixu* pPreviousImage    = NULL;
+            float previousScaleX            = 0.0f;
+            float previousScaleY            = 0.0f;
+            float area                        = 1.0f;
+
+            for ( uint tileSampleIndex = 0; tileSampleIndex < numberOfTileSamples; tileSampleIndex++ )
+            {
+                const uint sampleIndex                = pTileSamples[tileSampleIndex];
+                const Classifier::Sample& sample    = sampleSet[sampleIndex];
+
+                if ( isQuantized )
+                {
+                    const ScaleBucket& bucket = m_scaleBuckets[m_sampleScaleBuckets[sampleIndex]];
+                    pOffsets    = &bucket.m_offsets[firstCorner];
+                    area        = bucket.m_area;
+                }
+                else if ( sample.m_pImgGray != pPreviousImage || sample.m_scaleX != previousScaleX || sample.m_scaleY != previousScaleY )
+                {
+                    //Integral image should be initialized
+                    if ( !sample.m_pImgGray->isInitII() )
+                    {
+                        abortError( __LINE__, __FILE__, "Integral image not initialized before called Compute()" );
+                    }
+
+                    ScaleCorners( firstCorner, firstCorner + numberOfCorners, sample.m_scaleX, sample.m_scaleY, sample.m_pImgGray->iiPixStep(), &offsets[0] );
+
+                    pPreviousImage    = sample.m_pImgGray;
+                    previousScaleX    = sample.m_scaleX;
+                    previousScaleY    = sample.m_scaleY;
+                    area            = sample.m_scaleX*sample.m_scaleY;
+                }
+
+                const IntegralType* pOrigin = sample.m_pImgGray->iiPlane( channel ) + sample.m_row*sample.m_pImgGray->iiPixStep() + sample.m_col;
+                GatherCorners( pOrigin, pOffsets, numberOfCorners, &values[0] );
+
+                float sum = 0.0f;
+                const uint* pCorners = pRectangleCorners;
+                for ( uint rectangleIndex = 0; rectangleIndex < numberOfRectangles; rectangleIndex++, pCorners += 4 )
+                {
+                    // exact in the integer type, even if the running sums wrapped around
+                    const IntegralType boxSum = values[pCorners[3]] + values[pCorners[0]] - values[pCorners[1]] - values[pCorners[2]];
+                    sum += pRectangleWeights[rectangleIndex] * (float)boxSum;
+                }
+
+                //the Haar feature as if the sample is of original scale (1.0)
+                sampleSet.GetFeatureValue( sampleIndex, featureIndex ) = sum/area;
+            }
+        }
+    }
+
+    /****************************************************************
+    HaarFeatureBank::ComputeResponseMaps
+        Compute the listed features at every location of a dense grid
+        sample set, into their feature columns: one response map per
+        feature, row by row of the grid, in parallel over the features.
+        All the locations share the scale of the grid, so the corner
+        offsets are computed once (or taken from its bucket).
+    Exception:
+        None
+    ****************************************************************/
+    void    HaarFeatureBank::ComputeResponseMaps( Classifier::SampleSet& sampleSet, const vectori& featureIndices )
+    {
+        ASSERT_TRUE( sampleSet.IsDenseGrid() );
+
+        const Classifier::Sample& sample    = sampleSet.GetDenseGridSample();
+        const int numberOfRows                = sampleSet.GetDenseGridRows();
+        const int numberOfColumns            = sampleSet.GetDenseGridColumns();
+
+        //Integral image should be initialized
+        if ( !sample.m_pImgGray->isInitII() )
+        {
+            abortError( __LINE__, __FILE__, "Integral image not initialized before called Compute()" );
+        }
+
+        const int pixStep = sample.m_pImgGray->iiPixStep();
+
+        //corner offsets of all the features at the scale of the grid
+        vector<int>    offsets;
+        const int*    pOffsets;
+        float        area;
+        if ( m_scaleQuantizationStep > 0.0f )
+        {
+            if ( m_scaleBuckets.size() > HAAR_BANK_MAXIMUM_NUMBER_OF_SCALE_BUCKETS )
+            {
+                m_scaleBuckets.clear();
+            }
+
+            const double logScaleStep = log( 1.0 + m_scaleQuantizationStep );
+            const ScaleBucket& bucket = m_scaleBuckets[ FindOrAddScaleBucket( cvFloor( log( sample.m_scaleX ) / logScaleStep ),
+                                                                              cvFloor( log( sample.m_scaleY ) / logScaleStep ),
+                                                                              pixStep ) ];
+            pOffsets    = &bucket.m_offsets[0];
+            area        = bucket.m_area;
+        }
+        else
+        {
+            offsets.resize( m_cornerX.size() + 1 );
+            ScaleCorners( 0, (uint)m_cornerX.size(), sample.m_scaleX, sample.m_scaleY, pixStep, &offsets[0] );
+            pOffsets    = &offsets[0];
+            area        = sample.m_scaleX*sample.m_scaleY;
+        }
+
+        const int numberOfFeatures = (int)featureIndices.size();
+
+        #pragma omp parallel for schedule(dynamic)
+        for ( int k = 0; k < numberOfFeatures; k++ )
+        {
+            const uint featureIndex = featureIndices[k];
+            ASSERT_TRUE( featureIndex < GetNumberOfFeatures() );
+
+            const IntegralType* pPlane            = sample.m_pImgGray->iiPlane( m_channel[featureIndex] );
+            const int* pFeatureOffsets            = pOffsets + m_firstCorner[featureIndex];
+            const uint* pRectangleCorners        = &m_rectangleCorners[0] + 4*m_firstRectangle[featureIndex];
+            const float* pRectangleWeights        = &m_rectangleWeights[0] + m_firstRectangle[featureIndex];
+            const uint numberOfRectangles        = m_firstRectangle[featureIndex+1] - m_firstRectangle[featureIndex];
+
+            //the feature column holds the grid row by row
+            float* pResponses = &sampleSet.GetFeatureValue( 0, featureIndex );
+
+            for ( int row = 0; row < numberOfRows; row++ )
+            {
+                const IntegralType* pOrigin = pPlane + ( sample.m_row + row )*pixStep + sample.m_col;
+                ComputeResponseRow( pOrigin, pFeatureOffsets, pRectangleCorners, pRectangleWeights, numberOfRectangles, area, numberOfColumns, pResponses + row*numberOfColumns );
+            }
+        }
+    }
+}
@@ -0,0 +1,100 @@
+#ifndef HAAR_FEATURE_BANK_H
+#define HAAR_FEATURE_BANK_H
+
+#include "Feature.h"
+
+namespace Features
+{
+    /****************************************************************
+    HaarFeatureBank
+        The Haar features of a HaarFeatureVector compiled into flat
+        tables (structure of arrays). Each feature owns a run of
+        distinct corners: a corner is kept once however many of the
+        feature's rectangles touch it, as long as it scales the same
+        way (same left/top edge, or same right/bottom edge). Each
+        rectangle is a sparse list of four corner indices and a
+        weight. Evaluating a feature on a sample gathers the corner
+        values from the integral image in one pass, then combines
+        them rectangle by rectangle; the box sums stay exact integers
+        and the result is the same as HaarFeature::Compute.
+        With a scale quantization step, the sample scales are first
+        rounded down to buckets (1+step)^k; the corner offsets of all the
+        features are computed once per bucket, when it is first used,
+        so the evaluation itself is integer adds only. The samples
+        are evaluated in tiles of nearby samples, all features of a
+        tile at once, while its part of the integral image is cached.
+        A dense grid of samples is evaluated as response maps instead:
+        one feature at a time over whole rows of the grid.
+    ****************************************************************/
+    class HaarFeatureBank
+    {
+    public:
+        HaarFeatureBank( );
+
+        //flatten the given haar features (the feature list of a HaarFeatureVector)
+        void            Compile( const FeatureList& featureList, const float scaleQuantizationStep = 0.0f );
+
+        //assign the samples of the set to their scale buckets and to tiles; must precede ComputeTile on the same set
+        void            PrepareSamples( Classifier::SampleSet& sampleSet );
+
+        //compute the listed features on the samples of one tile into their feature columns; tiles can be computed concurrently
+        void            ComputeTile( const uint tileIndex, Classifier::SampleSet& sampleSet, const vectori& featureIndices ) const;
+
+        //compute the listed features at every location of a dense grid sample set into their feature columns
+        void            ComputeResponseMaps( Classifier::SampleSet& sampleSet, const vectori& featureIndices );
+
+        const uint        GetNumberOfFeatures( ) const { return (uint)m_channel.size(); }
+        const uint        GetNumberOfTiles( ) const { return m_firstTileSample.empty() ? 0 : (uint)m_firstTileSample.size() - 1; }
+        const uint*        GetTileSamples( const uint tileIndex ) const { return &m_tileSamples[0] + m_firstTileSample[tileIndex]; }
+        const uint        GetNumberOfTileSamples( const uint tileIndex ) const { return m_firstTileSample[tileIndex+1] - m_firstTileSample[tileIndex]; }
+        const uint        GetMaximumNumberOfCorners( ) const { return m_maximumNumberOfCorners; }
+
+    private:
+        DISALLOW_EVIL_CONSTRUCTORS( HaarFeatureBank );
+
+        /****************************************************************
+        ScaleBucket
+            Corner offsets of every feature at one quantized scale.
+        ****************************************************************/
+        struct ScaleBucket
+        {
+            int            m_scaleIndexX;        //scale (1+step)^index
+            int            m_scaleIndexY;
+            int            m_pixStep;            //row step of the integral image the offsets are for
+            float        m_area;                //scaleX*scaleY
+            vector<int>    m_offsets;            //aligned with the corner tables
+        };
+
+        //integral image offsets of the given corners, relative to the sample origin, at the given scale
+        void            ScaleCorners( const uint firstCorner, const uint endCorner, const float scaleX, const float scaleY, const int pixStep, int* pOffsets ) const;
+        uint            FindOrAddScaleBucket( const int scaleIndexX, const int scaleIndexY, const int pixStep );
+
+        //per feature
+        vector<uint>    m_channel;
+        vector<uint>    m_firstCorner;            //corners of feature f are [m_firstCorner[f], m_firstCorner[f+1])
+        vector<uint>    m_firstRectangle;        //rectangles of feature f are [m_firstRectangle[f], m_firstRectangle[f+1])
+
+        //per corner: x = round(m_cornerX*scaleX) + round(m_cornerWidth*scaleX), the same for y
+        vector<int>        m_cornerX;
+        vector<int>        m_cornerWidth;
+        vector<int>        m_cornerY;
+        vector<int>        m_cornerHeight;
+
+        //per rectangle: corner indices within its feature (top left, top right, bottom left, bottom right) and weight
+        vector<uint>    m_rectangleCorners;
+        vectorf            m_rectangleWeights;
+
+        uint            m_maximumNumberOfCorners;
+
+        //scale buckets
+        float                m_scaleQuantizationStep;    //0: every sample is scaled exactly
+        vector<ScaleBucket>    m_scaleBuckets;
+        vector<uint>        m_sampleScaleBuckets;        //bucket of each sample of the set prepared last
+        uint                m_lastScaleBucket;
+
+        //tiles of the set prepared last
+        vector<uint>        m_tileSamples;                //sample indices, tile by tile
+        vector<uint>        m_firstTileSample;            //samples of tile t are m_tileSamples[m_firstTileSample[t] .. m_firstTileSample[t+1])
+    };
+}
+#endif
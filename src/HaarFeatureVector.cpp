@@ -29,6 +29,11 @@ namespace Features
                 m_featureList[featureIndex]->Generate( m_featureParametersPtr );
             }
 
+            HaarFeatureParametersPtr haarFeatureParametersPtr = boost::dynamic_pointer_cast<HaarFeatureParameters>( featureParametersPtr );
+            ASSERT_TRUE( haarFeatureParametersPtr != NULL );
+
+            m_haarFeatureBank.Compile( m_featureList, haarFeatureParametersPtr->GetScaleQuantizationStep() );
+
             //Update the feature generated flag
             m_isFeatureGenerated = true;
         }
@@ -37,15 +42,19 @@ namespace Features
 
 
     /****************************************************************
-    HaarFeatureVector::Compute
+    HaarFeatureVector::ComputeFeatures
         Iterate over each sample in the given Classifier::SampleSet
-        and compute the featurePtr. Store the computed featurePtr value 
-        in the featurePtr vector.
+        and compute the features through the compiled feature bank,
+        in parallel over tiles of nearby samples (as response maps
+        for a dense grid of samples). Only the requested
+        features not computed yet are computed (e.g. just the ones the
+        strong classifier selected). Store the computed feature values
+        in the feature matrix.
         Classifier calls this method with a set of samples for each type.
     Exception:
         None
     ****************************************************************/
-    void    HaarFeatureVector::Compute( Classifier::SampleSet& sampleSet, bool shouldResizeFeatureMatrix )
+    void    HaarFeatureVector::ComputeFeatures( Classifier::SampleSet& sampleSet, bool shouldResizeFeatureMatrix, const vectori* pFeatureIndices )
     {
         size_t numberOfSamples        = sampleSet.Size( );
 
@@ -64,16 +73,68 @@ namespace Features
             sampleSet.ResizeFeatures( m_numberOfHaarFeatures );
         }
 
-        #pragma omp parallel for
-        for ( uint featureIndex = 0; featureIndex < m_numberOfHaarFeatures; featureIndex++ )
+        CollectFeaturesToCompute( sampleSet, pFeatureIndices );
+
+        if ( m_featuresToCompute.empty() )
+        {
+            return;
+        }
+
+        if ( sampleSet.IsDenseGrid() )
         {
-            //#pragma omp parallel for
-            for ( int sampleIndex = 0; sampleIndex < numberOfSamples; sampleIndex++ )
+            //response maps over the whole grid
+            m_haarFeatureBank.ComputeResponseMaps( sampleSet, m_featuresToCompute );
+        }
+        else
+        {
+            //rectangle geometry of the sample scales, and tiles of nearby samples
+            m_haarFeatureBank.PrepareSamples( sampleSet );
+
+            const int numberOfTiles = (int)m_haarFeatureBank.GetNumberOfTiles();
+
+            #pragma omp parallel for schedule(dynamic)
+            for ( int tileIndex = 0; tileIndex < numberOfTiles; tileIndex++ )
             {
-                ASSERT_TRUE( m_featureList[featureIndex] != NULL );
+                //store the feature values of the samples of the tile in the feature matrix
+                m_haarFeatureBank.ComputeTile( tileIndex, sampleSet, m_featuresToCompute );
+            }
+        }
+
+        for ( uint k = 0; k < m_featuresToCompute.size(); k++ )
+        {
+            sampleSet.SetFeatureComputed( m_featuresToCompute[k] );
+        }
+    }
 
-                //store the feature value in the feature matrix
-                sampleSet.GetFeatureValue( sampleIndex, featureIndex ) = m_featureList[featureIndex]->Compute( sampleSet[sampleIndex] );
+    /****************************************************************
+    HaarFeatureVector::CollectFeaturesToCompute
+        List the requested haar features (all if NULL) not computed
+        yet in m_featuresToCompute.
+    Exception:
+        None
+    ****************************************************************/
+    void    HaarFeatureVector::CollectFeaturesToCompute( const Classifier::SampleSet& sampleSet, const vectori* pFeatureIndices )
+    {
+        m_featuresToCompute.clear();
+        if ( pFeatureIndices == NULL )
+        {
+            for ( int featureIndex = 0; featureIndex < (int)m_numberOfHaarFeatures; featureIndex++ )
+            {
+                if ( !sampleSet.IsFeatureComputed( featureIndex ) )
+                {
+                    m_featuresToCompute.push_back( featureIndex );
+                }
+            }
+        }
+        else
+        {
+            for ( uint k = 0; k < pFeatureIndices->size(); k++ )
+            {
+                const int featureIndex = (*pFeatureIndices)[k];
+                if ( featureIndex < (int)m_numberOfHaarFeatures && !sampleSet.IsFeatureComputed( featureIndex ) )
+                {
+                    m_featuresToCompute.push_back( featureIndex );
+                }
             }
         }
     }
@@ -2,12 +2,15 @@
 #define HAAR_FEATURE_VECTOR_H
 
 #include "FeatureVector.h"
+#include "HaarFeatureBank.h"
 
 namespace Features
 {
     /****************************************************************
      HaarFeatureVector
-        This is a wrapper class for HaarFeature.
+        This is a wrapper class for HaarFeature. The generated
+        features are compiled into a HaarFeatureBank, which does
+        the computation.
     ****************************************************************/
     class HaarFeatureVector : virtual public FeatureVector
     {
@@ -15,15 +18,21 @@ namespace Features
         HaarFeatureVector( ){}
 
         virtual void    Generate( FeatureParametersPtr featureParametersPtr );
-        virtual void    Compute( Classifier::SampleSet& sampleSet, bool shouldResizeFeatureMatrix = true );
 
         virtual void    SaveVisualizedFeatureVector( const char * dirname );
 
         virtual const uint GetNumberOfFeatures( ) const { return m_numberOfHaarFeatures; }
 
     protected:
+        virtual void    ComputeFeatures( Classifier::SampleSet& sampleSet, bool shouldResizeFeatureMatrix, const vectori* pFeatureIndices );
+
+        //the requested haar features not computed yet, into m_featuresToCompute
+        void            CollectFeaturesToCompute( const Classifier::SampleSet& sampleSet, const vectori* pFeatureIndices );
+
         FeatureList                m_featureList;
         uint                    m_numberOfHaarFeatures;
+        HaarFeatureBank            m_haarFeatureBank;
+        vectori                    m_featuresToCompute;    //features of the current ComputeFeatures call
     };
 }
 #endif
@@ -0,0 +1,594 @@
+#include "LiveFrameSource.h"
+
+#if !defined(WIN32) && !defined(WIN64)
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+//poll period of the reader thread, so that it notices it is stopped
+#define LIVE_READ_POLL_MS    100
+
+//clamp a converted sample to [0,255]
+static inline uchar ClipToByte( const int value )
+{
+    return (uchar)( value < 0 ? 0 : ( value > 255 ? 255 : value ) );
+}
+
+namespace MultipleCameraTracking
+{
+    /********************************************************************
+    LiveFrameSource
+        Constructor. Opens the input (waiting for the writer of a FIFO),
+        reads the first frame as frame 0 and starts the reader thread.
+    Exceptions:
+        None
+    *********************************************************************/
+    LiveFrameSource::LiveFrameSource( const string&            inputPath,
+                                      const LiveInputFormat    inputFormat,
+                                      const int                frameWidth,
+                                      const int                frameHeight,
+                                      const int                startFrameIndex,
+                                      const int                endFrameIndex,
+                                      const bool            isColor,
+                                      const int                alignmentWindowSize )
+        : FrameSource( isColor ),
+        m_inputFormat( inputFormat ),
+        m_chromaShiftX( 1 ),
+        m_chromaShiftY( 1 ),
+        m_isMonochrome( false ),
+        m_readBuffer( ),
+        m_slotList( ),
+        m_keptSlotQueue( ),
+        m_freeSlotList( ),
+        m_alignmentWindowSize( alignmentWindowSize ),
+        m_currentSlot( -1 ),
+        m_currentFrameIndex( -1 ),
+        m_numberOfDroppedFrames( 0 ),
+        m_endOfStream( false ),
+        m_stopReading( false )
+    {
+        try
+        {
+            ASSERT_TRUE( alignmentWindowSize > 0 );
+            ASSERT_TRUE( endFrameIndex >= startFrameIndex );
+
+            m_numberOfFrames = endFrameIndex - startFrameIndex + 1;
+
+#if defined(WIN32) || defined(WIN64)
+            m_pInputFile = fopen( inputPath.c_str(), "rb" );
+            if ( m_pInputFile == NULL )
+#else
+            m_fileDescriptor = open( inputPath.c_str(), O_RDONLY );
+            if ( m_fileDescriptor < 0 )
+#endif
+            {
+                abortError( __LINE__, __FILE__, ( "Error opening live input " + inputPath ).c_str() );
+            }
+
+            size_t frameSize = 0;
+            if ( m_inputFormat == LIVE_INPUT_Y4M )
+            {
+                ReadY4MHeader( );
+
+                const size_t chromaSize = m_isMonochrome ? 0 :
+                    (size_t)( ( m_frameWidth + ( 1 << m_chromaShiftX ) - 1 ) >> m_chromaShiftX ) * ( ( m_frameHeight + ( 1 << m_chromaShiftY ) - 1 ) >> m_chromaShiftY );
+
+                frameSize = (size_t)m_frameWidth * m_frameHeight + 2 * chromaSize;
+            }
+            else
+            {
+                ASSERT_TRUE( frameWidth > 0 && frameHeight > 0 );
+
+                m_frameWidth    = frameWidth;
+                m_frameHeight    = frameHeight;
+                frameSize        = (size_t)m_frameWidth * m_frameHeight * ( isColor ? 3 : 1 );
+            }
+            m_readBuffer.resize( frameSize );
+
+            //the kept frames, the selected frame and the frame being read
+            m_slotList.resize( m_alignmentWindowSize + 2 );
+            for ( int slotIndex = (int)m_slotList.size() - 1; slotIndex >= 0; slotIndex-- )
+            {
+                m_freeSlotList.push_back( slotIndex );
+            }
+
+            //the first frame is frame 0, used to initialize the trackers
+            m_currentSlot = m_freeSlotList.back();
+            m_freeSlotList.pop_back();
+            if ( !ReadFrame( m_slotList[m_currentSlot] ) )
+            {
+                abortError( __LINE__, __FILE__, "Live input ended before its first frame" );
+            }
+            m_currentFrameIndex = 0;
+
+            m_readerThread = boost::thread( &LiveFrameSource::ReadFrames, this );
+        }
+        EXCEPTION_CATCH_AND_ABORT( "Failed to construct LiveFrameSource" );
+    }
+
+    /********************************************************************
+    ~LiveFrameSource
+        Destructor. Stops the reader thread and closes the input. On
+        Windows the reader only stops once the writer sends a frame or
+        closes the pipe.
+    Exceptions:
+        None
+    *********************************************************************/
+    LiveFrameSource::~LiveFrameSource( )
+    {
+        m_stopReading = true;
+        m_readerThread.join();
+
+#if defined(WIN32) || defined(WIN64)
+        fclose( m_pInputFile );
+#else
+        close( m_fileDescriptor );
+#endif
+    }
+
+    /********************************************************************
+    GetFrame
+        Get the frame selected for the given index.
+    Exceptions:
+        None
+    *********************************************************************/
+    Matrixu* LiveFrameSource::GetFrame( const int frameInd )
+    {
+        boost::mutex::scoped_lock lock( m_mutex );
+
+        ASSERT_TRUE( frameInd == m_currentFrameIndex && m_currentSlot >= 0 );
+
+        return &m_slotList[m_currentSlot].m_frame;
+    }
+
+    /********************************************************************
+    WaitForFrame
+        Wait until a frame newer than the selected one was read.
+    Exceptions:
+        None
+    *********************************************************************/
+    bool LiveFrameSource::WaitForFrame( long long& newestTimestamp )
+    {
+        boost::mutex::scoped_lock lock( m_mutex );
+
+        while ( m_keptSlotQueue.empty() && !m_endOfStream )
+        {
+            m_frameRead.wait( lock );
+        }
+
+        if ( m_keptSlotQueue.empty() )
+        {
+            return false;
+        }
+
+        newestTimestamp = m_slotList[m_keptSlotQueue.back()].m_timestamp;
+        return true;
+    }
+
+    /********************************************************************
+    SelectFrame
+        Select the kept frame whose timestamp is closest to the target
+        as the given frame. The kept frames older than it will never
+        be tracked and are dropped; the newer ones stay for the next
+        frame.
+    Exceptions:
+        None
+    *********************************************************************/
+    void LiveFrameSource::SelectFrame( const int frameInd, const long long targetTimestamp )
+    {
+        boost::mutex::scoped_lock lock( m_mutex );
+
+        ASSERT_TRUE( !m_keptSlotQueue.empty() );
+
+        //closest frame, the newest one on a tie
+        int            selectedPosition    = (int)m_keptSlotQueue.size() - 1;
+        long long    smallestDistance    = -1;
+        for ( int position = (int)m_keptSlotQueue.size() - 1; position >= 0; position-- )
+        {
+            const long long timestamp    = m_slotList[m_keptSlotQueue[position]].m_timestamp;
+            const long long distance    = ( timestamp > targetTimestamp ) ? timestamp - targetTimestamp : targetTimestamp - timestamp;
+
+            if ( smallestDistance < 0 || distance < smallestDistance )
+            {
+                smallestDistance    = distance;
+                selectedPosition    = position;
+            }
+        }
+
+        for ( int position = 0; position < selectedPosition; position++ )
+        {
+            m_freeSlotList.push_back( m_keptSlotQueue.front() );
+            m_keptSlotQueue.pop_front();
+            m_numberOfDroppedFrames++;
+        }
+
+        if ( m_currentSlot >= 0 )
+        {
+            m_freeSlotList.push_back( m_currentSlot );
+        }
+
+        m_currentSlot        = m_keptSlotQueue.front();
+        m_currentFrameIndex    = frameInd;
+        m_keptSlotQueue.pop_front();
+    }
+
+    /********************************************************************
+    GetFrameTimestamp
+        Capture timestamp of the selected frame.
+    Exceptions:
+        None
+    *********************************************************************/
+    long long LiveFrameSource::GetFrameTimestamp( )
+    {
+        boost::mutex::scoped_lock lock( m_mutex );
+
+        ASSERT_TRUE( m_currentSlot >= 0 );
+
+        return m_slotList[m_currentSlot].m_timestamp;
+    }
+
+    /********************************************************************
+    GetFrameIngestTime
+        Time the selected frame was read completely.
+    Exceptions:
+        None
+    *********************************************************************/
+    long long LiveFrameSource::GetFrameIngestTime( )
+    {
+        boost::mutex::scoped_lock lock( m_mutex );
+
+        ASSERT_TRUE( m_currentSlot >= 0 );
+
+        return m_slotList[m_currentSlot].m_ingestTime;
+    }
+
+    /********************************************************************
+    GetNumberOfDroppedFrames
+        Frames read but never tracked so far.
+    Exceptions:
+        None
+    *********************************************************************/
+    long LiveFrameSource::GetNumberOfDroppedFrames( )
+    {
+        boost::mutex::scoped_lock lock( m_mutex );
+
+        return m_numberOfDroppedFrames;
+    }
+
+    /********************************************************************
+    GetWallClockTime
+        Microseconds since 1970, UTC.
+    Exceptions:
+        None
+    *********************************************************************/
+    long long LiveFrameSource::GetWallClockTime( )
+    {
+        static const boost::posix_time::ptime epoch( boost::gregorian::date( 1970, 1, 1 ) );
+
+        return ( boost::posix_time::microsec_clock::universal_time() - epoch ).total_microseconds();
+    }
+
+    /********************************************************************
+    ReadFrames
+        Reader thread. Reads the frames into free slots and keeps the
+        newest ones, dropping the oldest kept frame when the window is
+        full, until the stream ends or it is stopped.
+    Exceptions:
+        None
+    *********************************************************************/
+    void LiveFrameSource::ReadFrames( )
+    {
+        while ( !m_stopReading )
+        {
+            //there is always a free slot: at most all the others are kept or selected
+            int slotIndex;
+            {
+                boost::mutex::scoped_lock lock( m_mutex );
+                slotIndex = m_freeSlotList.back();
+                m_freeSlotList.pop_back();
+            }
+
+            const bool frameRead = ReadFrame( m_slotList[slotIndex] );
+
+            boost::mutex::scoped_lock lock( m_mutex );
+
+            if ( !frameRead )
+            {
+                m_freeSlotList.push_back( slotIndex );
+                m_endOfStream = true;
+                m_frameRead.notify_all();
+                return;
+            }
+
+            m_keptSlotQueue.push_back( slotIndex );
+            if ( (int)m_keptSlotQueue.size() > m_alignmentWindowSize )
+            {
+                m_freeSlotList.push_back( m_keptSlotQueue.front() );
+                m_keptSlotQueue.pop_front();
+                m_numberOfDroppedFrames++;
+            }
+
+            m_frameRead.notify_all();
+        }
+    }
+
+    /********************************************************************
+    ReadFrame
+        Read the next frame of the stream and convert it into the slot.
+        A truncated or malformed frame ends the stream.
+    Exceptions:
+        None
+    *********************************************************************/
+    bool LiveFrameSource::ReadFrame( LiveFrame& liveFrame )
+    {
+        long long timestamp = -1;
+
+        if ( m_inputFormat == LIVE_INPUT_Y4M )
+        {
+            string frameHeader;
+            if ( !ReadLine( frameHeader ) || frameHeader.compare( 0, 5, "FRAME" ) != 0 )
+            {
+                return false;
+            }
+
+            //optional capture timestamp of the writer
+            const size_t timestampPosition = frameHeader.find( " Xts=" );
+            if ( timestampPosition != string::npos )
+            {
+                istringstream timestampStream( frameHeader.substr( timestampPosition + 5 ) );
+                timestampStream >> timestamp;
+            }
+        }
+
+        if ( !ReadBytes( &m_readBuffer[0], m_readBuffer.size() ) )
+        {
+            return false;
+        }
+
+        liveFrame.m_ingestTime    = GetWallClockTime( );
+        liveFrame.m_timestamp    = ( timestamp >= 0 ) ? timestamp : liveFrame.m_ingestTime;
+
+        if ( m_inputFormat == LIVE_INPUT_Y4M )
+        {
+            ConvertY4MFrame( liveFrame.m_frame );
+        }
+        else
+        {
+            ConvertRawFrame( liveFrame.m_frame );
+        }
+
+        return true;
+    }
+
+    /********************************************************************
+    ReadY4MHeader
+        Read the stream header: frame size and chroma subsampling.
+    Exceptions:
+        None
+    *********************************************************************/
+    void LiveFrameSource::ReadY4MHeader( )
+    {
+        string streamHeader;
+        if ( !ReadLine( streamHeader ) || streamHeader.compare( 0, 9, "YUV4MPEG2" ) != 0 )
+        {
+            abortError( __LINE__, __FILE__, "Live input is not a YUV4MPEG2 stream" );
+        }
+
+        string colorSpace = "420jpeg";
+
+        istringstream headerStream( streamHeader );
+        string parameter;
+        while ( headerStream >> parameter )
+        {
+            switch ( parameter[0] )
+            {
+                case 'W':
+                    m_frameWidth = atoi( parameter.c_str() + 1 );
+                    break;
+                case 'H':
+                    m_frameHeight = atoi( parameter.c_str() + 1 );
+                    break;
+                case 'C':
+                    colorSpace = parameter.substr( 1 );
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        ASSERT_TRUE( m_frameWidth > 0 && m_frameHeight > 0 );
+
+        if ( colorSpace == "mono" )
+        {
+            m_isMonochrome = true;
+        }
+        else if ( colorSpace.compare( 0, 3, "420" ) == 0 )
+        {
+            m_chromaShiftX = 1;
+            m_chromaShiftY = 1;
+        }
+        else if ( colorSpace == "422" )
+        {
+            m_chromaShiftX = 1;
+            m_chromaShiftY = 0;
+        }
+        else if ( colorSpace == "444" )
+        {
+            m_chromaShiftX = 0;
+            m_chromaShiftY = 0;
+        }
+        else
+        {
+            abortError( __LINE__, __FILE__, "Unsupported YUV4MPEG2 color space, use mono, 420, 422 or 444" );
+        }
+    }
+
+    /********************************************************************
+    ReadLine
+        Read a header line of the stream, without its newline.
+    Exceptions:
+        None
+    *********************************************************************/
+    bool LiveFrameSource::ReadLine( string& line )
+    {
+        line.clear();
+
+        unsigned char character;
+        while ( ReadBytes( &character, 1 ) )
+        {
+            if ( character == '\n' )
+            {
+                return true;
+            }
+
+            //header lines are short, anything longer is not a YUV4MPEG2 stream
+            if ( line.size() > 1024 )
+            {
+                return false;
+            }
+
+            line.push_back( (char)character );
+        }
+
+        return false;
+    }
+
+    /********************************************************************
+    ReadBytes
+        Read exactly size bytes. False at the end of the stream, on an
+        error or when the reader is stopped.
+    Exceptions:
+        None
+    *********************************************************************/
+    bool LiveFrameSource::ReadBytes( unsigned char* pBuffer, const size_t size )
+    {
+#if defined(WIN32) || defined(WIN64)
+        return !m_stopReading && fread( pBuffer, 1, size, m_pInputFile ) == size;
+#else
+        size_t bytesRead = 0;
+        while ( bytesRead < size )
+        {
+            struct pollfd pollDescriptor;
+            pollDescriptor.fd        = m_fileDescriptor;
+            pollDescriptor.events    = POLLIN;
+            pollDescriptor.revents    = 0;
+
+            const int ready = poll( &pollDescriptor, 1, LIVE_READ_POLL_MS );
+
+            if ( m_stopReading )
+            {
+                return false;
+            }
+
+            if ( ready < 0 && errno != EINTR )
+            {
+                return false;
+            }
+
+            if ( ready <= 0 )
+            {
+                continue;
+            }
+
+            const ssize_t count = read( m_fileDescriptor, pBuffer + bytesRead, size - bytesRead );
+            if ( count <= 0 )
+            {
+                //the writer closed the pipe
+                return false;
+            }
+
+            bytesRead += (size_t)count;
+        }
+
+        return true;
+#endif
+    }
+
+    /********************************************************************
+    ConvertY4MFrame
+        Convert the Y'CbCr planes read (BT.601, studio range) into the
+        gray or RGB planes of the frame.
+    Exceptions:
+        None
+    *********************************************************************/
+    void LiveFrameSource::ConvertY4MFrame( Matrixu& frame )
+    {
+        frame.Resize( m_frameHeight, m_frameWidth, m_isColor ? 3 : 1 );
+
+        const int                chromaWidth    = ( m_frameWidth + ( 1 << m_chromaShiftX ) - 1 ) >> m_chromaShiftX;
+        const int                chromaHeight= ( m_frameHeight + ( 1 << m_chromaShiftY ) - 1 ) >> m_chromaShiftY;
+        const unsigned char*    pLuma        = &m_readBuffer[0];
+        const unsigned char*    pCb            = pLuma + m_frameWidth * m_frameHeight;
+        const unsigned char*    pCr            = pCb + chromaWidth * chromaHeight;
+
+        if ( !m_isColor )
+        {
+            cv::Mat grayPlane = frame.getPlaneMat( 0 );
+            for ( int row = 0; row < m_frameHeight; row++ )
+            {
+                const unsigned char*    pLumaRow    = pLuma + row * m_frameWidth;
+                uchar*                    pGrayRow    = grayPlane.ptr<uchar>( row );
+                for ( int col = 0; col < m_frameWidth; col++ )
+                {
+                    pGrayRow[col] = ClipToByte( ( 298 * ( pLumaRow[col] - 16 ) + 128 ) >> 8 );
+                }
+            }
+            return;
+        }
+
+        cv::Mat redPlane    = frame.getPlaneMat( 0 );
+        cv::Mat greenPlane    = frame.getPlaneMat( 1 );
+        cv::Mat bluePlane    = frame.getPlaneMat( 2 );
+
+        for ( int row = 0; row < m_frameHeight; row++ )
+        {
+            const unsigned char*    pLumaRow    = pLuma + row * m_frameWidth;
+            const unsigned char*    pCbRow        = pCb + ( row >> m_chromaShiftY ) * chromaWidth;
+            const unsigned char*    pCrRow        = pCr + ( row >> m_chromaShiftY ) * chromaWidth;
+            uchar*                    pRedRow        = redPlane.ptr<uchar>( row );
+            uchar*                    pGreenRow    = greenPlane.ptr<uchar>( row );
+            uchar*                    pBlueRow    = bluePlane.ptr<uchar>( row );
+
+            for ( int col = 0; col < m_frameWidth; col++ )
+            {
+                const int c = 298 * ( pLumaRow[col] - 16 ) + 128;
+                const int d = m_isMonochrome ? 0 : pCbRow[col >> m_chromaShiftX] - 128;
+                const int e = m_isMonochrome ? 0 : pCrRow[col >> m_chromaShiftX] - 128;
+
+                pRedRow[col]    = ClipToByte( ( c + 409 * e ) >> 8 );
+                pGreenRow[col]    = ClipToByte( ( c - 100 * d - 208 * e ) >> 8 );
+                pBlueRow[col]    = ClipToByte( ( c + 516 * d ) >> 8 );
+            }
+        }
+    }
+
+    /********************************************************************
+    ConvertRawFrame
+        Split the interleaved RGB24 (or copy the gray) frame read into
+        the planes of the frame.
+    Exceptions:
+        None
+    *********************************************************************/
+    void LiveFrameSource::ConvertRawFrame( Matrixu& frame )
+    {
+        const int channels = m_isColor ? 3 : 1;
+
+        frame.Resize( m_frameHeight, m_frameWidth, channels );
+
+        for ( int channel = 0; channel < channels; channel++ )
+        {
+            cv::Mat plane = frame.getPlaneMat( channel );
+            for ( int row = 0; row < m_frameHeight; row++ )
+            {
+                const unsigned char*    pPixel    = &m_readBuffer[( row * m_frameWidth ) * channels + channel];
+                uchar*                    pRow    = plane.ptr<uchar>( row );
+                for ( int col = 0; col < m_frameWidth; col++, pPixel += channels )
+                {
+                    pRow[col] = *pPixel;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,124 @@
+#ifndef LIVE_FRAME_SOURCE_HEADER
+#define LIVE_FRAME_SOURCE_HEADER
+
+#include "FrameSource.h"
+#include "CommonMacros.h"
+
+#include <deque>
+#include <boost/thread.hpp>
+#include <boost/atomic.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+#define LIVE_Y4M_EXTENSION        ".y4m"
+#define LIVE_RGB_EXTENSION        ".rgb"
+#define LIVE_GRAY_EXTENSION        ".gray"
+
+namespace MultipleCameraTracking
+{
+    enum LiveInputFormat
+    {
+        LIVE_INPUT_Y4M    = 0,    //YUV4MPEG2 stream (mono, 4:2:0, 4:2:2 or 4:4:4), optional "Xts=<microseconds>" frame timestamps
+        LIVE_INPUT_RAW    = 1        //headerless interleaved RGB24 (or 8 bit gray) frames of a configured size
+    };
+
+    //Forward Declaration
+    class LiveFrameSource;
+
+    //declarations of shared ptr
+    typedef boost::shared_ptr<LiveFrameSource>    LiveFrameSourcePtr;
+
+    /****************************************************************
+    LiveFrameSource
+        Derives from FrameSource.
+        Reads frames from a FIFO or a pipe (a stand-in for a capture
+        device) on a background reader thread. Only the newest few
+        frames are kept: when tracking falls behind, older frames
+        are dropped, so the latency stays bounded instead of a
+        backlog building up. Each frame carries its timestamp (from
+        the stream, or its arrival time) and its ingest time.
+        The camera network picks the frame of each camera with
+        SelectFrame before tracking it; GetFrame then returns the
+        selected frame. The number of frames is an upper bound, the
+        stream may end before.
+    ****************************************************************/
+    class LiveFrameSource : public FrameSource
+    {
+    public:
+        LiveFrameSource( const string&            inputPath,
+                         const LiveInputFormat    inputFormat,
+                         const int                frameWidth,
+                         const int                frameHeight,
+                         const int                startFrameIndex,
+                         const int                endFrameIndex,
+                         const bool                isColor,
+                         const int                alignmentWindowSize );
+
+        virtual ~LiveFrameSource( );
+
+        virtual Matrixu*    GetFrame( const int frameInd );
+
+        //wait for a frame newer than the selected one; false once the stream ended
+        bool                WaitForFrame( long long& newestTimestamp );
+
+        //select the kept frame closest to the timestamp as the given frame; older frames are dropped
+        void                SelectFrame( const int frameInd, const long long targetTimestamp );
+
+        //of the selected frame, in microseconds
+        long long            GetFrameTimestamp( );
+        long long            GetFrameIngestTime( );
+
+        long                GetNumberOfDroppedFrames( );
+
+        //wall clock in microseconds, the time base of the arrival timestamps
+        static long long    GetWallClockTime( );
+
+    private:
+        DISALLOW_IMPLICIT_CONSTRUCTORS( LiveFrameSource );
+
+        struct LiveFrame
+        {
+            Matrixu            m_frame;
+            long long        m_timestamp;        //capture timestamp in microseconds
+            long long        m_ingestTime;        //when the frame was read completely
+        };
+
+        //body of the reader thread
+        void                ReadFrames( );
+
+        //read the next frame of the stream into the slot; false at the end of the stream
+        bool                ReadFrame( LiveFrame& liveFrame );
+        void                ReadY4MHeader( );
+        bool                ReadLine( string& line );
+        bool                ReadBytes( unsigned char* pBuffer, const size_t size );
+
+        //convert the frame read into m_readBuffer
+        void                ConvertY4MFrame( Matrixu& frame );
+        void                ConvertRawFrame( Matrixu& frame );
+
+        LiveInputFormat        m_inputFormat;
+        int                    m_chromaShiftX;            //Y4M chroma subsampling (1 for 4:2:0, 0 for 4:4:4)
+        int                    m_chromaShiftY;
+        bool                m_isMonochrome;            //Y4M stream without chroma planes
+        vectoru                m_readBuffer;            //one frame as read from the stream
+
+        boost::mutex                m_mutex;                //guards the slots and the queues
+        boost::condition_variable    m_frameRead;
+        vector<LiveFrame>            m_slotList;                //frames being read, kept and selected
+        std::deque<int>                m_keptSlotQueue;        //kept frames, oldest first
+        vectori                        m_freeSlotList;
+        int                            m_alignmentWindowSize;    //number of newest frames kept
+        int                            m_currentSlot;            //selected frame (-1: none)
+        int                            m_currentFrameIndex;    //index of the selected frame
+        long                        m_numberOfDroppedFrames;
+        bool                        m_endOfStream;
+        boost::atomic<bool>            m_stopReading;            //asks the reader thread to finish
+        boost::thread                m_readerThread;
+
+#if defined(WIN32) || defined(WIN64)
+        FILE*                        m_pInputFile;
+#else
+        int                            m_fileDescriptor;
+#endif
+    };
+}
+#endif
@@ -164,10 +164,10 @@ namespace Classifier
         int numberOfSamples = sampleSet.Size();
         vectorf responseList(numberOfSamples);
         
-        // Compute features
-        if ( !sampleSet.IsFeatureComputed( ) ) 
+        // Compute the features of the selected weak classifiers only
+        if ( !sampleSet.IsFeatureComputed( m_selectorList ) )
         {
-            m_featureVectorPtr->Compute( sampleSet );
+            m_featureVectorPtr->Compute( sampleSet, true, &m_selectorList );
         }
 
         // for each selector, accumulate in the responseList
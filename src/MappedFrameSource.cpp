@@ -0,0 +1,212 @@
+#include "MappedFrameSource.h"
+
+#if !defined(WIN32) && !defined(WIN64)
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace MultipleCameraTracking
+{
+    /********************************************************************
+    MappedFrameSource
+        Constructor. Opens the raw frame file and checks that it holds
+        the requested frames.
+    Exceptions:
+        None
+    *********************************************************************/
+    MappedFrameSource::MappedFrameSource( const string&    rawFrameFileName,
+                                          const int        startFrameIndex,
+                                          const int        endFrameIndex,
+                                          const bool    isColor )
+        : FrameSource( isColor ),
+        m_firstFrameInFile( 0 ),
+        m_fileSize( 0 ),
+        m_viewAlignment( RAW_FRAME_FILE_PAGE_SIZE ),
+        m_pView( NULL ),
+        m_viewSize( 0 ),
+        m_currentFrame( ),
+        m_currentFrameIndex( -1 )
+    {
+        try
+        {
+            ASSERT_TRUE( endFrameIndex >= startFrameIndex );
+
+#if defined(WIN32) || defined(WIN64)
+            m_fileHandle = CreateFileA( rawFrameFileName.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL );
+            if ( m_fileHandle == INVALID_HANDLE_VALUE )
+            {
+                abortError( __LINE__, __FILE__, "Error opening raw frame file, run with Convert_Input_To_Raw_Frames = 1 first" );
+            }
+
+            LARGE_INTEGER fileSize;
+            GetFileSizeEx( m_fileHandle, &fileSize );
+            m_fileSize = (unsigned long long)fileSize.QuadPart;
+
+            //copy-on-write views need a write-copy mapping
+            m_mappingHandle = CreateFileMapping( m_fileHandle, NULL, PAGE_WRITECOPY, 0, 0, NULL );
+            ASSERT_TRUE( m_mappingHandle != NULL );
+
+            SYSTEM_INFO systemInfo;
+            GetSystemInfo( &systemInfo );
+            m_viewAlignment = systemInfo.dwAllocationGranularity;
+#else
+            m_fileDescriptor = open( rawFrameFileName.c_str(), O_RDONLY );
+            if ( m_fileDescriptor < 0 )
+            {
+                abortError( __LINE__, __FILE__, "Error opening raw frame file, run with Convert_Input_To_Raw_Frames = 1 first" );
+            }
+
+            struct stat fileStatus;
+            ASSERT_TRUE( fstat( m_fileDescriptor, &fileStatus ) == 0 );
+            m_fileSize = (unsigned long long)fileStatus.st_size;
+
+            m_viewAlignment = (size_t)sysconf( _SC_PAGESIZE );
+#endif
+            //validate the header
+            ASSERT_TRUE( m_fileSize >= RAW_FRAME_FILE_PAGE_SIZE );
+            memcpy( &m_header, MapView( 0, sizeof(m_header) ), sizeof(m_header) );
+            UnmapView( );
+
+            if ( memcmp( m_header.m_magic, RAW_FRAME_FILE_MAGIC, sizeof(m_header.m_magic) ) != 0 )
+            {
+                abortError( __LINE__, __FILE__, "Not a raw frame file" );
+            }
+
+            if ( m_header.m_channels != ( isColor ? 3 : 1 ) )
+            {
+                abortError( __LINE__, __FILE__, "Raw frame file color mode does not match Load_Video_With_Color, convert the input again" );
+            }
+
+            m_firstFrameInFile = startFrameIndex - (int)m_header.m_startFrameIndex;
+            if ( m_firstFrameInFile < 0 || endFrameIndex >= (int)( m_header.m_startFrameIndex + m_header.m_frameCount ) )
+            {
+                abortError( __LINE__, __FILE__, "Raw frame file does not hold the requested frames, convert the input again" );
+            }
+
+            ASSERT_TRUE( m_header.m_frameStride == RawFrameFile::GetFrameStride( m_header.m_width, m_header.m_height, m_header.m_channels ) );
+            ASSERT_TRUE( m_fileSize >= RAW_FRAME_FILE_PAGE_SIZE + (unsigned long long)m_header.m_frameStride * m_header.m_frameCount );
+
+            m_numberOfFrames    = endFrameIndex - startFrameIndex + 1;
+            m_frameWidth        = m_header.m_width;
+            m_frameHeight        = m_header.m_height;
+        }
+        EXCEPTION_CATCH_AND_ABORT( "Failed to construct MappedFrameSource" );
+    }
+
+    /********************************************************************
+    ~MappedFrameSource
+        Destructor. Unmaps and closes the raw frame file.
+    Exceptions:
+        None
+    *********************************************************************/
+    MappedFrameSource::~MappedFrameSource( )
+    {
+        m_currentFrame.Free( );
+        UnmapView( );
+
+#if defined(WIN32) || defined(WIN64)
+        CloseHandle( m_mappingHandle );
+        CloseHandle( m_fileHandle );
+#else
+        close( m_fileDescriptor );
+#endif
+    }
+
+    /********************************************************************
+    GetFrame
+        Get the frame at the given index. The frame wraps the mapped
+        pages of the file; nothing is copied.
+    Exceptions:
+        None
+    *********************************************************************/
+    Matrixu* MappedFrameSource::GetFrame( const int frameInd )
+    {
+        ASSERT_TRUE( frameInd >= 0 && frameInd < m_numberOfFrames );
+
+        if ( frameInd == m_currentFrameIndex )
+        {
+            return &m_currentFrame;
+        }
+
+        //the frame does not own the mapped pages: Wrap rebinds it to the new ones and keeps its integral buffers
+        UnmapView( );
+
+        const size_t        planeSize    = (size_t)m_header.m_width * m_header.m_height;
+        unsigned char*        pFrameData    = MapView( RAW_FRAME_FILE_PAGE_SIZE + (unsigned long long)( m_firstFrameInFile + frameInd ) * m_header.m_frameStride,
+                                               planeSize * m_header.m_channels );
+
+        vector<void*> planes( m_header.m_channels );
+        for ( int channel = 0; channel < (int)m_header.m_channels; channel++ )
+        {
+            planes[channel] = pFrameData + channel * planeSize;
+        }
+
+        m_currentFrame.Wrap( m_header.m_height, m_header.m_width, planes, m_header.m_width );
+        m_currentFrameIndex = frameInd;
+
+        return &m_currentFrame;
+    }
+
+    /********************************************************************
+    MapView
+        Map the given range of the file copy-on-write. The view starts
+        at the closest aligned offset below the requested one.
+    Exceptions:
+        None
+    *********************************************************************/
+    unsigned char* MappedFrameSource::MapView( const unsigned long long offset, const size_t size )
+    {
+        ASSERT_TRUE( m_pView == NULL );
+        ASSERT_TRUE( offset + size <= m_fileSize );
+
+        const unsigned long long viewOffset = offset - offset % m_viewAlignment;
+        m_viewSize = (size_t)( offset - viewOffset ) + size;
+
+#if defined(WIN32) || defined(WIN64)
+        m_pView = (unsigned char*)MapViewOfFile( m_mappingHandle,
+                                                 FILE_MAP_COPY,
+                                                 (DWORD)( viewOffset >> 32 ),
+                                                 (DWORD)( viewOffset & 0xFFFFFFFF ),
+                                                 m_viewSize );
+#else
+        void* pMapping = mmap( NULL, m_viewSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, m_fileDescriptor, (off_t)viewOffset );
+        m_pView = ( pMapping == MAP_FAILED ) ? NULL : (unsigned char*)pMapping;
+
+        if ( m_pView != NULL )
+        {
+            madvise( pMapping, m_viewSize, MADV_WILLNEED );
+        }
+#endif
+        if ( m_pView == NULL )
+        {
+            abortError( __LINE__, __FILE__, "Error mapping raw frame file" );
+        }
+
+        return m_pView + ( offset - viewOffset );
+    }
+
+    /********************************************************************
+    UnmapView
+        Unmap the view mapped by MapView, dropping any private copies
+        of its pages.
+    Exceptions:
+        None
+    *********************************************************************/
+    void MappedFrameSource::UnmapView( )
+    {
+        if ( m_pView == NULL )
+        {
+            return;
+        }
+
+#if defined(WIN32) || defined(WIN64)
+        UnmapViewOfFile( m_pView );
+#else
+        munmap( m_pView, m_viewSize );
+#endif
+        m_pView        = NULL;
+        m_viewSize    = 0;
+    }
+}
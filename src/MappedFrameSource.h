@@ -0,0 +1,65 @@
+#ifndef MAPPED_FRAME_SOURCE_HEADER
+#define MAPPED_FRAME_SOURCE_HEADER
+
+#include "FrameSource.h"
+#include "RawFrameFile.h"
+#include "CommonMacros.h"
+
+#if defined(WIN32) || defined(WIN64)
+#include <windows.h>
+#endif
+
+namespace MultipleCameraTracking
+{
+    /****************************************************************
+    MappedFrameSource
+        Derives from FrameSource.
+        Memory maps a raw frame file written by RawFrameFile, so no
+        decoding is needed at all. The returned frame wraps the mapped
+        pages of the frame without copying them; the pages are shared
+        through the OS page cache between concurrent runs on the same
+        dataset. Each frame is mapped copy-on-write, so modifying the
+        frame never touches the file, and the private copies are
+        dropped when the next frame is mapped.
+    ****************************************************************/
+    class MappedFrameSource : public FrameSource
+    {
+    public:
+        MappedFrameSource( const string&    rawFrameFileName,
+                           const int        startFrameIndex,
+                           const int        endFrameIndex,
+                           const bool        isColor );
+
+        virtual ~MappedFrameSource( );
+
+        virtual Matrixu*    GetFrame( const int frameInd );
+
+    private:
+        DISALLOW_IMPLICIT_CONSTRUCTORS( MappedFrameSource );
+
+        //map the given range of the file, returns its first byte
+        unsigned char*            MapView( const unsigned long long offset, const size_t size );
+
+        //unmap the range mapped by MapView
+        void                    UnmapView( );
+
+        RawFrameFileHeader        m_header;                //header of the mapped file
+        int                        m_firstFrameInFile;        //position of frame 0 inside the file
+        unsigned long long        m_fileSize;                //size of the file in bytes
+        size_t                    m_viewAlignment;        //offsets of mapped views must be multiples of it
+
+        unsigned char*            m_pView;                //currently mapped view (NULL: none)
+        size_t                    m_viewSize;                //size of the mapped view in bytes
+
+        Matrixu                    m_currentFrame;            //frame handed out by GetFrame, wraps the mapped view
+        int                        m_currentFrameIndex;    //index of m_currentFrame (-1: none)
+
+#if defined(WIN32) || defined(WIN64)
+        HANDLE                    m_fileHandle;
+        HANDLE                    m_mappingHandle;
+#else
+        int                        m_fileDescriptor;
+#endif
+    };
+}
+#endif
@@ -3,10 +3,20 @@
 // (see the included gpl.txt and lgpl.txt files).  Use at own risk.  Please send me your feedback/suggestions/bugs.
 
 #include "Matrix.h"
+#include "Visualizer.h"
 
-template<> float                Matrixu::ii ( const int row, const int col, const int depth ) const
+#include <boost/thread.hpp>
+#include <boost/atomic.hpp>
+#include <boost/bind.hpp>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define MATRIX_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+template<> IntegralType            Matrixu::ii ( const int row, const int col, const int depth ) const
 {
-    return (float) ((Ipp32f*)_iidata[depth])[row*_iipixStep + col];
+    return _iidata[depth][row*_iipixStep + col];
 }
 template<> float                Matrixu::dii_dx(uint x, uint y, uint channel)
 {
@@ -15,7 +25,7 @@ template<> float                Matrixu::dii_dx(uint x, uint y, uint channel)
     if( (x+1) > (uint)cols() || x < 1 ) return 0.0f;
     //0.5*(GET3(ii,y,(x+1),bin,rows,cols) - GET3(ii,y,(x-1),bin,rows,cols));
 
-    return 0.5f * ( ii(y,(x+1),channel) - ii(y,(x-1),channel) );
+    return 0.5f * (float)( ii(y,(x+1),channel) - ii(y,(x-1),channel) );
 }
 
 template<> float                Matrixu::dii_dy(uint x, uint y, uint channel)
@@ -25,24 +35,72 @@ template<> float                Matrixu::dii_dy(uint x, uint y, uint channel)
     if( (y+1) > (uint)rows() || y < 1 ) return 0.0f;
     //0.5*(GET3(ii,y,(x+1),bin,rows,cols) - GET3(ii,y,(x-1),bin,rows,cols));
 
-    return 0.5f * ( ii((y+1),x,channel) - ii((y-1),x,channel) );
+    return 0.5f * (float)( ii((y+1),x,channel) - ii((y-1),x,channel) );
 }
 //////////////////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-template<> void                    Matrixu::initII()
+// One row of an integral image: iiRow[c+1] = iiPrev[c+1] + src[0] + ... + src[c] for c < width.
+// iiPrev is the row above (NULL for the first row of a region); iiRow[0] is left to the caller.
+// The prefix sum of the row and the accumulation of the row above are fused: with SSE2, four pixels
+// are widened, prefix summed in register by two shifted adds and added to the row above at once.
+static void                        integrateRow(const Ipp8u *src, IntegralType *iiRow, const IntegralType *iiPrev, int width)
+{
+    int col = 0;
+    unsigned int rowSum = 0; // a row of 8-bit pixels can not overflow 32 bits
+#ifdef MATRIX_USE_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    __m128i carry = zero;
+    for( ; col+4<=width; col+=4 ){
+        int pixels;
+        memcpy(&pixels, src+col, sizeof(pixels));
+        __m128i x = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(pixels), zero), zero);
+        x = _mm_add_epi32(x, _mm_slli_si128(x, 4));
+        x = _mm_add_epi32(x, _mm_slli_si128(x, 8));
+        x = _mm_add_epi32(x, carry);
+        carry = _mm_shuffle_epi32(x, 0xFF);
+#ifdef INTEGRAL_IMAGE_64BIT
+        __m128i lo = _mm_unpacklo_epi32(x, zero);
+        __m128i hi = _mm_unpackhi_epi32(x, zero);
+        if( iiPrev != NULL ){
+            lo = _mm_add_epi64(lo, _mm_loadu_si128((const __m128i*)(iiPrev+col+1)));
+            hi = _mm_add_epi64(hi, _mm_loadu_si128((const __m128i*)(iiPrev+col+3)));
+        }
+        _mm_storeu_si128((__m128i*)(iiRow+col+1), lo);
+        _mm_storeu_si128((__m128i*)(iiRow+col+3), hi);
+#else
+        if( iiPrev != NULL )
+            x = _mm_add_epi32(x, _mm_loadu_si128((const __m128i*)(iiPrev+col+1)));
+        _mm_storeu_si128((__m128i*)(iiRow+col+1), x);
+#endif
+    }
+    rowSum = (unsigned int)_mm_cvtsi128_si32(carry);
+#endif
+    for( ; col<width; col++ ){
+        rowSum += src[col];
+        iiRow[col+1] = iiPrev != NULL ? iiPrev[col+1] + rowSum : (IntegralType)rowSum;
+    }
+}
+
+// Integral image of one region of a plane, written at the same position in the integral plane
+// (as ippiIntegral on the sub-image): the row above and the column left of the region are zero.
+static void                        integrateRegion(const Ipp8u *src, int srcStep, IntegralType *ii, int iiPixStep, const IppiRect &region)
 {
-    bool err=false;
-    _iidata.resize(_depth);
-    for( uint k=0; k<_data.size(); k++ ){
-        if( _iidata[k] == NULL )
-            _iidata[k] = ippiMalloc_32f_C1(_cols+1,_rows+1,&(_iidataStep));
-        if( _iidata[k] == NULL ) abortError(__LINE__,__FILE__,"OUT OF MEMORY!");
-        _iipixStep = _iidataStep/sizeof(Ipp32f);
-        IppStatus is = ippiIntegral_8u32f_C1R((Ipp8u*)_data[k], _dataStep, (Ipp32f*)_iidata[k], _iidataStep, _roi, 0);
-        assert( is == ippStsNoErr );
-        err = err || _data[k] == NULL;
+    IntegralType *iiRow = ii + region.y*iiPixStep + region.x;
+    memset(iiRow, 0, (region.width+1)*sizeof(IntegralType));
+    for( int row=0; row<region.height; row++ ){
+        const IntegralType *iiPrev = row == 0 ? NULL : iiRow;
+        iiRow += iiPixStep;
+        iiRow[0] = 0;
+        integrateRow(src + (region.y+row)*srcStep + region.x, iiRow, iiPrev, region.width);
     }
+}
+
+template<> void                    Matrixu::initII()
+{
+    reserveII(_depth);
+    for( uint k=0; k<_data.size(); k++ )
+        integrateRegion((Ipp8u*)_data[k], _dataStep, _iidata[k], _iipixStep, _roirect);
     _ii_init = true;
 }
 
@@ -56,12 +114,14 @@ template<> float                Matrixu::sumRect(const IppiRect &rect, int chann
     int maxx = rect.x+rect.width;
     int y = rect.y*_iipixStep;
 
-    float tl = ((Ipp32f*)_iidata[channel])[y + rect.x];
-    float tr = ((Ipp32f*)_iidata[channel])[y + maxx];
-    float br = ((Ipp32f*)_iidata[channel])[maxy + maxx];
-    float bl = ((Ipp32f*)_iidata[channel])[maxy + rect.x];
+    const IntegralType *ii = _iidata[channel];
+    const IntegralType tl = ii[y + rect.x];
+    const IntegralType tr = ii[y + maxx];
+    const IntegralType br = ii[maxy + maxx];
+    const IntegralType bl = ii[maxy + rect.x];
 
-    return br + tl - tr - bl;
+    // exact in the integer type, even if the running sums wrapped around
+    return (float)(IntegralType)(br + tl - tr - bl);
     //return ii(maxy,maxx,channel) + ii(rect.y,rect.x,channel)
     //    - ii(rect.y,maxx,channel) - ii(maxy,rect.x,channel);
 }
@@ -102,12 +162,12 @@ template<> void                    Matrixu::IplImage2Matrix(IplImage *img)
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////////////////////
-template<> void                    Matrixu::LoadImage(const char *filename, bool color)
+template<> bool                    Matrixu::ReadImage(const char *filename, bool color)
 {
     IplImage *img;
     img = cvLoadImage(filename,(int)color);
     if( img == NULL )
-        abortError(__LINE__,__FILE__,"Error loading file");
+        return false;
     Resize(img->height, img->width, img->nChannels);
 
     if( color )
@@ -120,23 +180,89 @@ template<> void                    Matrixu::LoadImage(const char *filename, bool
 
     }
     cvReleaseImage(&img);
+    return true;
+}
+
+// decodes the frames of an image sequence on a pool of threads, each frame straight into its own slot
+struct ImageSequenceDecoder
+{
+    ImageSequenceDecoder(const char *format, int start, bool color, vector<Matrixu> &frames)
+        : _format(format), _start(start), _color(color), _frames(frames), _nextFrame(0), _failedFrame((int)frames.size()) {}
+
+    // body of a worker: takes the next frame to decode until there is none left
+    void Decode()
+    {
+        const int numFrames = (int)_frames.size();
+        for( int k=_nextFrame++; k<numFrames; k=_nextFrame++ ){
+            char fname[1024];
+            sprintf_s(fname,_format,_start+k);
+            if( !_frames[k].ReadImage(fname, _color) ){
+                boost::lock_guard<boost::mutex> lock(_mutex);
+                _failedFrame = min(_failedFrame, k);
+            }
+        }
+    }
+
+    const char*            _format;
+    const int            _start;
+    const bool            _color;
+    vector<Matrixu>&    _frames;
+    boost::atomic<int>    _nextFrame;
+    boost::mutex        _mutex;            // guards _failedFrame
+    int                    _failedFrame;    // first frame that failed to load (number of frames: none)
+};
+
+template<> vector<Matrixu>        Matrixu::LoadVideo(const char *dirname, const char *basename, const char *ext, int start, int end, int digits, bool color)
+{
+    // frames are decoded by one thread per core; abortError must not be called from the workers
+    const int numFrames = end-start+1;
+    vector<Matrixu> res(numFrames);
+
+    char format[1024];
+    sprintf_s(format,"%s/%s%%0%ii.%s",dirname,basename,digits,ext);
+
+    ImageSequenceDecoder decoder(format, start, color, res);
+    const int numThreads = max(1, min(numFrames, (int)boost::thread::hardware_concurrency()));
+    boost::thread_group workers;
+    for( int k=0; k<numThreads; k++ )
+        workers.create_thread(boost::bind(&ImageSequenceDecoder::Decode, &decoder));
+    workers.join_all();
+
+    if( decoder._failedFrame < numFrames ){
+        char fname[1024];
+        sprintf_s(fname,format,start+decoder._failedFrame);
+        fprintf(stderr, "Error loading file %s\n", fname);
+        abortError(__LINE__,__FILE__,"Error loading file");
+    }
+
+    return res;
+}
+
+template<> void                    Matrixu::LoadImage(const char *filename, bool color)
+{
+    if( !ReadImage(filename, color) )
+        abortError(__LINE__,__FILE__,"Error loading file");
 }
 
 template<> void                    Matrixu::createIpl(bool force)
 {
     if( _iplimg != NULL && !force) return;
-    if( _iplimg != NULL ) cvReleaseImage(&_iplimg);
+    // a forced refresh reuses the existing image when the size did not change
+    if( _iplimg != NULL && (_iplimg->width != _cols || _iplimg->height != _rows) ) cvReleaseImage(&_iplimg);
     CvSize sz; sz.width = _cols; sz.height = _rows;
 
     int depth = 3;
-    _iplimg = cvCreateImageHeader( sz, IPL_DEPTH_8U, depth );
-
-    //_iplimg->align = 32;
-    //_iplimg->widthStep = (((_iplimg->width * _iplimg->nChannels *
-    //     (_iplimg->depth & ~IPL_DEPTH_SIGN) + 7)/8)+ _iplimg->align - 1) & (~(_iplimg->align - 1));
-    //_iplimg->widthStep = _dataStep*depth;
-    //_iplimg->imageSize = _iplimg->height*_iplimg->widthStep;
-    cvCreateData(_iplimg);
+    if( _iplimg == NULL ){
+        _iplimg = cvCreateImageHeader( sz, IPL_DEPTH_8U, depth );
+
+        //_iplimg->align = 32;
+        //_iplimg->widthStep = (((_iplimg->width * _iplimg->nChannels *
+        //     (_iplimg->depth & ~IPL_DEPTH_SIGN) + 7)/8)+ _iplimg->align - 1) & (~(_iplimg->align - 1));
+        //_iplimg->widthStep = _dataStep*depth;
+        //_iplimg->imageSize = _iplimg->height*_iplimg->widthStep;
+        cvCreateData(_iplimg);
+    }
+    _iplimg->origin = 0; // WriteFrame may have flipped a kept image
 
     //cvInitImageHeader( _iplimg, sz, IPL_DEPTH_8U, _depth, IPL_ORIGIN_TL, 16 );
     //IplImage *_iplimg = cvCreateImage( sz, IPL_DEPTH_8U, _depth );
@@ -176,6 +302,20 @@ template<> void                    Matrixu::SaveImage(const char *filename)
     freeIpl();
 }
 
+template<> void                    Matrixu::CaptureMat2Matrix(const cv::Mat &frame)
+{
+    // the planes are exported as cv::Mat headers, so OpenCV writes into them without an intermediate image
+    if( _depth == 3 ){
+        cv::Mat planes[3] = { getPlaneMat(0), getPlaneMat(1), getPlaneMat(2) };
+        const int fromTo[] = { 2,0, 1,1, 0,2 }; // BGR -> RGB planes
+        cv::mixChannels(&frame, 1, planes, 3, fromTo, 3);
+    }
+    else{
+        cv::Mat plane = getPlaneMat(0);
+        cv::cvtColor(frame, plane, CV_RGB2GRAY);
+    }
+}
+
 template<> void                    Matrixu::GrayIplImage2Matrix(IplImage *img)
 {
     //Resize(img->height, img->width, img->nChannels);
@@ -225,29 +365,21 @@ template<> bool                    Matrixu::WriteFrame(CvVideoWriter* w, Matrixu
 }
 
 
-template<> void                    Matrixu::display(int fignum, float p)
+template<> void                    Matrixu::display(const char* figName, float p)
 {
-    assert(size() > 0);
+    assert( figName!=NULL );
     createIpl();
-    char name[1024];
-    sprintf_s(name,"Figure %d",fignum);
-    cvNamedWindow( name, 0/*CV_WINDOW_AUTOSIZE*/ );
-    cvShowImage( name, _iplimg );
-    //cvResizeWindow( name, max((int)(_cols*p),200), (int)max((int)(_rows*p),_rows*(200.0f/_cols)) );
-    cvResizeWindow( name, max((int)(_cols*p),(int)200), (int)max((int)(_rows*p),(int)(_rows*(200.0f/_cols))) );//[Zefeng Ni] for gcc compatibility
-    //cvWaitKey(0);//DEBUG
+    // the window is shown (and its events pumped) by the visualization thread
+    Visualizer::GetInstance().Show( figName, _iplimg, p );
     freeIpl();
 }
 
-template<> void                    Matrixu::display(const char* figName, float p)
+template<> void                    Matrixu::display(int fignum, float p)
 {
-    assert( figName!=NULL );
-    createIpl();
-    cvNamedWindow( figName, 0/*CV_WINDOW_AUTOSIZE*/ );
-    cvShowImage( figName, _iplimg );
-    cvResizeWindow( figName, max((int)(_cols*p),(int)200), (int)max((int)(_rows*p),(int)(_rows*(200.0f/_cols))) );//[Zefeng Ni] for gcc compatibility
-    //cvWaitKey(0);//DEBUG
-    freeIpl();
+    assert(size() > 0);
+    char name[1024];
+    sprintf_s(name,"Figure %d",fignum);
+    display(name, p);
 }
 
 template<> void                    Matrixu::PlayCam(int color, const char* fname)
@@ -273,7 +405,7 @@ template<> void                    Matrixu::PlayCam(int color, const char* fname
 
         // output (both screen and possibly to file)
         frame._keepIpl=true;
-        frame.display(1); char q = cvWaitKey(1);
+        frame.display(1); char q = Visualizer::GetInstance().WaitKey(1);
         WriteFrame(w, frame);
         frame._keepIpl=false; frame.freeIpl();
 
@@ -291,6 +423,14 @@ template<> void                    Matrixu::PlayCam(int color, const char* fname
 
 }
 
+template<> void                    Matrixu::PlayVideo( vector<Matrixu> &vid, int wait )
+{
+    for( uint k=0; k<vid.size(); k++ ){
+        vid[k].display(1);
+        Visualizer::GetInstance().WaitKey(wait);
+    }
+}
+
 template<> void                    Matrixu::PlayCamOpenCV()
 {
     CvCapture* capture = cvCaptureFromCAM( -1 );
@@ -299,17 +439,16 @@ template<> void                    Matrixu::PlayCamOpenCV()
 
     cout << "Press q to quit" << endl;
     IplImage *img;
-    cvNamedWindow( "Cam", 0/*CV_WINDOW_AUTOSIZE*/ );
 
     StopWatch sw(true);
     double ttime=0.0;
     for( int cnt=0; true; cnt++ )
     {
         img = cvQueryFrame( capture );
-        cvShowImage( "Cam", img );
+        Visualizer::GetInstance().Show( "Cam", img, 1.0f );
         ttime = sw.Elapsed(true);
         fprintf(stderr,"%s%d Frames/%f sec = %f FPS",ERASELINE,cnt,ttime,((double)cnt)/ttime);
-        char q = cvWaitKey(1);
+        char q = Visualizer::GetInstance().WaitKey(1);
         if( q=='q' ) break;
     }
 
@@ -428,11 +567,11 @@ template<> void                    Matrixu::warp(Matrixu &res,uint rows, uint co
     r.width = cols;
     r.height = rows;
 
-    IppStatus ii = ippiGetAffineTransform(r, quad, coeffs);
+    MatrixBackend::GetAffineTransform(r, quad, coeffs);
 
     //#pragma omp parallel for
     for( int k=0; k<_depth; k++ )
-        ippiWarpAffine_8u_C1R((Ipp8u*)_data[k],_roi, _dataStep, _roirect, (Ipp8u*)res._data[k],res._dataStep, res._roirect, coeffs, IPPI_INTER_LINEAR);
+        MatrixBackend::WarpAffine_8u((Ipp8u*)_data[k],_roi, _dataStep, (Ipp8u*)res._data[k],res._dataStep, res._roi, coeffs);
 
 }
 
@@ -446,14 +585,12 @@ template<> void                    Matrixu::warpAll(uint rows, uint cols, vector
 }
 template<> void                    Matrixu::computeGradChannels()
 {
-    Ipp32s kernel[3] = {-1, 0, 1};
-
     IppiSize r = _roi;
     r.width-=3;
     r.height-=3;
 
-    ippiFilterRow_8u_C1R((Ipp8u*)_data[0], _dataStep, (Ipp8u*)_data[_depth-2], _dataStep, r, kernel, 3, 2, -1);
-    ippiFilterColumn_8u_C1R((Ipp8u*)_data[0], _dataStep, (Ipp8u*)_data[_depth-1], _dataStep, r, kernel, 3, 2, -1);
+    MatrixBackend::FilterRowGradient_8u((Ipp8u*)_data[0], _dataStep, (Ipp8u*)_data[_depth-2], _dataStep, r);
+    MatrixBackend::FilterColumnGradient_8u((Ipp8u*)_data[0], _dataStep, (Ipp8u*)_data[_depth-1], _dataStep, r);
 }
 
 template<> Matrixu                Matrixu::imResize(float r, float c)
@@ -470,27 +607,23 @@ template<> Matrixu                Matrixu::imResize(float r, float c)
     }
 
     Matrixu res((int)(nr), (int)(nc), _depth);
-    IppStatus ippst;
-    int bufSize;
-#ifdef IPP_61
     for( int k=0; k<_depth; k++ )
-        ippst = ippiResize_8u_C1R((Ipp8u*)_data[k],_roi, _dataStep, _roirect, (Ipp8u*)res._data[k], res._dataStep, res._roi, pc, pr, IPPI_INTER_LINEAR);
-#else
-    Ipp8u* pBuffer = NULL;
-    ippiResizeGetBufSize(_roirect, res._roirect, 1, IPPI_INTER_LINEAR, &bufSize);
-    
-    for( int k=0; k<_depth; k++ )
-        ippiResizeSqrPixel_8u_C1R((Ipp8u*)_data[k], _roi, _dataStep,
-                          _roirect, (Ipp8u*)res._data[k], res._dataStep, res._roirect,
-                          pc, pr, 0.0, 0.0, IPPI_INTER_LINEAR,
-                          pBuffer);
-    
-    ippsFree(pBuffer);
-#endif
+        MatrixBackend::Resize_8u((Ipp8u*)_data[k], _roi, _dataStep, (Ipp8u*)res._data[k], res._dataStep, res._roi, pc, pr);
 
     return res;
 }
 
+template<> void                    Matrixu::imResizeBox(Matrixu &res, uint rows, uint cols)
+{
+    // each output pixel averages the input pixels it covers, so downsampling does not alias
+    res.Resize(rows, cols, _depth);
+    for( int k=0; k<_depth; k++ ){
+        cv::Mat src = getPlaneMat(k);
+        cv::Mat dst = res.getPlaneMat(k);
+        cv::resize(src, dst, cv::Size(cols, rows), 0, 0, cv::INTER_AREA);
+    }
+}
+
 template<> void                    Matrixu::SaveImages(std::vector<Matrixu> imgs, const char *dirname, float resize)
 {
     char fname[1024];
@@ -508,75 +641,205 @@ template<> void                    Matrixu::SaveImages(std::vector<Matrixu> imgs
 template<> void                    Matrixu::conv2RGB(Matrixu &res)
 {
     res.Resize(_rows,_cols,3);
-    for( int k=0; k<_rows*_dataStep; k++ )
-    {
-        ((Ipp8u*)res._data[0])[k] = ((Ipp8u*)_data[0])[k];
-        ((Ipp8u*)res._data[1])[k] = ((Ipp8u*)_data[0])[k];
-        ((Ipp8u*)res._data[2])[k] = ((Ipp8u*)_data[0])[k];
-    }
+    // steps may differ when either matrix wraps external planes
+    for( int k=0; k<3; k++ )
+        MatrixBackend::Copy_8u((Ipp8u*)_data[0], _dataStep, (Ipp8u*)res._data[k], res._dataStep, _roi );
 }
-template<> void                    Matrixu::conv2HSV(Matrixu &res)
+// fixed point tables of OpenCV's 8 bit RGB->HSV conversion, so the results match cvCvtColor(CV_BGR2HSV)
+#define HSV_SHIFT    12
+// built at static initialization, before any thread can convert
+struct HSVTables
 {
-    res.Resize(_rows,_cols,3);
-    if( res.isInitII() )
+    int        satDiv[256];
+    int        hueDiv[256];
+
+    HSVTables()
     {
-        res.FreeII();
+        satDiv[0] = hueDiv[0] = 0;
+        for( int i=1; i<256; i++ ){
+            satDiv[i] = (int)floor((255 << HSV_SHIFT)/(1.0*i) + 0.5);
+            hueDiv[i] = (int)floor((180 << HSV_SHIFT)/(6.0*i) + 0.5);
+        }
     }
-    
-    CvSize sz; sz.width = _cols; sz.height = _rows;
+};
+static const HSVTables    s_hsvTables;
 
-    IplImage* pImgHSV = cvCreateImage( sz, IPL_DEPTH_8U, 3);
-    createIpl();
-    cvCvtColor(_iplimg, pImgHSV, CV_BGR2HSV);
-    
-    bool origin = pImgHSV->origin==1;
+// Clips the regions to the image and merges the ones that overlap or touch, so every pixel and every
+// integral image entry belongs to at most one region. The integral image of a region is local to it
+// (zero on its top row and left column), which still gives exact sums for rectangles inside the region.
+static vector<IppiRect>    mergeRegions(const vector<IppiRect> &regions, int rows, int cols)
+{
+    vector<IppiRect> merged;
+    for( uint k=0; k<regions.size(); k++ ){
+        IppiRect r;
+        r.x = max(0, regions[k].x);
+        r.y = max(0, regions[k].y);
+        r.width = min(cols, regions[k].x + regions[k].width) - r.x;
+        r.height = min(rows, regions[k].y + regions[k].height) - r.y;
+        if( r.width > 0 && r.height > 0 )
+            merged.push_back(r);
+    }
 
-    #pragma omp parallel for
-    for( int row=0; row<_rows; row++ )
-        for( int k=0; k<_cols*3; k+=3 ){
-            if( origin ){
-                ((Ipp8u*)_data[0])[(_rows - row - 1)*_dataStep+k/3] = pImgHSV->imageData[row*pImgHSV->widthStep+k];
-                ((Ipp8u*)_data[1])[(_rows - row - 1)*_dataStep+k/3] = pImgHSV->imageData[row*pImgHSV->widthStep+k+1];
-                ((Ipp8u*)_data[2])[(_rows - row - 1)*_dataStep+k/3] = pImgHSV->imageData[row*pImgHSV->widthStep+k+2];
-            }
-            else{
-                ((Ipp8u*)_data[0])[row*_dataStep+k/3] = pImgHSV->imageData[row*pImgHSV->widthStep+k];
-                ((Ipp8u*)_data[1])[row*_dataStep+k/3] = pImgHSV->imageData[row*pImgHSV->widthStep+k+1];
-                ((Ipp8u*)_data[2])[row*_dataStep+k/3] = pImgHSV->imageData[row*pImgHSV->widthStep+k+2];
+    bool changed = true;
+    while( changed ){
+        changed = false;
+        for( uint i=0; i<merged.size() && !changed; i++ )
+            for( uint j=i+1; j<merged.size() && !changed; j++ ){
+                const IppiRect &a = merged[i], &b = merged[j];
+                // touching regions would share a row or column of the integral image
+                if( a.x <= b.x+b.width && b.x <= a.x+a.width && a.y <= b.y+b.height && b.y <= a.y+a.height ){
+                    IppiRect u;
+                    u.x = min(a.x, b.x);
+                    u.y = min(a.y, b.y);
+                    u.width = max(a.x+a.width, b.x+b.width) - u.x;
+                    u.height = max(a.y+a.height, b.y+b.height) - u.y;
+                    merged[i] = u;
+                    merged.erase(merged.begin()+j);
+                    changed = true;
+                }
             }
-        }
-    cvReleaseImage(& pImgHSV);
-    freeIpl();
+    }
+    return merged;
 }
 
-template<> void                    Matrixu::conv2BW(Matrixu &res)
+template<> void                    Matrixu::initII(const vector<IppiRect> &regions)
 {
-    res.Resize(_rows,_cols,1);
+    // the whole integral buffer is kept, but only the (dirty) regions are integrated; the rest is stale
+    reserveII(_depth);
+    const vector<IppiRect> merged = mergeRegions(regions, _rows, _cols);
+    for( uint k=0; k<_data.size(); k++ )
+        for( uint r=0; r<merged.size(); r++ )
+            integrateRegion((Ipp8u*)_data[k], _dataStep, _iidata[k], _iipixStep, merged[r]);
+    _ii_init = true;
+}
 
-    if( res.isInitII() )
-    {
-        res.FreeII();
+template<> void                    Matrixu::conv2BWHSV(Matrixu *bw, Matrixu *hsv, bool initBWII, const vector<IppiRect> *regions)
+{
+    // Replaces the separate createIpl/cvCvtColor/copy-back passes of conv2BW and conv2HSV and the
+    // following initII with a single sweep: every row is converted and integrated while it is in cache.
+    // Rows are processed in bands in parallel; the integral image of a band is accumulated locally and
+    // the sums of the bands above are added afterwards.
+    // When regions are given, only the pixels inside them are converted (see mergeRegions).
+    assert( _depth == 3 );
+    const int bandRows = 64;
+
+    if( bw != NULL ){
+        bw->Resize(_rows,_cols,1);
+        if( initBWII ){
+            // the integral buffer of the previous frame is rebuilt in place when the size did not change
+            bw->reserveII(1);
+            bw->_ii_init = true;
+        }
+        else
+            bw->InvalidateII();
     }
-    /*
-    double t;
-    for( int k=0; k<(int)size(); k++ )
-    {
-        t = (double) ((Ipp8u*)_data[0])[k];
-        t+= (double) ((Ipp8u*)_data[1])[k];
-        t+= (double) ((Ipp8u*)_data[2])[k];
-        ((Ipp8u*)res._data[0])[k] = (Ipp8u) (t/3.0);
+    if( hsv != NULL ){
+        hsv->Resize(_rows,_cols,3);
+        hsv->InvalidateII();
     }
 
-    if( res._keepIpl ) res.freeIpl();*/
+    vector<IppiRect> merged;
+    if( regions != NULL )
+        merged = mergeRegions(*regions, _rows, _cols);
+    else
+        merged.push_back(_roirect);
 
-    CvSize sz; sz.width = _cols; sz.height = _rows;
+    const bool computeII = bw != NULL && initBWII;
 
-    IplImage* pImgBW = cvCreateImage( sz, IPL_DEPTH_8U, 1);
-    createIpl();
-    cvCvtColor(_iplimg,pImgBW,CV_BGR2GRAY);
-    res.GrayIplImage2Matrix(pImgBW);
-    cvReleaseImage(& pImgBW);
-    freeIpl();
+    for( uint region=0; region<merged.size(); region++ ){
+        const int colBegin = merged[region].x;
+        const int colEnd = merged[region].x + merged[region].width;
+        const int rowBegin = merged[region].y;
+        const int rowEnd = merged[region].y + merged[region].height;
+        const int numBands = (merged[region].height + bandRows - 1)/bandRows;
+
+        if( computeII )
+            memset(bw->_iidata[0] + rowBegin*bw->_iipixStep + colBegin, 0, (colEnd-colBegin+1)*sizeof(IntegralType));
+
+        #pragma omp parallel for
+        for( int band=0; band<numBands; band++ ){
+            const int bandBegin = rowBegin + band*bandRows;
+            const int bandEnd = min(rowEnd, bandBegin + bandRows);
+            for( int row=bandBegin; row<bandEnd; row++ ){
+                const Ipp8u *r = &(*this)(row,0,0);
+                const Ipp8u *g = &(*this)(row,0,1);
+                const Ipp8u *b = &(*this)(row,0,2);
+
+                if( bw != NULL ){
+                    // same weights and rounding as cvCvtColor(CV_BGR2GRAY)
+                    Ipp8u *gray = &(*bw)(row,0,0);
+                    for( int col=colBegin; col<colEnd; col++ )
+                        gray[col] = (Ipp8u)((b[col]*1868 + g[col]*9617 + r[col]*4899 + (1 << 13)) >> 14);
+
+                    if( computeII ){
+                        IntegralType *iiRow = bw->_iidata[0] + (row+1)*bw->_iipixStep + colBegin;
+                        const IntegralType *iiPrev = row == bandBegin ? NULL : iiRow - bw->_iipixStep;
+                        iiRow[0] = 0;
+                        integrateRow(gray + colBegin, iiRow, iiPrev, colEnd-colBegin);
+                    }
+                }
+
+                if( hsv != NULL ){
+                    Ipp8u *hue = &(*hsv)(row,0,0);
+                    Ipp8u *sat = &(*hsv)(row,0,1);
+                    Ipp8u *val = &(*hsv)(row,0,2);
+                    for( int col=colBegin; col<colEnd; col++ ){
+                        const int R = r[col], G = g[col], B = b[col];
+                        const int v = max(max(R,G),B);
+                        const int diff = v - min(min(R,G),B);
+                        const int vr = v == R ? -1 : 0;
+                        const int vg = v == G ? -1 : 0;
+                        int h = (vr & (G - B)) + (~vr & ((vg & (B - R + 2*diff)) + ((~vg) & (R - G + 4*diff))));
+                        h = (h*s_hsvTables.hueDiv[diff] + (1 << (HSV_SHIFT-1))) >> HSV_SHIFT;
+                        h += h < 0 ? 180 : 0;
+                        hue[col] = (Ipp8u)h;
+                        sat[col] = (Ipp8u)((diff*s_hsvTables.satDiv[v] + (1 << (HSV_SHIFT-1))) >> HSV_SHIFT);
+                        val[col] = (Ipp8u)v;
+                    }
+                }
+            }
+        }
+
+        if( !computeII || numBands < 2 )
+            continue;
+
+        // carry the sums of the bands above into every band; only the last row of each band is needed to
+        // build the offsets, the rows themselves are then updated in parallel
+        const int iiCols = colEnd-colBegin+1;
+        vector<IntegralType> offsets(numBands*iiCols, 0);
+        for( int band=1; band<numBands; band++ ){
+            const IntegralType *lastRow = bw->_iidata[0] + (rowBegin + band*bandRows)*bw->_iipixStep + colBegin;
+            for( int col=0; col<iiCols; col++ )
+                offsets[band*iiCols+col] = offsets[(band-1)*iiCols+col] + lastRow[col];
+        }
+
+        #pragma omp parallel for
+        for( int band=1; band<numBands; band++ ){
+            const int bandBegin = rowBegin + band*bandRows;
+            const int bandEnd = min(rowEnd, bandBegin + bandRows);
+            const IntegralType *offset = &offsets[band*iiCols];
+            for( int row=bandBegin; row<bandEnd; row++ ){
+                IntegralType *iiRow = bw->_iidata[0] + (row+1)*bw->_iipixStep + colBegin;
+                for( int col=0; col<iiCols; col++ )
+                    iiRow[col] += offset[col];
+            }
+        }
+    }
+}
+
+template<> void                    Matrixu::conv2HSV(Matrixu &res)
+{
+    conv2BWHSV(NULL, &res, false, NULL);
+}
+
+template<> void                    Matrixu::conv2BW(Matrixu &res)
+{
+    if( _depth == 1 ){
+        res = *this; // without the integral images
+        return;
+    }
+
+    conv2BWHSV(&res, NULL, false, NULL);
 }
 
 template<> float                Matrixf::Dot(const Matrixf &x)
@@ -2,11 +2,21 @@
 #define H_MATRIX
 
 #include "Public.h"
+#include "BufferPool.h"
 
 template<class T> class Matrix;
 typedef Matrix<float>    Matrixf;
 typedef Matrix<uchar>    Matrixu;
 
+// Element of the integral images. Sums are exact integers: a rectangle sum is exact as long as it fits the
+// type, even when the running sums of a large frame wrap around (unsigned arithmetic is modulo 2^n), so
+// 32 bits cover rectangles of up to 16 million 8-bit pixels. Define INTEGRAL_IMAGE_64BIT for 64-bit sums.
+#ifdef INTEGRAL_IMAGE_64BIT
+typedef unsigned long long    IntegralType;
+#else
+typedef unsigned int        IntegralType;
+#endif
+
 #ifndef WIN32
 #include <typeinfo> //[Zefeng Ni] for gcc compatibility
 #endif
@@ -14,7 +24,8 @@ typedef Matrix<uchar>    Matrixu;
 //////////////////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////////////////////
 // This is an IPP based matrix class.  It can be used for both matrix math and for multi channel
-// image manipulation.
+// image manipulation.  The image primitives go through MatrixBackend, so it also builds without IPP
+// (see MatrixBackend.h).
 
 template<class T> class Matrix
 {
@@ -27,16 +38,23 @@ public:
 private:
     // image specific
     int                _dataStep;
+    bool            _ownsData; // false when _data wraps planes owned by someone else (see Wrap)
     IplImage        *_iplimg;
-    // integral images
-    vector<Ipp32f*>    _iidata;
+    // integral images; the buffers persist across InvalidateII and rebuilds while the size stays the same
+    vector<IntegralType*>    _iidata;
     int                _iidataStep;
     int                _iipixStep;
     bool            _ii_init;
+    BufferPoolPtr    _pool; // planes and integral buffers are recycled through this pool when set (see setBufferPool)
 
     IppiSize        _roi; //whole image roi (needed for some functions)
     IppiRect        _roirect;
 
+    // plane allocation, through the buffer pool if there is one
+    void*        allocPlane(uint cols, uint rows, int &step, int elementSize=sizeof(T));
+    void        freePlane(void *plane, uint cols, uint rows, int step, int elementSize=sizeof(T));
+    void        reserveII(uint depth); // integral buffers of the current geometry, kept from the previous frame when possible
+
 public:
     bool            _keepIpl;  // if set to true, calling freeIpl() will have no effect;  this is for speed up only...
 
@@ -52,6 +70,9 @@ public:
     static        Matrix<T>    Eye( int sz );
     void        Resize( uint rows, uint cols, uint depth=1 );
     void        Resize( uint depth );
+    void        Wrap( uint rows, uint cols, const vector<void*> &planes, int step ); // wrap externally owned planes (no copy); step in bytes
+    bool        ownsData() const { return _ownsData; };
+    void        setBufferPool(const BufferPoolPtr &pool) { _pool = pool; }; // planes allocated or freed from now on go through the pool
     void        Free();
     void        Set(T val);
     void        Set(T val, int channel);
@@ -63,9 +84,12 @@ public:
     T&            operator() ( const int row, const int col, const int depth ) const;
     vector<T>    operator() ( const vectori rows, const vectori cols );
     vector<T>    operator() ( const vectori rows, const vectori cols, const vectori depths );
-    float        ii ( const int row, const int col, const int depth ) const;
+    IntegralType    ii ( const int row, const int col, const int depth ) const;
+    const IntegralType*    iiPlane( const int depth ) const { return _iidata[depth]; }; // integral image of one channel, rows iiPixStep() elements apart
+    int            iiPixStep() const { return _iipixStep; };
     Matrix<T>    getCh(uint ch);
     IplImage*    getIpl() { return _iplimg; };
+    cv::Mat        getPlaneMat(uint ch) const; // non-owning cv::Mat header of one plane, valid while the matrix is not resized
 
     int            rows() const { return _rows; };
     int            cols() const { return _cols; };
@@ -113,7 +137,9 @@ public:
     //        Matrix changes or gets updated somehow (otherwise the Matrix will change, but the Ipl will stay the same).
 
     void        initII();
+    void        initII(const vector<IppiRect> &regions); // integral image valid only for rectangles inside one of the regions
     bool        isInitII() const { return _ii_init; };
+    void        InvalidateII() { _ii_init = false; }; // the image changed: the integral buffers are kept and rebuilt in place by the next initII
     void        FreeII();
     float        sumRect(const IppiRect &rect, int channel) const;
     void        drawRect(IppiRect rect, int lineWidth=3, int R=255, int G=0, int B=0);
@@ -125,9 +151,11 @@ public:
     void        warpAll(uint rows, uint cols, vector<vectorf> params, vector<Matrixu> &res);
     void        computeGradChannels();
     Matrixu        imResize(float p, float x=-1);
+    void        imResizeBox(Matrixu &res, uint rows, uint cols); // box filtered (area) resize into res, reusing its planes; for downsampling
     void        conv2RGB(Matrixu &res);
     void        conv2HSV(Matrixu &res);
     void        conv2BW(Matrixu &res);
+    void        conv2BWHSV(Matrixu *bw, Matrixu *hsv, bool initBWII, const vector<IppiRect> *regions=NULL); // one pass over an RGB matrix: gray (+ its integral image) and HSV; NULL skips an output; regions restrict the conversion
     float        dii_dx(uint x, uint y, uint channel=0);
     float        dii_dy(uint x, uint y, uint channel=0);
 
@@ -135,6 +163,7 @@ public:
     void        freeIpl();
 
     void        LoadImage(const char *filename, bool color=false);
+    bool        ReadImage(const char *filename, bool color=false); // as LoadImage, returns false instead of aborting
     void        SaveImage(const char *filename);
     static void    SaveImages(vector<Matrixu> imgs, const char *dirname, float resize=1.0f);
     static vector<Matrixu> LoadVideo(const char *dirname, const char *basename, const char *ext, int start, int end, int digits, bool color=false);
@@ -162,6 +191,7 @@ public:
 
 
     void        IplImage2Matrix(IplImage *img);
+    void        CaptureMat2Matrix(const cv::Mat &frame); // BGR frame of cv::VideoCapture, written straight into the planes
     void        GrayIplImage2Matrix(IplImage *img);
 
 
@@ -180,7 +210,9 @@ template<class T>                    Matrix<T>::Matrix()
     _cols        = 0;
     _depth        = 0;
     _iplimg        = NULL;
+    _ownsData    = true;
     _keepIpl    = false;
+    _ii_init    = false;
 }
 
 template<class T>                    Matrix<T>::Matrix(int rows, int cols)
@@ -189,6 +221,7 @@ template<class T>                    Matrix<T>::Matrix(int rows, int cols)
     _cols        = 0;
     _depth        = 0;
     _iplimg        = NULL;
+    _ownsData    = true;
     _keepIpl    = false;
     _ii_init    = false;
     Resize(rows,cols,1);
@@ -200,6 +233,7 @@ template<class T>                    Matrix<T>::Matrix(int rows, int cols, int d
     _cols        = 0;
     _depth        = 0;
     _iplimg        = NULL;
+    _ownsData    = true;
     _keepIpl    = false;
     _ii_init    = false;
     Resize(rows,cols,depth);
@@ -211,26 +245,17 @@ template<class T>                    Matrix<T>::Matrix(const Matrix<T> &a)
     _cols        = 0;
     _depth        = 0;
     _iplimg        = NULL;
+    _ownsData    = true;
     _keepIpl    = (typeid(T) == typeid(uchar)) && a._keepIpl;
     _ii_init    = false;
     Resize(a._rows, a._cols, a._depth);
     if( typeid(T) == typeid(uchar) )
             for( uint k=0; k<_data.size(); k++ )
-                ippiCopy_8u_C1R((Ipp8u*)a._data[k], a._dataStep, (Ipp8u*)_data[k], _dataStep, _roi );
+                MatrixBackend::Copy_8u((Ipp8u*)a._data[k], a._dataStep, (Ipp8u*)_data[k], _dataStep, _roi );
         else
             for( uint k=0; k<_data.size(); k++ )
-                ippiCopy_32f_C1R((Ipp32f*)a._data[k], a._dataStep, (Ipp32f*)_data[k], _dataStep, _roi );
-    if( a._ii_init ){
-        _iidata.resize(a._iidata.size());
-
-        for( uint k=0; k<_iidata.size(); k++ ){
-            if( _iidata[k] != NULL ) ippiFree(_iidata[k]);
-            _iidata[k] = ippiMalloc_32f_C1(_cols+1,_rows+1,&(_iidataStep));
-            _iipixStep = _iidataStep/sizeof(Ipp32f);
-            ippiCopy_32f_C1R((Ipp32f*)a._iidata[k], a._iidataStep, (Ipp32f*)_iidata[k], _iidataStep, _roi );
-        }
-        _ii_init = true;
-    }
+                MatrixBackend::Copy_32f((Ipp32f*)a._data[k], a._dataStep, (Ipp32f*)_data[k], _dataStep, _roi );
+    // the integral images are not copied (copies are made for display); the copy builds its own when needed
 
     if( a._iplimg != NULL && typeid(T) == typeid(uchar))
     {
@@ -261,12 +286,7 @@ template<class T> void                Matrix<T>::Resize(uint rows, uint cols, ui
     _data.resize(depth);
 
     for( uint k=0; k<_data.size(); k++ ){
-        if( typeid(T) == typeid(uchar) ){
-            _data[k] = (void*)ippiMalloc_8u_C1(cols,rows,&(_dataStep));
-        }
-        else{
-            _data[k] = (void*)ippiMalloc_32f_C1(cols,rows,&(_dataStep));//malloc((uint)rows*cols*sizeof(Ipp32f));
-        }
+        _data[k] = allocPlane(cols,rows,_dataStep);
         err = err || _data[k] == NULL;
     }
 
@@ -290,18 +310,15 @@ template<class T> void                Matrix<T>::Resize(uint depth)
 {
 
     if( _depth == depth ) return;
+    if( !_ownsData )
+        abortError(__LINE__, __FILE__,"CANNOT ADD CHANNELS TO A WRAPPED MATRIX");
     bool err=false;
 
 
     _data.resize(depth);
 
     for( uint k=_depth; k<depth; k++ ){
-        if( typeid(T) == typeid(uchar) ){
-            _data[k] = (void*)ippiMalloc_8u_C1(_cols,_rows,&(_dataStep));
-        }
-        else{
-            _data[k] = (void*)ippiMalloc_32f_C1(_cols,_rows,&(_dataStep));//malloc((uint)rows*cols*sizeof(Ipp32f));
-        }
+        _data[k] = allocPlane(_cols,_rows,_dataStep);
         err = err || _data[k] == NULL;
         Set(0,k);
     }
@@ -314,33 +331,64 @@ template<class T> void                Matrix<T>::Resize(uint depth)
 
 template<class T> void                Matrix<T>::Free()
 {
-    if( _ii_init ) FreeII();
+    if( !_iidata.empty() ) FreeII();
     if( _iplimg != NULL ) cvReleaseImage(&_iplimg);
     _ii_init = false;
 
-    for( uint k=0;  k<_data.size(); k++ )
-        if( _data[k] != NULL )
-            if( typeid(T) == typeid(uchar) ){
-                ippiFree((Ipp8u*)_data[k]);
-            }
-            else{
-                ippiFree((Ipp32f*)_data[k]);
-            }
+    if( _ownsData )
+        for( uint k=0;  k<_data.size(); k++ )
+            if( _data[k] != NULL )
+                freePlane(_data[k],_cols,_rows,_dataStep);
 
+    _ownsData = true;
     _rows = 0;
     _cols = 0;
     _depth = 0;
     _data.resize(0);
 }
 
+template<class T> void                Matrix<T>::Wrap(uint rows, uint cols, const vector<void*> &planes, int step)
+{
+    // the matrix uses the given planes in place; they must outlive it (or the next Resize/Wrap/Free)
+    if( planes.empty() || step < (int)(cols*sizeof(T)) || step % sizeof(T) != 0 )
+        abortError(__LINE__, __FILE__,"INVALID PLANES TO WRAP");
+
+    // the integral buffers are kept when the geometry does not change (a new frame mapped in place)
+    vector<IntegralType*> iidata;
+    if( _rows == (int)rows && _cols == (int)cols )
+        iidata.swap(_iidata);
+    const int iidataStep = iidata.empty() ? 0 : _iidataStep;
+
+    Free();
+    _rows = rows;
+    _cols = cols;
+    _depth = (int)planes.size();
+    _data = planes;
+    _dataStep = step;
+    _ownsData = false;
+
+    if( !iidata.empty() ){
+        _iidata.swap(iidata);
+        _iidataStep = iidataStep;
+        _iipixStep = _iidataStep/sizeof(IntegralType);
+    }
+
+    _roi.width = cols;
+    _roi.height = rows;
+    _roirect.width = cols;
+    _roirect.height = rows;
+    _roirect.x = 0;
+    _roirect.y = 0;
+}
+
 template<class T> void                Matrix<T>::Set(T val)
 {
     for( uint k=0; k<_data.size(); k++ )
         if( typeid(T) == typeid(uchar) ){
-            ippiSet_8u_C1R((Ipp8u)val,(Ipp8u*)_data[k], _dataStep,_roi);
+            MatrixBackend::Set_8u((Ipp8u)val,(Ipp8u*)_data[k], _dataStep,_roi);
         }
         else{
-            ippiSet_32f_C1R((Ipp32f)val,(Ipp32f*)_data[k], _dataStep,_roi);
+            MatrixBackend::Set_32f((Ipp32f)val,(Ipp32f*)_data[k], _dataStep,_roi);
         }
             //for( uint j=0; j<(uint)_rows*_dataStep; j++ )
             //    ((Ipp32f*)_data[k])[j] = val;
@@ -348,10 +396,10 @@ template<class T> void                Matrix<T>::Set(T val)
 template<class T> void                Matrix<T>::Set(T val, int k)
 {
     if( typeid(T) == typeid(uchar) ){
-        ippiSet_8u_C1R((Ipp8u)val,(Ipp8u*)_data[k], _dataStep,_roi);
+        MatrixBackend::Set_8u((Ipp8u)val,(Ipp8u*)_data[k], _dataStep,_roi);
     }
     else{
-        ippiSet_32f_C1R((Ipp32f)val,(Ipp32f*)_data[k], _dataStep,_roi);
+        MatrixBackend::Set_32f((Ipp32f)val,(Ipp32f*)_data[k], _dataStep,_roi);
     }
 }
 
@@ -359,16 +407,46 @@ template<class T> void                Matrix<T>::Set(T val, int k)
 template<class T> void                Matrix<T>::FreeII()
 {
     for( uint k=0;  k<_iidata.size(); k++ )
-        ippiFree(_iidata[k]);
+        if( _iidata[k] != NULL )
+            freePlane(_iidata[k],_cols+1,_rows+1,_iidataStep,sizeof(IntegralType));
     _iidata.resize(0);
     _ii_init = false;
 }
 
+template<class T> void                Matrix<T>::reserveII(uint depth)
+{
+    if( _iidata.size() != depth ){
+        if( !_iidata.empty() ) FreeII();
+        _iidata.assign(depth, (IntegralType*)NULL);
+    }
+    for( uint k=0; k<depth; k++ ){
+        if( _iidata[k] == NULL )
+            _iidata[k] = (IntegralType*)allocPlane(_cols+1,_rows+1,_iidataStep,sizeof(IntegralType));
+        if( _iidata[k] == NULL ) abortError(__LINE__,__FILE__,"OUT OF MEMORY!");
+    }
+    _iipixStep = _iidataStep/sizeof(IntegralType);
+}
+
 template<class T>                    Matrix<T>::~Matrix()
 {
     Free();
 }
 
+template<class T> void*                Matrix<T>::allocPlane(uint cols, uint rows, int &step, int elementSize)
+{
+    if( _pool != NULL )
+        return _pool->Acquire(elementSize,cols,rows,step);
+    return MatrixBackend::AllocPlane(elementSize,cols,rows,step);
+}
+
+template<class T> void                Matrix<T>::freePlane(void *plane, uint cols, uint rows, int step, int elementSize)
+{
+    if( _pool != NULL )
+        _pool->Release(plane,elementSize,cols,rows,step);
+    else
+        MatrixBackend::FreePlane(plane);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////////////////////////////////////////////////////////////////////////////////////////
 // operators
@@ -409,13 +487,18 @@ template<class T> inline vector<T>    Matrix<T>::operator() ( const vectori rows
     return res;
 }
 
+template<class T> inline cv::Mat    Matrix<T>::getPlaneMat(uint ch) const
+{
+    return cv::Mat(_rows, _cols, typeid(T) == typeid(uchar) ? CV_8UC1 : CV_32FC1, _data[ch], _dataStep);
+}
+
 template<class T> inline Matrix<T>    Matrix<T>::getCh(uint ch)
 {
     Matrix<T> a(_rows, _cols, 1);
     if( typeid(T) == typeid(uchar) )
-            ippiCopy_8u_C1R((Ipp8u*)_data[ch], _dataStep, (Ipp8u*)a._data[0], a._dataStep, _roi );
+            MatrixBackend::Copy_8u((Ipp8u*)_data[ch], _dataStep, (Ipp8u*)a._data[0], a._dataStep, _roi );
         else
-            ippiCopy_32f_C1R((Ipp32f*)_data[ch], _dataStep, (Ipp32f*)a._data[0], a._dataStep, _roi );
+            MatrixBackend::Copy_32f((Ipp32f*)_data[ch], _dataStep, (Ipp32f*)a._data[0], a._dataStep, _roi );
     return a;
 }
 template<class T> Matrix<T>&        Matrix<T>::operator= ( const Matrix<T> &a )
@@ -424,22 +507,13 @@ template<class T> Matrix<T>&        Matrix<T>::operator= ( const Matrix<T> &a )
         Resize(a._rows, a._cols, a._depth);
         if( typeid(T) == typeid(uchar) )
             for( uint k=0; k<_data.size(); k++ )
-                ippiCopy_8u_C1R((Ipp8u*)a._data[k], a._dataStep, (Ipp8u*)_data[k], _dataStep, _roi );
+                MatrixBackend::Copy_8u((Ipp8u*)a._data[k], a._dataStep, (Ipp8u*)_data[k], _dataStep, _roi );
         else
             for( uint k=0; k<_data.size(); k++ )
-                ippiCopy_32f_C1R((Ipp32f*)a._data[k], a._dataStep, (Ipp32f*)_data[k], _dataStep, _roi );
+                MatrixBackend::Copy_32f((Ipp32f*)a._data[k], a._dataStep, (Ipp32f*)_data[k], _dataStep, _roi );
                 //ippmCopy_va_32f_SS((Ipp32f*)a._data[k],sizeof(Ipp32f)*_cols,sizeof(Ipp32f),(Ipp32f*)_data[k],sizeof(Ipp32f)*_cols,sizeof(Ipp32f),_cols,_rows);
-        if( a._ii_init ){
-            _iidata.resize(a._iidata.size());
-
-            for( uint k=0; k<_iidata.size(); k++ ){
-                if( _iidata[k] != NULL ) ippiFree(_iidata[k]);
-                _iidata[k] = ippiMalloc_32f_C1(_cols+1,_rows+1,&(_iidataStep));
-                _iipixStep = _iidataStep/sizeof(Ipp32f);
-                ippiCopy_32f_C1R((Ipp32f*)a._iidata[k], a._iidataStep, (Ipp32f*)_iidata[k], _iidataStep, _roi );
-            }
-            _ii_init = true;
-        }
+        // the integral images are not copied, and those of this matrix no longer match its data
+        _ii_init = false;
 
     }
     return (*this);
@@ -469,11 +543,11 @@ template<class T> Matrix<T>            Matrix<T>::operator+ ( const Matrix<T> &a
 
     if( typeid(T) == typeid(uchar) )
         for( uint k=0; k<_data.size(); k++ )
-            ippiAdd_8u_C1RSfs((Ipp8u*)a._data[k], a._dataStep, (Ipp8u*)_data[k], _dataStep,(Ipp8u*)res._data[k], res._dataStep,
-                _roi, 0);
+            MatrixBackend::Add_8u((Ipp8u*)a._data[k], a._dataStep, (Ipp8u*)_data[k], _dataStep,(Ipp8u*)res._data[k], res._dataStep,
+                _roi);
     else
         for( uint k=0; k<_data.size(); k++ )
-            ippiAdd_32f_C1R((Ipp32f*)a._data[k], a._dataStep, (Ipp32f*)_data[k], _dataStep,(Ipp32f*)res._data[k], res._dataStep,
+            MatrixBackend::Add_32f((Ipp32f*)a._data[k], a._dataStep, (Ipp32f*)_data[k], _dataStep,(Ipp32f*)res._data[k], res._dataStep,
                 _roi);
 
     return res;
@@ -486,11 +560,11 @@ template<class T> Matrix<T>            Matrix<T>::operator+ ( const T &a ) const
 
     if( typeid(T) == typeid(uchar) )
         for( uint k=0; k<_data.size(); k++ )
-            ippiAddC_8u_C1RSfs((Ipp8u*)_data[k], _dataStep,(Ipp8u)a,(Ipp8u*)res._data[k], res._dataStep,
-                _roi, 0);
+            MatrixBackend::AddC_8u((Ipp8u*)_data[k], _dataStep,(Ipp8u)a,(Ipp8u*)res._data[k], res._dataStep,
+                _roi);
     else
         for( uint k=0; k<_data.size(); k++ )
-            ippiAddC_32f_C1R((Ipp32f*)_data[k], _dataStep,(Ipp32f)a,(Ipp32f*)res._data[k], res._dataStep,
+            MatrixBackend::AddC_32f((Ipp32f*)_data[k], _dataStep,(Ipp32f)a,(Ipp32f*)res._data[k], res._dataStep,
                 _roi);
 
     return res;
@@ -510,11 +584,11 @@ template<class T> Matrix<T>            Matrix<T>::operator* ( const T &a ) const
 
     if( typeid(T) == typeid(uchar) )
         for( uint k=0; k<_data.size(); k++ )
-            ippiMulC_8u_C1RSfs((Ipp8u*)_data[k], _dataStep,(Ipp8u)a,(Ipp8u*)res._data[k], res._dataStep,
-                _roi, 0);
+            MatrixBackend::MulC_8u((Ipp8u*)_data[k], _dataStep,(Ipp8u)a,(Ipp8u*)res._data[k], res._dataStep,
+                _roi);
     else
         for( uint k=0; k<_data.size(); k++ )
-            ippiMulC_32f_C1R((Ipp32f*)_data[k], _dataStep,(Ipp32f)a,(Ipp32f*)res._data[k], res._dataStep,
+            MatrixBackend::MulC_32f((Ipp32f*)_data[k], _dataStep,(Ipp32f)a,(Ipp32f*)res._data[k], res._dataStep,
                 _roi);
 
     return res;
@@ -526,11 +600,11 @@ template<class T> Matrix<T>            Matrix<T>::operator& ( const Matrix<T> &b
 
     if( typeid(T) == typeid(uchar) )
         for( uint k=0; k<_data.size(); k++ )
-            ippiMul_8u_C1RSfs((Ipp8u*)_data[k], _dataStep,(Ipp8u*)b._data[k], b._dataStep,(Ipp8u*)res._data[k], res._dataStep,
-                _roi, 1);
+            MatrixBackend::Mul_8u((Ipp8u*)_data[k], _dataStep,(Ipp8u*)b._data[k], b._dataStep,(Ipp8u*)res._data[k], res._dataStep,
+                _roi);
     else
         for( uint k=0; k<_data.size(); k++ )
-            ippiMul_32f_C1R((Ipp32f*)_data[k], _dataStep,(Ipp32f*)b._data[k], b._dataStep,(Ipp32f*)res._data[k], res._dataStep,
+            MatrixBackend::Mul_32f((Ipp32f*)_data[k], _dataStep,(Ipp32f*)b._data[k], b._dataStep,(Ipp32f*)res._data[k], res._dataStep,
                 _roi);
 
     return res;
@@ -566,11 +640,11 @@ template<class T> Matrix<T>            Matrix<T>::Sqr ( ) const
 
     if( typeid(T) == typeid(uchar) )
         for( uint k=0; k<_data.size(); k++ )
-            ippiSqr_8u_C1RSfs((Ipp8u*)_data[k], _dataStep,(Ipp8u*)res._data[k], res._dataStep,
-                _roi, 0);
+            MatrixBackend::Sqr_8u((Ipp8u*)_data[k], _dataStep,(Ipp8u*)res._data[k], res._dataStep,
+                _roi);
     else
         for( uint k=0; k<_data.size(); k++ )
-            ippiSqr_32f_C1R((Ipp32f*)_data[k], _dataStep,(Ipp32f*)res._data[k], res._dataStep,
+            MatrixBackend::Sqr_32f((Ipp32f*)_data[k], _dataStep,(Ipp32f*)res._data[k], res._dataStep,
                 _roi);
 
     return res;
@@ -581,11 +655,11 @@ template<class T> Matrix<T>            Matrix<T>::Exp ( ) const
 
     if( typeid(T) == typeid(uchar) )
         for( uint k=0; k<_data.size(); k++ )
-            ippiExp_8u_C1RSfs((Ipp8u*)_data[k], _dataStep,(Ipp8u*)res._data[k], res._dataStep,
-                _roi, 0);
+            MatrixBackend::Exp_8u((Ipp8u*)_data[k], _dataStep,(Ipp8u*)res._data[k], res._dataStep,
+                _roi);
     else
         for( uint k=0; k<_data.size(); k++ )
-            ippiExp_32f_C1R((Ipp32f*)_data[k], _dataStep,(Ipp32f*)res._data[k], res._dataStep,
+            MatrixBackend::Exp_32f((Ipp32f*)_data[k], _dataStep,(Ipp32f*)res._data[k], res._dataStep,
                 _roi);
 
     return res;
@@ -616,7 +690,7 @@ template<class T> void                Matrix<T>::Trans(Matrix<T> &res)
     res.Resize(_cols,_rows,_depth);
     for( uint k=0; k<res._data.size(); k++ )
         if( typeid(T) == typeid(uchar) )
-            ippiTranspose_8u_C1R((Ipp8u*)_data[k], _dataStep,(Ipp8u*)res._data[k], res._dataStep, _roi);
+            MatrixBackend::Transpose_8u((Ipp8u*)_data[k], _dataStep,(Ipp8u*)res._data[k], res._dataStep, _roi);
         else
             abortError(__LINE__,__FILE__,"Trans not implemented for floats");
             //ippmTranspose_m_32f((Ipp32f*)_data[k], sizeof(Ipp32f)*_cols, sizeof(Ipp32f), _rows, _cols, (Ipp32f*)res._data[k], sizeof(Ipp32f)*_rows, sizeof(Ipp32f));
@@ -627,9 +701,9 @@ template<class T> T                    Matrix<T>::Max(uint channel) const
 {
     T max;
     if( typeid(T) == typeid(uchar) )
-        ippiMax_8u_C1R((Ipp8u*)_data[channel], _dataStep, _roi, (Ipp8u*)&max);
+        MatrixBackend::Max_8u((Ipp8u*)_data[channel], _dataStep, _roi, *(Ipp8u*)&max);
     else{
-        ippiMax_32f_C1R((Ipp32f*)_data[channel], _dataStep, _roi, (Ipp32f*)&max);
+        MatrixBackend::Max_32f((Ipp32f*)_data[channel], _dataStep, _roi, *(Ipp32f*)&max);
     }
 
     return max;
@@ -639,9 +713,9 @@ template<class T> T                    Matrix<T>::Min(uint channel)  const
 {
     T min;
     if( typeid(T) == typeid(uchar) )
-        ippiMin_8u_C1R((Ipp8u*)_data[channel], _dataStep, _roi, (Ipp8u*)&min);
+        MatrixBackend::Min_8u((Ipp8u*)_data[channel], _dataStep, _roi, *(Ipp8u*)&min);
     else
-        ippiMin_32f_C1R((Ipp32f*)_data[channel], _dataStep, _roi, (Ipp32f*)&min);
+        MatrixBackend::Min_32f((Ipp32f*)_data[channel], _dataStep, _roi, *(Ipp32f*)&min);
 
     return min;
 }
@@ -652,9 +726,9 @@ template<class T> T                    Matrix<T>::Min(uint channel)  const
 template<class T> void                Matrix<T>::Max(T &val, uint &row, uint &col, uint channel) const
 {
     if( typeid(T) == typeid(uchar) )
-        ippiMaxIndx_8u_C1R((Ipp8u*)_data[channel], _dataStep, _roi, (Ipp8u*)&val, (int*)&col, (int*)&row);
+        MatrixBackend::MaxIndx_8u((Ipp8u*)_data[channel], _dataStep, _roi, *(Ipp8u*)&val, *(int*)&col, *(int*)&row);
     else{
-        ippiMaxIndx_32f_C1R((Ipp32f*)_data[channel], _dataStep, _roi, (Ipp32f*)&val, (int*)&col, (int*)&row);
+        MatrixBackend::MaxIndx_32f((Ipp32f*)_data[channel], _dataStep, _roi, *(Ipp32f*)&val, *(int*)&col, *(int*)&row);
     }
 
 }
@@ -662,9 +736,9 @@ template<class T> void                Matrix<T>::Max(T &val, uint &row, uint &co
 template<class T> void                Matrix<T>::Min(T &val, uint &row, uint &col, uint channel)  const
 {
     if( typeid(T) == typeid(uchar) )
-        ippiMinIndx_8u_C1R((Ipp8u*)_data[channel], _dataStep, _roi, (Ipp8u*)&val, (int*)&col, (int*)&row);
+        MatrixBackend::MinIndx_8u((Ipp8u*)_data[channel], _dataStep, _roi, *(Ipp8u*)&val, *(int*)&col, *(int*)&row);
     else
-        ippiMinIndx_32f_C1R((Ipp32f*)_data[channel], _dataStep, _roi, (Ipp32f*)&val, (int*)&col, (int*)&row);
+        MatrixBackend::MinIndx_32f((Ipp32f*)_data[channel], _dataStep, _roi, *(Ipp32f*)&val, *(int*)&col, *(int*)&row);
 
 }
 
@@ -673,22 +747,16 @@ template<class T> void                Matrix<T>::Min(T &val, uint &row, uint &co
 
 template<class T> float                Matrix<T>::Mean(uint channel)  const
 {
-    double mean;
-    if( typeid(T) == typeid(uchar) )
-        ippiMean_8u_C1R((Ipp8u*)_data[channel], _dataStep, _roi, &mean );
-    else
-        ippiMean_32f_C1R((Ipp32f*)_data[channel], _dataStep, _roi, &mean, ippAlgHintFast);
-
-    return (float)mean;
+    return (float)(Sum(channel)/size());
 }
 
 template<class T> float                Matrix<T>::Var(uint channel)  const
 {
     double mean,var;
     if( typeid(T) == typeid(uchar) )
-        ippiMean_StdDev_8u_C1R((Ipp8u*)_data[channel], _dataStep, _roi, &mean, &var);
+        MatrixBackend::MeanStdDev_8u((Ipp8u*)_data[channel], _dataStep, _roi, mean, var);
     else
-        ippiMean_StdDev_32f_C1R((Ipp32f*)_data[channel], _dataStep, _roi, &mean, &var);
+        MatrixBackend::MeanStdDev_32f((Ipp32f*)_data[channel], _dataStep, _roi, mean, var);
 
     return (float)(var*var);
 }
@@ -722,9 +790,9 @@ template<class T> double            Matrix<T>::Sum(uint channel)  const
 {
     double sum;
     if( typeid(T) == typeid(uchar) )
-        ippiSum_8u_C1R((Ipp8u*)_data[channel], _dataStep, _roi, &sum);
+        sum = MatrixBackend::Sum_8u((Ipp8u*)_data[channel], _dataStep, _roi);
     else
-        ippiSum_32f_C1R((Ipp32f*)_data[channel], _dataStep, _roi, &sum, ippAlgHintFast);
+        sum = MatrixBackend::Sum_32f((Ipp32f*)_data[channel], _dataStep, _roi);
 
     return sum;
 }
@@ -767,8 +835,6 @@ template<class T> vector<Matrixu>    Matrix<T>::LoadVideoStream(const char *aviF
     }
     
     cv::Mat frame;
-    cv::Mat frameBW; 
-    IplImage img, imgBW;
     
     int fr; 
 
@@ -779,18 +845,8 @@ template<class T> vector<Matrixu>    Matrix<T>::LoadVideoStream(const char *aviF
     for (fr=start; cap.grab() && fr<= end; fr++)
     {        
         cap.retrieve(frame); //read the first frame to get the proper Size
-        if( color )
-        {
-            img = frame; //convert to IplImage        
-            res[fr-start].Resize(img.height, img.width, img.nChannels);        
-            res[fr-start].IplImage2Matrix(&img);
-        }
-        else{
-            cv::cvtColor(frame,frameBW,CV_RGB2GRAY);//convert img to gray scale 
-            imgBW = frameBW;
-            res[fr-start].Resize(imgBW.height, imgBW.width, imgBW.nChannels);
-            res[fr-start].GrayIplImage2Matrix(&imgBW);
-        }
+        res[fr-start].Resize(frame.rows, frame.cols, color ? 3 : 1);
+        res[fr-start].CaptureMat2Matrix(frame);
     }
     
     if( fr < end )
@@ -802,20 +858,6 @@ template<class T> vector<Matrixu>    Matrix<T>::LoadVideoStream(const char *aviF
 }
 
 
-template<class T> vector<Matrixu>    Matrix<T>::LoadVideo(const char *dirname, const char *basename, const char *ext, int start, int end, int digits, bool color)
-{
-    vector<Matrixu> res(end-start+1);
-
-    char format[1024];
-    char fname[1024];
-    for( int k=start; k<=end; k++ ){
-        sprintf_s(format,"%s/%s%%0%ii.%s",dirname,basename,digits,ext);
-        sprintf_s(fname,format,k);
-        res[k-start].LoadImage(fname, color);
-    }
-
-    return res;
-}
 template<class T> vector<Matrixu>    Matrix<T>::LoadVideo(const char *fname, bool color, int maxframes)
 {
     CvCapture* capture = cvCaptureFromFile( fname );
@@ -834,14 +876,6 @@ template<class T> vector<Matrixu>    Matrix<T>::LoadVideo(const char *fname, boo
     fprintf(stderr, "\n");
     return vid;
 }
-//template<class T> void                Matrix<T>::PlayVideo( vector<Matrixu> &vid, int wait=1 )
-template<class T> void                Matrix<T>::PlayVideo( vector<Matrixu> &vid, int wait) //[Zefeng Ni] for gcc compatibility
-{
-    for( uint k=0; k<vid.size(); k++ ){
-        vid[k].display(1);
-        cvWaitKey(wait);
-    }
-}
 template<class T> void                Matrix<T>::SaveVideo( vector<Matrixu> &vid, const char* fname, int fps )
 {
     CvVideoWriter* w = cvCreateVideoWriter( fname, CV_FOURCC('x','v','i','d'), fps, cvSize(vid[0].cols(),vid[0].rows()), 3 );
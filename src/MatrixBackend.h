@@ -0,0 +1,88 @@
+#ifndef H_MATRIX_BACKEND
+#define H_MATRIX_BACKEND
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////////////////////////////////////
+// The image primitives used by the Matrix class, chosen at build time:
+//    default                        Intel IPP (MatrixBackendIpp.cpp)
+//    MATRIX_BACKEND_PORTABLE        no IPP: aligned allocation and SSE2/AVX2/NEON loops (whichever the compiler
+//                                targets), OpenCV for the resampling (MatrixBackendPortable.cpp)
+// Planes are single channel, rows step bytes apart; roi is the size processed. The 8u arithmetic saturates
+// like the IPP "Sfs" functions with a scale factor of 0 (Mul_8u halves the product, scale factor 1).
+
+#ifndef MATRIX_BACKEND_PORTABLE
+
+#include "ipp.h"
+
+#else
+
+// the IPP types used through the tree
+typedef unsigned char    Ipp8u;
+typedef short            Ipp16s;
+typedef int                Ipp32s;
+typedef float            Ipp32f;
+typedef double            Ipp64f;
+typedef int                IppStatus;
+enum { ippStsNoErr = 0 };
+typedef struct { int width, height; } IppiSize;
+typedef struct { int x, y; } IppiPoint;
+typedef struct { int x, y, width, height; } IppiRect;
+
+#endif
+
+namespace MatrixBackend
+{
+    // name of the backend, for the log
+    const char*    GetName();
+
+    // plane of cols x rows elements of the given size in bytes; rows aligned for the vector loads, step in bytes
+    void*        AllocPlane(int elementSize, int cols, int rows, int &step);
+    void        FreePlane(void *plane);
+
+    void        Copy_8u(const Ipp8u *src, int srcStep, Ipp8u *dst, int dstStep, IppiSize roi);
+    void        Copy_32f(const Ipp32f *src, int srcStep, Ipp32f *dst, int dstStep, IppiSize roi);
+    void        Set_8u(Ipp8u val, Ipp8u *dst, int dstStep, IppiSize roi);
+    void        Set_32f(Ipp32f val, Ipp32f *dst, int dstStep, IppiSize roi);
+
+    // dst = a + b, a + c, a * c, a * b, a^2, exp(a)
+    void        Add_8u(const Ipp8u *a, int aStep, const Ipp8u *b, int bStep, Ipp8u *dst, int dstStep, IppiSize roi);
+    void        Add_32f(const Ipp32f *a, int aStep, const Ipp32f *b, int bStep, Ipp32f *dst, int dstStep, IppiSize roi);
+    void        AddC_8u(const Ipp8u *a, int aStep, Ipp8u c, Ipp8u *dst, int dstStep, IppiSize roi);
+    void        AddC_32f(const Ipp32f *a, int aStep, Ipp32f c, Ipp32f *dst, int dstStep, IppiSize roi);
+    void        MulC_8u(const Ipp8u *a, int aStep, Ipp8u c, Ipp8u *dst, int dstStep, IppiSize roi);
+    void        MulC_32f(const Ipp32f *a, int aStep, Ipp32f c, Ipp32f *dst, int dstStep, IppiSize roi);
+    void        Mul_8u(const Ipp8u *a, int aStep, const Ipp8u *b, int bStep, Ipp8u *dst, int dstStep, IppiSize roi);
+    void        Mul_32f(const Ipp32f *a, int aStep, const Ipp32f *b, int bStep, Ipp32f *dst, int dstStep, IppiSize roi);
+    void        Sqr_8u(const Ipp8u *a, int aStep, Ipp8u *dst, int dstStep, IppiSize roi);
+    void        Sqr_32f(const Ipp32f *a, int aStep, Ipp32f *dst, int dstStep, IppiSize roi);
+    void        Exp_8u(const Ipp8u *a, int aStep, Ipp8u *dst, int dstStep, IppiSize roi);
+    void        Exp_32f(const Ipp32f *a, int aStep, Ipp32f *dst, int dstStep, IppiSize roi);
+    void        Transpose_8u(const Ipp8u *src, int srcStep, Ipp8u *dst, int dstStep, IppiSize roi);
+
+    // statistics; the index versions return the first extremum in row major order
+    void        Max_8u(const Ipp8u *src, int srcStep, IppiSize roi, Ipp8u &val);
+    void        Max_32f(const Ipp32f *src, int srcStep, IppiSize roi, Ipp32f &val);
+    void        Min_8u(const Ipp8u *src, int srcStep, IppiSize roi, Ipp8u &val);
+    void        Min_32f(const Ipp32f *src, int srcStep, IppiSize roi, Ipp32f &val);
+    void        MaxIndx_8u(const Ipp8u *src, int srcStep, IppiSize roi, Ipp8u &val, int &col, int &row);
+    void        MaxIndx_32f(const Ipp32f *src, int srcStep, IppiSize roi, Ipp32f &val, int &col, int &row);
+    void        MinIndx_8u(const Ipp8u *src, int srcStep, IppiSize roi, Ipp8u &val, int &col, int &row);
+    void        MinIndx_32f(const Ipp32f *src, int srcStep, IppiSize roi, Ipp32f &val, int &col, int &row);
+    double        Sum_8u(const Ipp8u *src, int srcStep, IppiSize roi);
+    double        Sum_32f(const Ipp32f *src, int srcStep, IppiSize roi);
+    void        MeanStdDev_8u(const Ipp8u *src, int srcStep, IppiSize roi, double &mean, double &stdDev);
+    void        MeanStdDev_32f(const Ipp32f *src, int srcStep, IppiSize roi, double &mean, double &stdDev);
+
+    // resampling (bilinear); the affine transform maps the corners of the source rectangle to quad[0..2]
+    void        Resize_8u(const Ipp8u *src, IppiSize srcSize, int srcStep, Ipp8u *dst, int dstStep, IppiSize dstSize,
+                          double xFactor, double yFactor);
+    void        GetAffineTransform(const IppiRect &srcRect, const double quad[4][2], double coeffs[2][3]);
+    void        WarpAffine_8u(const Ipp8u *src, IppiSize srcSize, int srcStep, Ipp8u *dst, int dstStep, IppiSize dstSize,
+                              const double coeffs[2][3]);
+
+    // dst(x) = src(x+2) - src(x) along the rows or the columns, saturated: the centered difference at x+1
+    void        FilterRowGradient_8u(const Ipp8u *src, int srcStep, Ipp8u *dst, int dstStep, IppiSize roi);
+    void        FilterColumnGradient_8u(const Ipp8u *src, int srcStep, Ipp8u *dst, int dstStep, IppiSize roi);
+}
+
+#endif
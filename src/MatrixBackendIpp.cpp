@@ -0,0 +1,216 @@
+// Intel IPP implementation of the Matrix primitives (see MatrixBackend.h)
+
+#ifndef MATRIX_BACKEND_PORTABLE
+
+#include "MatrixBackend.h"
+
+const char*        MatrixBackend::GetName()
+{
+    return "Intel IPP";
+}
+
+void*            MatrixBackend::AllocPlane(int elementSize, int cols, int rows, int &step)
+{
+    if( elementSize == sizeof(Ipp32f) )
+        return (void*)ippiMalloc_32f_C1(cols,rows,&step);
+    else
+        return (void*)ippiMalloc_8u_C1(cols*elementSize,rows,&step); // bytes, or 64-bit integral sums
+}
+
+void            MatrixBackend::FreePlane(void *plane)
+{
+    ippiFree(plane);
+}
+
+void            MatrixBackend::Copy_8u(const Ipp8u *src, int srcStep, Ipp8u *dst, int dstStep, IppiSize roi)
+{
+    ippiCopy_8u_C1R(src, srcStep, dst, dstStep, roi);
+}
+
+void            MatrixBackend::Copy_32f(const Ipp32f *src, int srcStep, Ipp32f *dst, int dstStep, IppiSize roi)
+{
+    ippiCopy_32f_C1R(src, srcStep, dst, dstStep, roi);
+}
+
+void            MatrixBackend::Set_8u(Ipp8u val, Ipp8u *dst, int dstStep, IppiSize roi)
+{
+    ippiSet_8u_C1R(val, dst, dstStep, roi);
+}
+
+void            MatrixBackend::Set_32f(Ipp32f val, Ipp32f *dst, int dstStep, IppiSize roi)
+{
+    ippiSet_32f_C1R(val, dst, dstStep, roi);
+}
+
+void            MatrixBackend::Add_8u(const Ipp8u *a, int aStep, const Ipp8u *b, int bStep, Ipp8u *dst, int dstStep, IppiSize roi)
+{
+    ippiAdd_8u_C1RSfs(a, aStep, b, bStep, dst, dstStep, roi, 0);
+}
+
+void            MatrixBackend::Add_32f(const Ipp32f *a, int aStep, const Ipp32f *b, int bStep, Ipp32f *dst, int dstStep, IppiSize roi)
+{
+    ippiAdd_32f_C1R(a, aStep, b, bStep, dst, dstStep, roi);
+}
+
+void            MatrixBackend::AddC_8u(const Ipp8u *a, int aStep, Ipp8u c, Ipp8u *dst, int dstStep, IppiSize roi)
+{
+    ippiAddC_8u_C1RSfs(a, aStep, c, dst, dstStep, roi, 0);
+}
+
+void            MatrixBackend::AddC_32f(const Ipp32f *a, int aStep, Ipp32f c, Ipp32f *dst, int dstStep, IppiSize roi)
+{
+    ippiAddC_32f_C1R(a, aStep, c, dst, dstStep, roi);
+}
+
+void            MatrixBackend::MulC_8u(const Ipp8u *a, int aStep, Ipp8u c, Ipp8u *dst, int dstStep, IppiSize roi)
+{
+    ippiMulC_8u_C1RSfs(a, aStep, c, dst, dstStep, roi, 0);
+}
+
+void            MatrixBackend::MulC_32f(const Ipp32f *a, int aStep, Ipp32f c, Ipp32f *dst, int dstStep, IppiSize roi)
+{
+    ippiMulC_32f_C1R(a, aStep, c, dst, dstStep, roi);
+}
+
+void            MatrixBackend::Mul_8u(const Ipp8u *a, int aStep, const Ipp8u *b, int bStep, Ipp8u *dst, int dstStep, IppiSize roi)
+{
+    ippiMul_8u_C1RSfs(a, aStep, b, bStep, dst, dstStep, roi, 1);
+}
+
+void            MatrixBackend::Mul_32f(const Ipp32f *a, int aStep, const Ipp32f *b, int bStep, Ipp32f *dst, int dstStep, IppiSize roi)
+{
+    ippiMul_32f_C1R(a, aStep, b, bStep, dst, dstStep, roi);
+}
+
+void            MatrixBackend::Sqr_8u(const Ipp8u *a, int aStep, Ipp8u *dst, int dstStep, IppiSize roi)
+{
+    ippiSqr_8u_C1RSfs(a, aStep, dst, dstStep, roi, 0);
+}
+
+void            MatrixBackend::Sqr_32f(const Ipp32f *a, int aStep, Ipp32f *dst, int dstStep, IppiSize roi)
+{
+    ippiSqr_32f_C1R(a, aStep, dst, dstStep, roi);
+}
+
+void            MatrixBackend::Exp_8u(const Ipp8u *a, int aStep, Ipp8u *dst, int dstStep, IppiSize roi)
+{
+    ippiExp_8u_C1RSfs(a, aStep, dst, dstStep, roi, 0);
+}
+
+void            MatrixBackend::Exp_32f(const Ipp32f *a, int aStep, Ipp32f *dst, int dstStep, IppiSize roi)
+{
+    ippiExp_32f_C1R(a, aStep, dst, dstStep, roi);
+}
+
+void            MatrixBackend::Transpose_8u(const Ipp8u *src, int srcStep, Ipp8u *dst, int dstStep, IppiSize roi)
+{
+    ippiTranspose_8u_C1R(src, srcStep, dst, dstStep, roi);
+}
+
+void            MatrixBackend::Max_8u(const Ipp8u *src, int srcStep, IppiSize roi, Ipp8u &val)
+{
+    ippiMax_8u_C1R(src, srcStep, roi, &val);
+}
+
+void            MatrixBackend::Max_32f(const Ipp32f *src, int srcStep, IppiSize roi, Ipp32f &val)
+{
+    ippiMax_32f_C1R(src, srcStep, roi, &val);
+}
+
+void            MatrixBackend::Min_8u(const Ipp8u *src, int srcStep, IppiSize roi, Ipp8u &val)
+{
+    ippiMin_8u_C1R(src, srcStep, roi, &val);
+}
+
+void            MatrixBackend::Min_32f(const Ipp32f *src, int srcStep, IppiSize roi, Ipp32f &val)
+{
+    ippiMin_32f_C1R(src, srcStep, roi, &val);
+}
+
+void            MatrixBackend::MaxIndx_8u(const Ipp8u *src, int srcStep, IppiSize roi, Ipp8u &val, int &col, int &row)
+{
+    ippiMaxIndx_8u_C1R(src, srcStep, roi, &val, &col, &row);
+}
+
+void            MatrixBackend::MaxIndx_32f(const Ipp32f *src, int srcStep, IppiSize roi, Ipp32f &val, int &col, int &row)
+{
+    ippiMaxIndx_32f_C1R(src, srcStep, roi, &val, &col, &row);
+}
+
+void            MatrixBackend::MinIndx_8u(const Ipp8u *src, int srcStep, IppiSize roi, Ipp8u &val, int &col, int &row)
+{
+    ippiMinIndx_8u_C1R(src, srcStep, roi, &val, &col, &row);
+}
+
+void            MatrixBackend::MinIndx_32f(const Ipp32f *src, int srcStep, IppiSize roi, Ipp32f &val, int &col, int &row)
+{
+    ippiMinIndx_32f_C1R(src, srcStep, roi, &val, &col, &row);
+}
+
+double            MatrixBackend::Sum_8u(const Ipp8u *src, int srcStep, IppiSize roi)
+{
+    double sum;
+    ippiSum_8u_C1R(src, srcStep, roi, &sum);
+    return sum;
+}
+
+double            MatrixBackend::Sum_32f(const Ipp32f *src, int srcStep, IppiSize roi)
+{
+    double sum;
+    ippiSum_32f_C1R(src, srcStep, roi, &sum, ippAlgHintFast);
+    return sum;
+}
+
+void            MatrixBackend::MeanStdDev_8u(const Ipp8u *src, int srcStep, IppiSize roi, double &mean, double &stdDev)
+{
+    ippiMean_StdDev_8u_C1R(src, srcStep, roi, &mean, &stdDev);
+}
+
+void            MatrixBackend::MeanStdDev_32f(const Ipp32f *src, int srcStep, IppiSize roi, double &mean, double &stdDev)
+{
+    ippiMean_StdDev_32f_C1R(src, srcStep, roi, &mean, &stdDev);
+}
+
+void            MatrixBackend::Resize_8u(const Ipp8u *src, IppiSize srcSize, int srcStep, Ipp8u *dst, int dstStep, IppiSize dstSize,
+                                         double xFactor, double yFactor)
+{
+    IppiRect srcRect = { 0, 0, srcSize.width, srcSize.height };
+#ifdef IPP_61
+    ippiResize_8u_C1R(src, srcSize, srcStep, srcRect, dst, dstStep, dstSize, xFactor, yFactor, IPPI_INTER_LINEAR);
+#else
+    IppiRect dstRect = { 0, 0, dstSize.width, dstSize.height };
+    int bufSize;
+    ippiResizeGetBufSize(srcRect, dstRect, 1, IPPI_INTER_LINEAR, &bufSize);
+    Ipp8u* pBuffer = ippsMalloc_8u(bufSize);
+    ippiResizeSqrPixel_8u_C1R(src, srcSize, srcStep, srcRect, dst, dstStep, dstRect,
+                              xFactor, yFactor, 0.0, 0.0, IPPI_INTER_LINEAR, pBuffer);
+    ippsFree(pBuffer);
+#endif
+}
+
+void            MatrixBackend::GetAffineTransform(const IppiRect &srcRect, const double quad[4][2], double coeffs[2][3])
+{
+    ippiGetAffineTransform(srcRect, quad, coeffs);
+}
+
+void            MatrixBackend::WarpAffine_8u(const Ipp8u *src, IppiSize srcSize, int srcStep, Ipp8u *dst, int dstStep, IppiSize dstSize,
+                                             const double coeffs[2][3])
+{
+    IppiRect srcRect = { 0, 0, srcSize.width, srcSize.height };
+    IppiRect dstRect = { 0, 0, dstSize.width, dstSize.height };
+    ippiWarpAffine_8u_C1R(src, srcSize, srcStep, srcRect, dst, dstStep, dstRect, coeffs, IPPI_INTER_LINEAR);
+}
+
+void            MatrixBackend::FilterRowGradient_8u(const Ipp8u *src, int srcStep, Ipp8u *dst, int dstStep, IppiSize roi)
+{
+    Ipp32s kernel[3] = {-1, 0, 1};
+    ippiFilterRow_8u_C1R(src, srcStep, dst, dstStep, roi, kernel, 3, 2, -1);
+}
+
+void            MatrixBackend::FilterColumnGradient_8u(const Ipp8u *src, int srcStep, Ipp8u *dst, int dstStep, IppiSize roi)
+{
+    Ipp32s kernel[3] = {-1, 0, 1};
+    ippiFilterColumn_8u_C1R(src, srcStep, dst, dstStep, roi, kernel, 3, 2, -1);
+}
+
+#endif
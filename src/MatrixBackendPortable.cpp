@@ -0,0 +1,535 @@
+// Portable implementation of the Matrix primitives (see MatrixBackend.h): plain C++ with the vector
+// instructions the compiler targets (AVX2, SSE2 or NEON), OpenCV for the resampling.
+
+#ifdef MATRIX_BACKEND_PORTABLE
+
+#include "MatrixBackend.h"
+
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+#include <algorithm>
+#include "cv.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define BACKEND_VECTOR_NAME        "AVX2"
+#define VEC_F32_WIDTH            8
+#define VEC_U8_WIDTH            32
+typedef __m256                    VecF;
+typedef __m256i                    VecU8;
+#define VecLoadF(p)                _mm256_loadu_ps(p)
+#define VecStoreF(p,v)            _mm256_storeu_ps(p,v)
+#define VecSetF(c)                _mm256_set1_ps(c)
+#define VecAddF(a,b)            _mm256_add_ps(a,b)
+#define VecMulF(a,b)            _mm256_mul_ps(a,b)
+#define VecMaxF(a,b)            _mm256_max_ps(a,b)
+#define VecMinF(a,b)            _mm256_min_ps(a,b)
+#define VecLoadU8(p)            _mm256_loadu_si256((const __m256i*)(p))
+#define VecStoreU8(p,v)            _mm256_storeu_si256((__m256i*)(p),v)
+#define VecSetU8(c)                _mm256_set1_epi8((char)(c))
+#define VecAddsU8(a,b)            _mm256_adds_epu8(a,b)
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define BACKEND_VECTOR_NAME        "SSE2"
+#define VEC_F32_WIDTH            4
+#define VEC_U8_WIDTH            16
+typedef __m128                    VecF;
+typedef __m128i                    VecU8;
+#define VecLoadF(p)                _mm_loadu_ps(p)
+#define VecStoreF(p,v)            _mm_storeu_ps(p,v)
+#define VecSetF(c)                _mm_set1_ps(c)
+#define VecAddF(a,b)            _mm_add_ps(a,b)
+#define VecMulF(a,b)            _mm_mul_ps(a,b)
+#define VecMaxF(a,b)            _mm_max_ps(a,b)
+#define VecMinF(a,b)            _mm_min_ps(a,b)
+#define VecLoadU8(p)            _mm_loadu_si128((const __m128i*)(p))
+#define VecStoreU8(p,v)            _mm_storeu_si128((__m128i*)(p),v)
+#define VecSetU8(c)                _mm_set1_epi8((char)(c))
+#define VecAddsU8(a,b)            _mm_adds_epu8(a,b)
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define BACKEND_VECTOR_NAME        "NEON"
+#define VEC_F32_WIDTH            4
+#define VEC_U8_WIDTH            16
+typedef float32x4_t                VecF;
+typedef uint8x16_t                VecU8;
+#define VecLoadF(p)                vld1q_f32(p)
+#define VecStoreF(p,v)            vst1q_f32(p,v)
+#define VecSetF(c)                vdupq_n_f32(c)
+#define VecAddF(a,b)            vaddq_f32(a,b)
+#define VecMulF(a,b)            vmulq_f32(a,b)
+#define VecMaxF(a,b)            vmaxq_f32(a,b)
+#define VecMinF(a,b)            vminq_f32(a,b)
+#define VecLoadU8(p)            vld1q_u8(p)
+#define VecStoreU8(p,v)            vst1q_u8(p,v)
+#define VecSetU8(c)                vdupq_n_u8(c)
+#define VecAddsU8(a,b)            vqaddq_u8(a,b)
+#else
+#define BACKEND_VECTOR_NAME        "scalar"
+#endif
+
+// planes are allocated with rows aligned to this many bytes (as ippiMalloc does)
+#define PLANE_ALIGNMENT        64
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////
+// row helpers
+
+template<class P> static inline P*        rowPtr(P *plane, int step, int row)
+{
+    return (P*)((char*)plane + (size_t)row*step);
+}
+template<class P> static inline const P*    rowPtr(const P *plane, int step, int row)
+{
+    return (const P*)((const char*)plane + (size_t)row*step);
+}
+
+static inline Ipp8u                        saturate8u(int v)
+{
+    return (Ipp8u)( v < 0 ? 0 : ( v > 255 ? 255 : v ) );
+}
+
+// element wise 32f operations: the vector loop, then the remainder of the row
+struct AddOp
+{
+    static inline Ipp32f    Scalar(Ipp32f a, Ipp32f b) { return a + b; }
+#ifdef VEC_F32_WIDTH
+    static inline VecF        Vector(VecF a, VecF b) { return VecAddF(a,b); }
+#endif
+};
+struct MulOp
+{
+    static inline Ipp32f    Scalar(Ipp32f a, Ipp32f b) { return a * b; }
+#ifdef VEC_F32_WIDTH
+    static inline VecF        Vector(VecF a, VecF b) { return VecMulF(a,b); }
+#endif
+};
+
+template<class Op> static void            binary32f(const Ipp32f *a, int aStep, const Ipp32f *b, int bStep, Ipp32f *dst, int dstStep, IppiSize roi)
+{
+    for( int row=0; row<roi.height; row++ ){
+        const Ipp32f *ra = rowPtr(a,aStep,row), *rb = rowPtr(b,bStep,row);
+        Ipp32f *rd = rowPtr(dst,dstStep,row);
+        int col = 0;
+#ifdef VEC_F32_WIDTH
+        for( ; col+VEC_F32_WIDTH<=roi.width; col+=VEC_F32_WIDTH )
+            VecStoreF(rd+col, Op::Vector(VecLoadF(ra+col), VecLoadF(rb+col)));
+#endif
+        for( ; col<roi.width; col++ )
+            rd[col] = Op::Scalar(ra[col], rb[col]);
+    }
+}
+
+template<class Op> static void            constant32f(const Ipp32f *a, int aStep, Ipp32f c, Ipp32f *dst, int dstStep, IppiSize roi)
+{
+#ifdef VEC_F32_WIDTH
+    const VecF vc = VecSetF(c);
+#endif
+    for( int row=0; row<roi.height; row++ ){
+        const Ipp32f *ra = rowPtr(a,aStep,row);
+        Ipp32f *rd = rowPtr(dst,dstStep,row);
+        int col = 0;
+#ifdef VEC_F32_WIDTH
+        for( ; col+VEC_F32_WIDTH<=roi.width; col+=VEC_F32_WIDTH )
+            VecStoreF(rd+col, Op::Vector(VecLoadF(ra+col), vc));
+#endif
+        for( ; col<roi.width; col++ )
+            rd[col] = Op::Scalar(ra[col], c);
+    }
+}
+
+// saturated 8u addition of two planes (b != NULL) or of a constant
+static void                                add8u(const Ipp8u *a, int aStep, const Ipp8u *b, int bStep, Ipp8u c, Ipp8u *dst, int dstStep, IppiSize roi)
+{
+#ifdef VEC_U8_WIDTH
+    const VecU8 vc = VecSetU8(c);
+#endif
+    for( int row=0; row<roi.height; row++ ){
+        const Ipp8u *ra = rowPtr(a,aStep,row);
+        const Ipp8u *rb = b != NULL ? rowPtr(b,bStep,row) : NULL;
+        Ipp8u *rd = rowPtr(dst,dstStep,row);
+        int col = 0;
+#ifdef VEC_U8_WIDTH
+        for( ; col+VEC_U8_WIDTH<=roi.width; col+=VEC_U8_WIDTH )
+            VecStoreU8(rd+col, VecAddsU8(VecLoadU8(ra+col), rb != NULL ? VecLoadU8(rb+col) : vc));
+#endif
+        for( ; col<roi.width; col++ )
+            rd[col] = saturate8u(ra[col] + ( rb != NULL ? rb[col] : c ));
+    }
+}
+
+// extremum and its first position in row major order
+template<class P> static void            extremum(const P *src, int srcStep, IppiSize roi, bool findMax, P &val, int &col, int &row)
+{
+    val = src[0]; col = 0; row = 0;
+    for( int r=0; r<roi.height; r++ ){
+        const P *rs = rowPtr(src,srcStep,r);
+        for( int c=0; c<roi.width; c++ )
+            if( findMax ? rs[c] > val : rs[c] < val ){
+                val = rs[c]; col = c; row = r;
+            }
+    }
+}
+
+#ifdef VEC_F32_WIDTH
+static inline Ipp32f                    reduceVector(VecF v, bool findMax)
+{
+    Ipp32f lanes[VEC_F32_WIDTH];
+    VecStoreF(lanes, v);
+    Ipp32f res = lanes[0];
+    for( int k=1; k<VEC_F32_WIDTH; k++ )
+        res = findMax ? std::max(res, lanes[k]) : std::min(res, lanes[k]);
+    return res;
+}
+#endif
+
+static Ipp32f                            extremum32f(const Ipp32f *src, int srcStep, IppiSize roi, bool findMax)
+{
+    Ipp32f res = src[0];
+    for( int row=0; row<roi.height; row++ ){
+        const Ipp32f *rs = rowPtr(src,srcStep,row);
+        int col = 0;
+#ifdef VEC_F32_WIDTH
+        if( roi.width >= VEC_F32_WIDTH ){
+            VecF v = VecLoadF(rs);
+            for( col=VEC_F32_WIDTH; col+VEC_F32_WIDTH<=roi.width; col+=VEC_F32_WIDTH )
+                v = findMax ? VecMaxF(v, VecLoadF(rs+col)) : VecMinF(v, VecLoadF(rs+col));
+            const Ipp32f rowRes = reduceVector(v, findMax);
+            res = findMax ? std::max(res, rowRes) : std::min(res, rowRes);
+        }
+#endif
+        for( ; col<roi.width; col++ )
+            res = findMax ? std::max(res, rs[col]) : std::min(res, rs[col]);
+    }
+    return res;
+}
+
+template<class P> static void            meanStdDev(const P *src, int srcStep, IppiSize roi, double &mean, double &stdDev)
+{
+    double sum = 0.0, sumSq = 0.0;
+    for( int row=0; row<roi.height; row++ ){
+        const P *rs = rowPtr(src,srcStep,row);
+        for( int col=0; col<roi.width; col++ ){
+            sum += rs[col];
+            sumSq += (double)rs[col]*rs[col];
+        }
+    }
+    const double n = (double)roi.width*roi.height;
+    mean = sum/n;
+    stdDev = sqrt(std::max(0.0, sumSq/n - mean*mean));
+}
+
+static cv::Mat                            planeMat(const Ipp8u *plane, IppiSize size, int step)
+{
+    return cv::Mat(size.height, size.width, CV_8UC1, (void*)plane, step);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////
+// primitives
+
+const char*        MatrixBackend::GetName()
+{
+    return "portable (" BACKEND_VECTOR_NAME ")";
+}
+
+void*            MatrixBackend::AllocPlane(int elementSize, int cols, int rows, int &step)
+{
+    step = (cols*elementSize + PLANE_ALIGNMENT-1)/PLANE_ALIGNMENT*PLANE_ALIGNMENT;
+    const size_t size = (size_t)step*std::max(rows,1);
+#if defined(WIN32) || defined(WIN64)
+    return _aligned_malloc(size, PLANE_ALIGNMENT);
+#else
+    void *plane = NULL;
+    if( posix_memalign(&plane, PLANE_ALIGNMENT, size) != 0 )
+        return NULL;
+    return plane;
+#endif
+}
+
+void            MatrixBackend::FreePlane(void *plane)
+{
+#if defined(WIN32) || defined(WIN64)
+    _aligned_free(plane);
+#else
+    free(plane);
+#endif
+}
+
+void            MatrixBackend::Copy_8u(const Ipp8u *src, int srcStep, Ipp8u *dst, int dstStep, IppiSize roi)
+{
+    for( int row=0; row<roi.height; row++ )
+        memcpy(rowPtr(dst,dstStep,row), rowPtr(src,srcStep,row), roi.width*sizeof(Ipp8u));
+}
+
+void            MatrixBackend::Copy_32f(const Ipp32f *src, int srcStep, Ipp32f *dst, int dstStep, IppiSize roi)
+{
+    for( int row=0; row<roi.height; row++ )
+        memcpy(rowPtr(dst,dstStep,row), rowPtr(src,srcStep,row), roi.width*sizeof(Ipp32f));
+}
+
+void            MatrixBackend::Set_8u(Ipp8u val, Ipp8u *dst, int dstStep, IppiSize roi)
+{
+    for( int row=0; row<roi.height; row++ )
+        memset(rowPtr(dst,dstStep,row), val, roi.width);
+}
+
+void            MatrixBackend::Set_32f(Ipp32f val, Ipp32f *dst, int dstStep, IppiSize roi)
+{
+    for( int row=0; row<roi.height; row++ ){
+        Ipp32f *rd = rowPtr(dst,dstStep,row);
+        int col = 0;
+#ifdef VEC_F32_WIDTH
+        const VecF v = VecSetF(val);
+        for( ; col+VEC_F32_WIDTH<=roi.width; col+=VEC_F32_WIDTH )
+            VecStoreF(rd+col, v);
+#endif
+        for( ; col<roi.width; col++ )
+            rd[col] = val;
+    }
+}
+
+void            MatrixBackend::Add_8u(const Ipp8u *a, int aStep, const Ipp8u *b, int bStep, Ipp8u *dst, int dstStep, IppiSize roi)
+{
+    add8u(a, aStep, b, bStep, 0, dst, dstStep, roi);
+}
+
+void            MatrixBackend::Add_32f(const Ipp32f *a, int aStep, const Ipp32f *b, int bStep, Ipp32f *dst, int dstStep, IppiSize roi)
+{
+    binary32f<AddOp>(a, aStep, b, bStep, dst, dstStep, roi);
+}
+
+void            MatrixBackend::AddC_8u(const Ipp8u *a, int aStep, Ipp8u c, Ipp8u *dst, int dstStep, IppiSize roi)
+{
+    add8u(a, aStep, NULL, 0, c, dst, dstStep, roi);
+}
+
+void            MatrixBackend::AddC_32f(const Ipp32f *a, int aStep, Ipp32f c, Ipp32f *dst, int dstStep, IppiSize roi)
+{
+    constant32f<AddOp>(a, aStep, c, dst, dstStep, roi);
+}
+
+void            MatrixBackend::MulC_8u(const Ipp8u *a, int aStep, Ipp8u c, Ipp8u *dst, int dstStep, IppiSize roi)
+{
+    for( int row=0; row<roi.height; row++ ){
+        const Ipp8u *ra = rowPtr(a,aStep,row);
+        Ipp8u *rd = rowPtr(dst,dstStep,row);
+        for( int col=0; col<roi.width; col++ )
+            rd[col] = saturate8u(ra[col]*c);
+    }
+}
+
+void            MatrixBackend::MulC_32f(const Ipp32f *a, int aStep, Ipp32f c, Ipp32f *dst, int dstStep, IppiSize roi)
+{
+    constant32f<MulOp>(a, aStep, c, dst, dstStep, roi);
+}
+
+void            MatrixBackend::Mul_8u(const Ipp8u *a, int aStep, const Ipp8u *b, int bStep, Ipp8u *dst, int dstStep, IppiSize roi)
+{
+    for( int row=0; row<roi.height; row++ ){
+        const Ipp8u *ra = rowPtr(a,aStep,row), *rb = rowPtr(b,bStep,row);
+        Ipp8u *rd = rowPtr(dst,dstStep,row);
+        for( int col=0; col<roi.width; col++ ){
+            // halved, rounded half to even like the IPP scale factor
+            const int p = ra[col]*rb[col];
+            rd[col] = saturate8u((p >> 1) + ((p & 1) & ((p >> 1) & 1)));
+        }
+    }
+}
+
+void            MatrixBackend::Mul_32f(const Ipp32f *a, int aStep, const Ipp32f *b, int bStep, Ipp32f *dst, int dstStep, IppiSize roi)
+{
+    binary32f<MulOp>(a, aStep, b, bStep, dst, dstStep, roi);
+}
+
+void            MatrixBackend::Sqr_8u(const Ipp8u *a, int aStep, Ipp8u *dst, int dstStep, IppiSize roi)
+{
+    for( int row=0; row<roi.height; row++ ){
+        const Ipp8u *ra = rowPtr(a,aStep,row);
+        Ipp8u *rd = rowPtr(dst,dstStep,row);
+        for( int col=0; col<roi.width; col++ )
+            rd[col] = saturate8u(ra[col]*ra[col]);
+    }
+}
+
+void            MatrixBackend::Sqr_32f(const Ipp32f *a, int aStep, Ipp32f *dst, int dstStep, IppiSize roi)
+{
+    binary32f<MulOp>(a, aStep, a, aStep, dst, dstStep, roi);
+}
+
+void            MatrixBackend::Exp_8u(const Ipp8u *a, int aStep, Ipp8u *dst, int dstStep, IppiSize roi)
+{
+    // exp(5) is already 148, exp(6) saturates
+    for( int row=0; row<roi.height; row++ ){
+        const Ipp8u *ra = rowPtr(a,aStep,row);
+        Ipp8u *rd = rowPtr(dst,dstStep,row);
+        for( int col=0; col<roi.width; col++ )
+            rd[col] = ra[col] > 5 ? 255 : (Ipp8u)floor(exp((double)ra[col]) + 0.5);
+    }
+}
+
+void            MatrixBackend::Exp_32f(const Ipp32f *a, int aStep, Ipp32f *dst, int dstStep, IppiSize roi)
+{
+    for( int row=0; row<roi.height; row++ ){
+        const Ipp32f *ra = rowPtr(a,aStep,row);
+        Ipp32f *rd = rowPtr(dst,dstStep,row);
+        for( int col=0; col<roi.width; col++ )
+            rd[col] = exp(ra[col]);
+    }
+}
+
+void            MatrixBackend::Transpose_8u(const Ipp8u *src, int srcStep, Ipp8u *dst, int dstStep, IppiSize roi)
+{
+    // in blocks, so the rows of both planes stay in cache
+    const int block = 32;
+    for( int row0=0; row0<roi.height; row0+=block )
+        for( int col0=0; col0<roi.width; col0+=block )
+            for( int row=row0; row<std::min(row0+block,roi.height); row++ ){
+                const Ipp8u *rs = rowPtr(src,srcStep,row);
+                for( int col=col0; col<std::min(col0+block,roi.width); col++ )
+                    rowPtr(dst,dstStep,col)[row] = rs[col];
+            }
+}
+
+void            MatrixBackend::Max_8u(const Ipp8u *src, int srcStep, IppiSize roi, Ipp8u &val)
+{
+    int col, row;
+    extremum(src, srcStep, roi, true, val, col, row);
+}
+
+void            MatrixBackend::Max_32f(const Ipp32f *src, int srcStep, IppiSize roi, Ipp32f &val)
+{
+    val = extremum32f(src, srcStep, roi, true);
+}
+
+void            MatrixBackend::Min_8u(const Ipp8u *src, int srcStep, IppiSize roi, Ipp8u &val)
+{
+    int col, row;
+    extremum(src, srcStep, roi, false, val, col, row);
+}
+
+void            MatrixBackend::Min_32f(const Ipp32f *src, int srcStep, IppiSize roi, Ipp32f &val)
+{
+    val = extremum32f(src, srcStep, roi, false);
+}
+
+void            MatrixBackend::MaxIndx_8u(const Ipp8u *src, int srcStep, IppiSize roi, Ipp8u &val, int &col, int &row)
+{
+    extremum(src, srcStep, roi, true, val, col, row);
+}
+
+void            MatrixBackend::MaxIndx_32f(const Ipp32f *src, int srcStep, IppiSize roi, Ipp32f &val, int &col, int &row)
+{
+    extremum(src, srcStep, roi, true, val, col, row);
+}
+
+void            MatrixBackend::MinIndx_8u(const Ipp8u *src, int srcStep, IppiSize roi, Ipp8u &val, int &col, int &row)
+{
+    extremum(src, srcStep, roi, false, val, col, row);
+}
+
+void            MatrixBackend::MinIndx_32f(const Ipp32f *src, int srcStep, IppiSize roi, Ipp32f &val, int &col, int &row)
+{
+    extremum(src, srcStep, roi, false, val, col, row);
+}
+
+double            MatrixBackend::Sum_8u(const Ipp8u *src, int srcStep, IppiSize roi)
+{
+    double sum = 0.0;
+    for( int row=0; row<roi.height; row++ ){
+        const Ipp8u *rs = rowPtr(src,srcStep,row);
+        unsigned int rowSum = 0; // exact for rows of up to 16 million pixels
+        for( int col=0; col<roi.width; col++ )
+            rowSum += rs[col];
+        sum += rowSum;
+    }
+    return sum;
+}
+
+double            MatrixBackend::Sum_32f(const Ipp32f *src, int srcStep, IppiSize roi)
+{
+    // vector partial sums within a row (as the fast IPP hint), rows accumulated in double
+    double sum = 0.0;
+    for( int row=0; row<roi.height; row++ ){
+        const Ipp32f *rs = rowPtr(src,srcStep,row);
+        int col = 0;
+        double rowSum = 0.0;
+#ifdef VEC_F32_WIDTH
+        VecF v = VecSetF(0.0f);
+        for( ; col+VEC_F32_WIDTH<=roi.width; col+=VEC_F32_WIDTH )
+            v = VecAddF(v, VecLoadF(rs+col));
+        Ipp32f lanes[VEC_F32_WIDTH];
+        VecStoreF(lanes, v);
+        for( int k=0; k<VEC_F32_WIDTH; k++ )
+            rowSum += lanes[k];
+#endif
+        for( ; col<roi.width; col++ )
+            rowSum += rs[col];
+        sum += rowSum;
+    }
+    return sum;
+}
+
+void            MatrixBackend::MeanStdDev_8u(const Ipp8u *src, int srcStep, IppiSize roi, double &mean, double &stdDev)
+{
+    meanStdDev(src, srcStep, roi, mean, stdDev);
+}
+
+void            MatrixBackend::MeanStdDev_32f(const Ipp32f *src, int srcStep, IppiSize roi, double &mean, double &stdDev)
+{
+    meanStdDev(src, srcStep, roi, mean, stdDev);
+}
+
+void            MatrixBackend::Resize_8u(const Ipp8u *src, IppiSize srcSize, int srcStep, Ipp8u *dst, int dstStep, IppiSize dstSize,
+                                         double xFactor, double yFactor)
+{
+    // the destination size already follows from the factors
+    cv::Mat dstMat = planeMat(dst, dstSize, dstStep);
+    cv::resize(planeMat(src, srcSize, srcStep), dstMat, dstMat.size(), xFactor, yFactor, cv::INTER_LINEAR);
+}
+
+void            MatrixBackend::GetAffineTransform(const IppiRect &srcRect, const double quad[4][2], double coeffs[2][3])
+{
+    // the corners map as in ippiGetAffineTransform: top left, top right and bottom right pixel
+    cv::Point2f srcPoints[3], dstPoints[3];
+    srcPoints[0] = cv::Point2f((float)srcRect.x, (float)srcRect.y);
+    srcPoints[1] = cv::Point2f((float)(srcRect.x+srcRect.width-1), (float)srcRect.y);
+    srcPoints[2] = cv::Point2f((float)(srcRect.x+srcRect.width-1), (float)(srcRect.y+srcRect.height-1));
+    for( int k=0; k<3; k++ )
+        dstPoints[k] = cv::Point2f((float)quad[k][0], (float)quad[k][1]);
+
+    cv::Mat transform = cv::getAffineTransform(srcPoints, dstPoints);
+    for( int row=0; row<2; row++ )
+        for( int col=0; col<3; col++ )
+            coeffs[row][col] = transform.at<double>(row,col);
+}
+
+void            MatrixBackend::WarpAffine_8u(const Ipp8u *src, IppiSize srcSize, int srcStep, Ipp8u *dst, int dstStep, IppiSize dstSize,
+                                             const double coeffs[2][3])
+{
+    // destination pixels mapping outside the source are left as they are, as IPP does
+    cv::Mat transform(2, 3, CV_64FC1, (void*)coeffs);
+    cv::Mat dstMat = planeMat(dst, dstSize, dstStep);
+    cv::warpAffine(planeMat(src, srcSize, srcStep), dstMat, transform, dstMat.size(), cv::INTER_LINEAR, cv::BORDER_TRANSPARENT);
+}
+
+void            MatrixBackend::FilterRowGradient_8u(const Ipp8u *src, int srcStep, Ipp8u *dst, int dstStep, IppiSize roi)
+{
+    for( int row=0; row<roi.height; row++ ){
+        const Ipp8u *rs = rowPtr(src,srcStep,row);
+        Ipp8u *rd = rowPtr(dst,dstStep,row);
+        for( int col=0; col<roi.width; col++ )
+            rd[col] = saturate8u(rs[col+2] - rs[col]);
+    }
+}
+
+void            MatrixBackend::FilterColumnGradient_8u(const Ipp8u *src, int srcStep, Ipp8u *dst, int dstStep, IppiSize roi)
+{
+    for( int row=0; row<roi.height; row++ ){
+        const Ipp8u *rs = rowPtr(src,srcStep,row), *rs2 = rowPtr(src,srcStep,row+2);
+        Ipp8u *rd = rowPtr(dst,dstStep,row);
+        for( int col=0; col<roi.width; col++ )
+            rd[col] = saturate8u(rs2[col] - rs[col]);
+    }
+}
+
+#endif
@@ -31,25 +31,22 @@ namespace Features
     ****************************************************************/
     void MultiDimensionalColorHistogram::Compute( const Classifier::Sample& sample, vectorf& featureValueList ) const
     {
-        try
-        {
-            ASSERT_TRUE( !featureValueList.empty( ) );
+        ASSERT_TRUE( featureValueList.size( ) >= GetFeatureDimension( ) );
 
-            // Calculate the size for each part.
-            vectori partRowList;
-            int accum = 0, partEnd;
-
-            float numberOfRows = cvRound( static_cast<float>(sample.m_height) * sample.m_scaleY );
+        ComputeHistogram( sample, &featureValueList[0] );
+    }
 
-            partRowList.push_back( 0 );
-            for (int i = 0; i < m_numberOfParts; i++)
-            {    
-                accum += m_partPercentageVertical[i];  
-                partEnd = cvRound( numberOfRows * accum/100 ); 
-                ASSERT_TRUE ( partEnd > partRowList[i] );
-                partRowList.push_back( partEnd );
-            }
-            
+    /****************************************************************
+    MultiDimensionalColorHistogram::ComputeHistogram
+        Compute the multi-dimensional color histogram, part by part,
+        into the given buffer; each part is normalized on its own.
+    Exception:
+        None
+    ****************************************************************/
+    void MultiDimensionalColorHistogram::ComputeHistogram( const Classifier::Sample& sample, float* pFeatureValues ) const
+    {
+        try
+        {
             Matrixu* pImageMatrix = NULL;
             
             if ( m_useHSVColorSpace )
@@ -62,45 +59,60 @@ namespace Features
             }
             
             ASSERT_TRUE ( pImageMatrix != NULL );
-        
-            float numberOfColumns =cvRound( static_cast<float>(sample.m_width) * sample.m_scaleX );
-
-            float varianceX = pow( (numberOfColumns / 2), 2);
-            float sampleCenterX = sample.m_col + numberOfColumns/2;
-
             ASSERT_TRUE( pImageMatrix->depth( ) == 3 );
             ASSERT_TRUE( m_numberOfBins >  0 );
 
-            float binWidth = 256 / m_numberOfBins;    
+            const float numberOfRows        = cvRound( static_cast<float>(sample.m_height) * sample.m_scaleY );
+            const float numberOfColumns        = cvRound( static_cast<float>(sample.m_width) * sample.m_scaleX );
+            const float varianceX            = pow( (numberOfColumns / 2), 2);
+            const float sampleCenterX        = sample.m_col + numberOfColumns/2;
+            const float binWidth            = 256 / m_numberOfBins;
 
-            int partFeatureDimension = m_numberOfBins*m_numberOfBins*m_numberOfBins;
-            
-            vectorf partFeatureValueList;
+            //bin index of every pixel, quantized once per frame by the frame image cache
+            const int*    pColorBinImage    = sample.GetColorBinImage( m_numberOfBins, m_useHSVColorSpace );
+            const int    frameWidth        = pImageMatrix->cols( );
 
-            partFeatureValueList.resize( partFeatureDimension );
+            const int partFeatureDimension = m_numberOfBins*m_numberOfBins*m_numberOfBins;
 
+            int accum        = 0;
+            int partStart    = 0;
         
             for( int partIndex = 0; partIndex < m_numberOfParts; partIndex++ ) 
             {
-                #pragma omp parallel for
+                // rows of the part
+                accum += m_partPercentageVertical[partIndex];
+                const int partEnd = cvRound( numberOfRows * accum/100 );
+                ASSERT_TRUE ( partEnd > partStart );
+
+                float* pPartFeatureValues = pFeatureValues + partIndex*partFeatureDimension;
+                std::fill( pPartFeatureValues, pPartFeatureValues + partFeatureDimension, 0.0f );
 
-                float partNumberOfRows = partRowList[partIndex+1] - partRowList[partIndex];
-                float varianceY = pow( (partNumberOfRows / 2), 2);
-                float sampleCenterY = sample.m_row + partRowList[partIndex] + partNumberOfRows/2;
+                const float partNumberOfRows    = partEnd - partStart;
+                const float varianceY            = pow( (partNumberOfRows / 2), 2);
+                const float sampleCenterY        = sample.m_row + partStart + partNumberOfRows/2;
                 
-                for ( uint rowIndex = sample.m_row+partRowList[partIndex]; rowIndex < (sample.m_row+partRowList[partIndex+1]); rowIndex++ )
+                for ( uint rowIndex = sample.m_row+partStart; rowIndex < (sample.m_row+partEnd); rowIndex++ )
                 {
                     for ( uint columnIndex = sample.m_col; columnIndex < (sample.m_col+numberOfColumns); columnIndex++ )
                     {
-                        uint rPixel = (*pImageMatrix)( rowIndex, columnIndex, 0 /*depth*/ );
-                        uint gPixel = (*pImageMatrix)( rowIndex, columnIndex, 1 /*depth*/ );
-                        uint bPixel = (*pImageMatrix)( rowIndex, columnIndex, 2 /*depth*/ );
+                        uint featureIndex;
+
+                        if ( pColorBinImage != NULL )
+                        {
+                            featureIndex = pColorBinImage[rowIndex * frameWidth + columnIndex];
+                        }
+                        else
+                        {
+                            uint rPixel = (*pImageMatrix)( rowIndex, columnIndex, 0 /*depth*/ );
+                            uint gPixel = (*pImageMatrix)( rowIndex, columnIndex, 1 /*depth*/ );
+                            uint bPixel = (*pImageMatrix)( rowIndex, columnIndex, 2 /*depth*/ );
 
-                        uint rBin = floor(  rPixel / binWidth );
-                        uint gBin = floor(  gPixel / binWidth );
-                        uint bBin = floor(  bPixel / binWidth );
+                            uint rBin = floor(  rPixel / binWidth );
+                            uint gBin = floor(  gPixel / binWidth );
+                            uint bBin = floor(  bPixel / binWidth );
 
-                        uint featureIndex = rBin + m_numberOfBins * gBin + m_numberOfBins * m_numberOfBins * bBin;
+                            featureIndex = rBin + m_numberOfBins * gBin + m_numberOfBins * m_numberOfBins * bBin;
+                        }
 
                         float featureWeight = 1.0f;
 
@@ -112,15 +124,22 @@ namespace Features
                             featureWeight = exp( -1 * weightedDistanceFromCenter );
                         }
 
-                        partFeatureValueList[ featureIndex ] = partFeatureValueList[ featureIndex ] + featureWeight;
+                        pPartFeatureValues[ featureIndex ] += featureWeight;
                     }
                 }
-                ::normalizeVec( partFeatureValueList );
 
+                //normalize the part
+                float sum = 0.0f;
                 for ( int i = 0; i < partFeatureDimension; i++ )
                 {
-                    featureValueList[partIndex*partFeatureDimension + i]= partFeatureValueList[i];
-                }             
+                    sum += pPartFeatureValues[i];
+                }
+                for ( int i = 0; i < partFeatureDimension; i++ )
+                {
+                    pPartFeatureValues[i] /= sum;
+                }
+
+                partStart = partEnd;
             }    //to next part
         }
         EXCEPTION_CATCH_AND_ABORT( "Failed to Compute Multi-Dimensional Color Histogram" )
@@ -27,6 +27,12 @@ namespace Features
         }
 
         virtual void    Compute( const Classifier::Sample& sample, vectorf& featureValueList ) const;
+
+        //the histogram of the sample into pFeatureValues (GetFeatureDimension values); what the
+        //feature vector calls directly, without virtual dispatch or allocation
+        void            ComputeHistogram( const Classifier::Sample& sample, float* pFeatureValues ) const;
+
+        uint            GetFeatureDimension( ) const { return m_numberOfParts*m_numberOfBins*m_numberOfBins*m_numberOfBins; }
         
         //initialize feature instance (unlike the haar feature) 
         virtual void            Generate( FeatureParametersPtr featureParametersPtr ) ;
@@ -1,5 +1,4 @@
 #include "MultiDimensionalColorHistogramFeatureVector.h"
-#include "MultiDimensionalColorHistogram.h"
 
 namespace Features
 {
@@ -20,13 +19,11 @@ namespace Features
 
             m_featureParametersPtr = featureParametersPtr;
 
-            m_featurePtr = boost::shared_ptr<MultiDimensionalColorHistogram>( new MultiDimensionalColorHistogram() );
-
-            ASSERT_TRUE( m_featurePtr != NULL );
-
             m_numberOfColorFeatures = m_featureParametersPtr->GetColorFeatureDimension( );
 
-            m_featurePtr->Generate( m_featureParametersPtr );
+            m_colorHistogram.Generate( m_featureParametersPtr );
+
+            ASSERT_TRUE( m_colorHistogram.GetFeatureDimension( ) == m_numberOfColorFeatures );
 
             //Update the feature generated flag
             m_isFeatureGenerated = true;
@@ -41,15 +38,15 @@ namespace Features
 
 
     /****************************************************************
-    MultiDimensionalColorHistogramFeatureVector::Compute
+    MultiDimensionalColorHistogramFeatureVector::ComputeFeatures
         Iterate over each sample in the given Classifier::SampleSet
-        and compute the featurePtr. Store the computed featurePtr value 
-        in the featurePtr vector.
+        and compute its color histogram into a buffer of the thread.
+        Store the computed histogram in the feature matrix.
         Classifier calls this method with a set of samples for each type.
     Exception:
         None
     ****************************************************************/
-    void    MultiDimensionalColorHistogramFeatureVector::Compute( Classifier::SampleSet& sampleSet, bool shouldResizeFeatureMatrix )
+    void    MultiDimensionalColorHistogramFeatureVector::ComputeFeatures( Classifier::SampleSet& sampleSet, bool shouldResizeFeatureMatrix, const vectori* pFeatureIndices )
     {
         try
         {
@@ -64,27 +61,43 @@ namespace Features
                 return;
             }
 
+            //a dense grid has no sample per location to take the histogram of
+            ASSERT_TRUE( !sampleSet.IsDenseGrid() );
+
             //resize the feature matrix size to the number of features
             if ( shouldResizeFeatureMatrix )
             {
                 sampleSet.ResizeFeatures( m_numberOfColorFeatures );
             }
 
-            #pragma omp parallel for
-            for ( int sampleIndex = 0; sampleIndex < numberOfSamples; sampleIndex++ )
+            //the whole histogram is computed at once, if any of its bins is needed
+            if ( !IsAnyFeatureToCompute( sampleSet, m_startingIndexForFeatureMatrix, m_numberOfColorFeatures, pFeatureIndices ) )
+            {
+                return;
+            }
+
+            #pragma omp parallel
             {
+                //one histogram buffer per thread
                 vectorf colorHistogramVector( m_numberOfColorFeatures, 0.0f );
-                m_featurePtr->Compute( sampleSet[sampleIndex], colorHistogramVector );
 
-                ASSERT_TRUE( m_featurePtr != NULL );
-                ASSERT_TRUE( colorHistogramVector.size( ) == m_numberOfColorFeatures );
-                
-                for ( uint featureIndex = m_startingIndexForFeatureMatrix; featureIndex < (m_startingIndexForFeatureMatrix+m_numberOfColorFeatures); featureIndex++ )
+                #pragma omp for
+                for ( int sampleIndex = 0; sampleIndex < (int)numberOfSamples; sampleIndex++ )
                 {
-                    //store the feature value in the feature matrix
-                    sampleSet.GetFeatureValue( sampleIndex, featureIndex ) = colorHistogramVector[featureIndex-m_startingIndexForFeatureMatrix];
+                    m_colorHistogram.ComputeHistogram( sampleSet[sampleIndex], &colorHistogramVector[0] );
+
+                    for ( uint featureIndex = m_startingIndexForFeatureMatrix; featureIndex < (m_startingIndexForFeatureMatrix+m_numberOfColorFeatures); featureIndex++ )
+                    {
+                        //store the feature value in the feature matrix
+                        sampleSet.GetFeatureValue( sampleIndex, featureIndex ) = colorHistogramVector[featureIndex-m_startingIndexForFeatureMatrix];
+                    }
                 }
             }
+
+            for ( uint featureIndex = m_startingIndexForFeatureMatrix; featureIndex < (m_startingIndexForFeatureMatrix+m_numberOfColorFeatures); featureIndex++ )
+            {
+                sampleSet.SetFeatureComputed( featureIndex );
+            }
         }
         EXCEPTION_CATCH_AND_ABORT( "Failed to Multi-Dimensional Color Histogram Feature Vector" );
     }
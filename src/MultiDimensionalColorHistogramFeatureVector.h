@@ -2,11 +2,14 @@
 #define COLOR_FEATURE_VECTOR_H
 
 #include "FeatureVector.h"
+#include "MultiDimensionalColorHistogram.h"
+
 namespace Features
 {
     /****************************************************************
     MultiDimensionalColorHistogramFeatureVector
         This is a wrapper class for MultiDimensionalColorHistogram.
+        The histogram feature is held by value and called directly.
     ****************************************************************/
     class MultiDimensionalColorHistogramFeatureVector : virtual public FeatureVector
     {
@@ -14,9 +17,6 @@ namespace Features
         //Generate features
         virtual void        Generate( FeatureParametersPtr featureParametersPtr );
 
-        //Computes features for the given sample set
-        virtual void        Compute( Classifier::SampleSet& sampleSet, bool shouldResizeFeatureMatrix = true  );
-
         //Save the visualized feature vector - Unused
         virtual void        SaveVisualizedFeatureVector( const char *dirName ){}
 
@@ -24,8 +24,10 @@ namespace Features
         virtual const uint    GetNumberOfFeatures( ) const { return m_numberOfColorFeatures; }
 
     protected:
+        //Computes features for the given sample set
+        virtual void        ComputeFeatures( Classifier::SampleSet& sampleSet, bool shouldResizeFeatureMatrix, const vectori* pFeatureIndices );
 
-        FeaturePtr                m_featurePtr;
+        MultiDimensionalColorHistogram    m_colorHistogram;
         uint                    m_numberOfColorFeatures;
         uint                    m_startingIndexForFeatureMatrix; //Used while Color Feature is concatenated to the Other features.
     };
@@ -1,6 +1,7 @@
 #include "CameraNetwork.h"
 #include "Config.h"
 #include "DefaultParameters.h"
+#include "Visualizer.h"
 
 //Configure the system
 bool ConfigureSystem( int argc, char* argv[] )
@@ -73,6 +74,29 @@ void    MultiCameraTracking( int argc, char* argv[] )
         abortError( __LINE__, __FILE__, "Number of Objects should be >= 1.");
     }
 
+    // find the processing scale of each camera; the last one given applies to the remaining cameras
+    vectorf processingScaleList;
+    char* pch3= strtok ( MultipleCameraTracking::g_configInput.m_processingScaleSetCstr, " ," );
+    while( pch3 != NULL )
+    {
+        processingScaleList.push_back( (float)atof(pch3) );
+        pch3 = strtok( NULL, " ," );
+    }
+
+    if ( processingScaleList.empty() )
+    {
+        processingScaleList.push_back( 1.0f );
+    }
+    processingScaleList.resize( numberOfCameras, processingScaleList.back() );
+
+    for ( int cameraIndex = 0; cameraIndex < numberOfCameras; cameraIndex++ )
+    {
+        if ( processingScaleList[cameraIndex] <= 0 || processingScaleList[cameraIndex] > 1 )
+        {
+            abortError( __LINE__, __FILE__, "Processing scales should be in (0,1].");
+        }
+    }
+
 
     //Set up the camera network
     MultipleCameraTracking::GeometricFusionType theGeometricFusinType = MultipleCameraTracking::NO_GEOMETRIC_FUSION; 
@@ -227,9 +251,21 @@ void    MultiCameraTracking( int argc, char* argv[] )
                                                             )
         );
 
+    //Tool mode: convert the input of every camera to a raw frame file and exit
+    if ( MultipleCameraTracking::g_configInput.m_convertInputToRawFrames )
+    {
+        for ( int cameraIndex = 0; cameraIndex < numberOfCameras; cameraIndex++ )
+        {
+            MultipleCameraTracking::Camera::ConvertInputToRawFrameFile( cameraIdList[cameraIndex], cameraTrackingParametersPtr );
+        }
+
+        MultipleCameraTracking::g_logFile.close();
+        return;
+    }
+
     //Create a Camera Network and Start with Initialization
     MultipleCameraTracking::CameraNetworkPtr cameraNetworkPtr(
-            new  MultipleCameraTracking::CameraNetwork ( cameraIdList, objectIdList,cameraTrackingParametersPtr    )
+            new  MultipleCameraTracking::CameraNetwork ( cameraIdList, objectIdList, processingScaleList, cameraTrackingParametersPtr    )
                                                     );
  
 
@@ -239,7 +275,14 @@ void    MultiCameraTracking( int argc, char* argv[] )
     //frameind=0 is used for initialization
     for ( int frameind = 1; frameind < MultipleCameraTracking::g_configInput.m_numOfFrames; frameind++ )
     {
+        //live input: take the newest frames, stop when a stream ends
+        if ( !cameraNetworkPtr->AcquireFrames( frameind ) )
+        {
+            break;
+        }
+
         cameraNetworkPtr->TrackObjectsOnCurrentFrame( frameind );
+        cameraNetworkPtr->ReportLiveLatency( frameind );
         if( MultipleCameraTracking::g_configInput.m_interactiveModeEnabled )
         {
             cout << "Press enter to continue to next frame" << endl;
@@ -252,6 +295,9 @@ void    MultiCameraTracking( int argc, char* argv[] )
 
     cameraNetworkPtr->SaveCameraNetworkState( );
 
+    //close the windows
+    Visualizer::GetInstance().Stop( );
+
     //close the logs
     MultipleCameraTracking::g_logFile.close();
 }
@@ -261,6 +307,7 @@ int        main( int argc, char* argv[] )
 {
 
     cout << "STARTING MULTICAMERA TRACKING" << endl;
+    cout << "Image primitives: " << MatrixBackend::GetName() << endl;
 
     MultiCameraTracking( argc, argv );
 
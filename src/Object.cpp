@@ -20,13 +20,15 @@ namespace MultipleCameraTracking
                     const int                                        cameraId,
                     const bool                                        isColorEnabled,
                     CameraTrackingParametersPtr                        cameraTrackingParametersPtr,
-                    CvMat*                                            pHomographyMatrix )
+                    CvMat*                                            pHomographyMatrix,
+                    FrameImageCachePtr                                frameImageCachePtr )
         : m_objectID( objectId ),
         m_cameraID( objectId ),
         m_colorImage ( isColorEnabled ),
         m_appearanceFuserPtr( )    ,
         m_cameraTrackingParametersPtr( cameraTrackingParametersPtr ),
-        m_pHomographyMatrix( pHomographyMatrix )
+        m_pHomographyMatrix( pHomographyMatrix ),
+        m_frameImageCachePtr( frameImageCachePtr )
     {
     }
 
@@ -45,7 +47,7 @@ namespace MultipleCameraTracking
             Features::FeatureParametersPtr featureParametersPtr;
             if ( m_cameraTrackingParametersPtr->m_trackerFeatureType == Features::HAAR_LIKE )
             {
-                featureParametersPtr = Features::FeatureParametersPtr( new Features::HaarFeatureParameters( g_configInput.m_trackerFeatureParameter ) );
+                featureParametersPtr = Features::FeatureParametersPtr( new Features::HaarFeatureParameters( g_configInput.m_trackerFeatureParameter, (float)g_configInput.m_haarScaleQuantizationStep ) );
             }
             else if ( m_cameraTrackingParametersPtr->m_trackerFeatureType == Features::CULTURE_COLOR_HISTOGRAM )
             {                
@@ -66,7 +68,8 @@ namespace MultipleCameraTracking
                         new Features::HaarAndColorHistogramFeatureParameters( 
                             g_configInput.m_trackerFeatureParameter,
                             m_cameraTrackingParametersPtr->m_useHSVColorSpaceForColorHistogram,
-                            m_cameraTrackingParametersPtr->m_numberOfBinsForColorHistogram 
+                            m_cameraTrackingParametersPtr->m_numberOfBinsForColorHistogram,
+                            (float)g_configInput.m_haarScaleQuantizationStep
                         ) 
                     );
             }
@@ -77,6 +80,8 @@ namespace MultipleCameraTracking
 
             ASSERT_TRUE( featureParametersPtr != NULL );
 
+            featureParametersPtr->m_shouldCacheFeatureValues = ( g_configInput.m_cacheFeatureValues != 0 );
+
             return featureParametersPtr;
         }
         EXCEPTION_CATCH_AND_ABORT( "Failed to get the default tracker feature parameters" );
@@ -114,6 +119,8 @@ namespace MultipleCameraTracking
 
             ASSERT_TRUE( featureParametersPtr != NULL );
 
+            featureParametersPtr->m_shouldCacheFeatureValues = ( g_configInput.m_cacheFeatureValues != 0 );
+
             return featureParametersPtr;
         }
         EXCEPTION_CATCH_AND_ABORT( "Failed to get the default appearance fusion feature parameters" );
@@ -191,11 +198,13 @@ namespace MultipleCameraTracking
     /********************************************************************
     InitializeObjectParameters
         Initializes parameters for the object 
-         with initial state and file name for saving its trajectory
+         with initial state and file name for saving its trajectory.
+         The pixel sizes of the config are given at the native resolution
+         and scaled to the processing scale of the camera.
     Exceptions:
         None
     *********************************************************************/
-    void Object::InitializeObjectParameters( const vectorf & initialState, const string & trajSaveStrBase )
+    void Object::InitializeObjectParameters( const vectorf & initialState, const string & trajSaveStrBase, const float processingScale )
     {
         bool success = true;
 
@@ -224,6 +233,9 @@ namespace MultipleCameraTracking
             m_trackerParametersPtr            = TrackerParametersPtr( new SimpleTrackerParameters ( ) );
         }
 
+        //samples of the tracker read the derived images of the camera frames
+        m_trackerPtr->SetFrameImageCache( m_frameImageCachePtr );
+
         Features::FeatureParametersPtr featureParametersPtr = GenerateDefaultTrackerFeatureParameters( );
         
         //determine the total number of weak classifiers
@@ -276,12 +288,12 @@ namespace MultipleCameraTracking
         m_classifierParamPtr->m_featureParametersPtr    =     featureParametersPtr;
 
         // tracker parameters
-        m_trackerParametersPtr->m_posRadiusTrain        =    static_cast<float>( g_configInput.m_posRadiusTrain );
+        m_trackerParametersPtr->m_posRadiusTrain        =    max( 1.0f, static_cast<float>( g_configInput.m_posRadiusTrain ) * processingScale );
         m_trackerParametersPtr->m_numberOfNegativeTrainingSamples            = g_configInput.m_numNegExamples;
 
         m_trackerParametersPtr->m_isColor                = m_colorImage;
         m_trackerParametersPtr->m_init_negNumTrain        = g_configInput.m_initNumNegExampes;
-        m_trackerParametersPtr->m_init_posTrainRadius    = static_cast<float>( g_configInput.m_initPosRadiusTrain );
+        m_trackerParametersPtr->m_init_posTrainRadius    = max( 1.0f, static_cast<float>( g_configInput.m_initPosRadiusTrain ) * processingScale );
         m_trackerParametersPtr->m_initState                = initialState;
         
         m_trackerParametersPtr->m_initializeWithFaceDetection            = DEFAULT_TRACKER_INIT_WITH_FACE;
@@ -289,6 +301,9 @@ namespace MultipleCameraTracking
         m_trackerParametersPtr->m_displayTrainingSampleCenterOnly    = ( g_configInput.m_displayTrainingExampCenterOnly ==1 );
         m_trackerParametersPtr->m_displayFigureNameStr    = "Camera "+int2str(m_cameraID,3) + ", object "+int2str(m_objectID,3);
         m_trackerParametersPtr->m_trajSave                = trajSaveStrBase +"_Object" + int2str( m_objectID, 3 );
+        m_trackerParametersPtr->m_processingScale        = processingScale;
+        m_trackerParametersPtr->m_trajectorySyncInterval= g_configInput.m_trajectorySyncInterval;
+        m_trackerParametersPtr->m_saveTextTrajectory    = ( g_configInput.m_saveTextTrajectories == 1 );
 
         
         if ( m_cameraTrackingParametersPtr->m_localObjectTrackerType == SIMPLE_TRACKER ||
@@ -296,8 +311,9 @@ namespace MultipleCameraTracking
         { 
             SimpleTrackerParametersPtr    simpleTrackerParametersPtr = boost::static_pointer_cast<SimpleTrackerParameters>(m_trackerParametersPtr);            
 
-            simpleTrackerParametersPtr->m_searchWindSize   = g_configInput.m_searchWindowSize;
+            simpleTrackerParametersPtr->m_searchWindSize   = max( 1, cvRound( g_configInput.m_searchWindowSize * processingScale ) );
             simpleTrackerParametersPtr->m_negSampleStrategy= g_configInput.m_negSampleStrategy;            
+            simpleTrackerParametersPtr->m_useDenseSearch   = ( g_configInput.m_denseHaarSearch == 1 && m_cameraTrackingParametersPtr->m_trackerFeatureType == Features::HAAR_LIKE );
         }
 
         // parameters for only the particle filter tracker 
@@ -306,8 +322,8 @@ namespace MultipleCameraTracking
             ParticleFilterTrackerParametersPtr PFTrackerparamsPtr    = boost::static_pointer_cast<ParticleFilterTrackerParameters>(m_trackerParametersPtr);            
             PFTrackerparamsPtr->m_shouldNotUseSigmoid                =    DEFAULT_PFTRACKER_NOT_USE_SIGMOIDAL;    //use sigmoid function to calculate probability if =false
             PFTrackerparamsPtr->m_numberOfParticles                    =    m_cameraTrackingParametersPtr->m_numberOfParticles;
-            PFTrackerparamsPtr->m_standardDeviationX                =    (float)(g_configInput.m_PFTrackerStdDevX);            
-            PFTrackerparamsPtr->m_standardDeviationY                =    (float)(g_configInput.m_PFTrackerStdDevY);    
+            PFTrackerparamsPtr->m_standardDeviationX                =    (float)(g_configInput.m_PFTrackerStdDevX) * processingScale;            
+            PFTrackerparamsPtr->m_standardDeviationY                =    (float)(g_configInput.m_PFTrackerStdDevY) * processingScale;    
             PFTrackerparamsPtr->m_standardDeviationScaleX            =    (float)(g_configInput.m_PFTrackerStdDevScaleX);        
             PFTrackerparamsPtr->m_standardDeviationScaleY            =    (float)(g_configInput.m_PFTrackerStdDevScaleY);        
             PFTrackerparamsPtr->m_maxNumPositiveExamples            =    g_configInput.m_PfTrackerMaxNumPositiveExamples;
@@ -683,4 +699,17 @@ namespace MultipleCameraTracking
         EXCEPTION_CATCH_AND_ABORT( "Failed to Draw Object Foot Point" );
     }
 
+    /********************************************************************
+    ComputeRegionOfInterest
+        Region of the next frame read by the object's tracker.
+    Exceptions:
+        None
+    *********************************************************************/
+    bool    Object::ComputeRegionOfInterest( const int frameWidth, const int frameHeight, IppiRect& regionOfInterest )
+    {
+        ASSERT_TRUE( m_trackerPtr != NULL );
+
+        return m_trackerPtr->ComputeRegionOfInterest( frameWidth, frameHeight, regionOfInterest );
+    }
+
 }
\ No newline at end of file
@@ -29,12 +29,13 @@ namespace MultipleCameraTracking
                 const    int                                            cameraId, 
                 const    bool                                        isColorEnabled,    
                 CameraTrackingParametersPtr                            cameraTrackingParametersPtr,
-                CvMat*                                                pHomographyMatrix );
+                CvMat*                                                pHomographyMatrix,
+                FrameImageCachePtr                                    frameImageCachePtr );
 
         int    GetObjectID( ) const { return m_objectID; };
         
         //Initializes the object parameters with initial state and file name for saving its trajectory
-        void        InitializeObjectParameters( const vectorf& initialState,  const string& trajSaveStrBase );
+        void        InitializeObjectParameters( const vectorf& initialState,  const string& trajSaveStrBase, const float processingScale );
         
         /*****    Basic Object Tracker    *****/
         //    Initialize the tracker for the object
@@ -97,6 +98,9 @@ namespace MultipleCameraTracking
                                                         Matrixu*    pHsvImageMatrix );
 
         void        DrawObjectFootPoint(Matrixu* pFrameDisplay);
+
+        //region of the next frame read by the tracker (false: the whole frame)
+        bool        ComputeRegionOfInterest( const int frameWidth, const int frameHeight, IppiRect& regionOfInterest );
     private:
         DISALLOW_IMPLICIT_CONSTRUCTORS( Object );
 
@@ -106,6 +110,7 @@ namespace MultipleCameraTracking
 
         CameraTrackingParametersPtr                            m_cameraTrackingParametersPtr;
         CvMat*                                                m_pHomographyMatrix;
+        FrameImageCachePtr                                    m_frameImageCachePtr;            //derived images of the camera frames
 
         Classifier::StrongClassifierParametersBasePtr        m_classifierParamPtr;            //Strong Classifier Parameters
         TrackerParametersPtr                                m_trackerParametersPtr;            //Simple Tracker Parameters
@@ -6,6 +6,7 @@
 #include "Public.h"
 #include "Sample.h"
 #include "CommonMacros.h"
+#include "Visualizer.h"
 
 #include <numeric>
 
@@ -50,8 +51,6 @@ namespace MultipleCameraTracking
     {        
         try
         {
-            m_states.Resize( videoLength, 4 );
-            
             // InitializeTracker with face
             if ( trackerParametersPtr->m_initializeWithFaceDetection )
             {  
@@ -71,15 +70,13 @@ namespace MultipleCameraTracking
                 bool success = InitializeTracker( pFrameImageColor, pFrameImageGray, trackerParametersPtr, classifierParameterPtr, pFrameDisplay, pFrameDisplayTraining, pFrameImageHSV );; 
                 ASSERT_TRUE( success );
                 
-                //m_states --> [leftX LeftY scaledWidth scaledHeight]
-                for (int i = 0; i < frameInd; i++)
-                {
-                    m_states(i,0) = 0; m_states(i,1) = 0; m_states(i,2) = 0;m_states(i,3) = 0;
-                }
-                m_states(frameInd,0)    = m_currentStateList[0];                                // left_x
-                m_states(frameInd,1)    = m_currentStateList[1];                                // left_y
-                m_states(frameInd,2)    = ( m_currentStateList[2] * m_currentStateList[4]);        // width * scale
-                m_states(frameInd,3)    = ( m_currentStateList[3] * m_currentStateList[5] );    // height * scale
+                //trajectory --> [leftX LeftY scaledWidth scaledHeight]; no record before the initialization
+                OpenTrajectoryFile( videoLength );
+                StoreState( frameInd,
+                            m_currentStateList[0],                                    // left_x
+                            m_currentStateList[1],                                    // left_y
+                            m_currentStateList[2] * m_currentStateList[4],            // width * scale
+                            m_currentStateList[3] * m_currentStateList[5] );        // height * scale
             }
 
             if ( pGroundTruthMatrix != NULL )
@@ -278,7 +275,7 @@ namespace MultipleCameraTracking
     /********************************************************************
     StoreObjectState
         Store the state of the object in the current frame 
-        (store to matrix m_states and tempFrameDisplay)
+        (append to the trajectory file and tempFrameDisplay)
         (i.e., the frame from the previous call to TrackObjectAndSaveState)
     Exceptions:
         None
@@ -382,11 +379,12 @@ namespace MultipleCameraTracking
                     m_simpleTrackerParamsPtr->m_outputBoxColor[2]    );
             }
 
-            //save to the trajectory matrix
-            m_states(frameind,0) = cvRound( m_currentStateList[0] );
-            m_states(frameind,1) = cvRound( m_currentStateList[1] );
-            m_states(frameind,2) = cvRound( m_currentStateList[2] * m_currentStateList[4] );
-            m_states(frameind,3) = cvRound( m_currentStateList[3] * m_currentStateList[5] );            
+            //append to the trajectory
+            StoreState( frameind,
+                        (float)cvRound( m_currentStateList[0] ),
+                        (float)cvRound( m_currentStateList[1] ),
+                        (float)cvRound( m_currentStateList[2] * m_currentStateList[4] ),
+                        (float)cvRound( m_currentStateList[3] * m_currentStateList[5] ) );
         }
 
         EXCEPTION_CATCH_AND_ABORT("Error while storing the object state" )
@@ -451,7 +449,7 @@ namespace MultipleCameraTracking
         tempFrameDisplay.display(
             ("predicted particles"+m_simpleTrackerParamsPtr->m_displayFigureNameStr).c_str(), 2
             );
-        cvWaitKey(0);        
+        Visualizer::GetInstance().WaitKey(0);        
 
         tempFrameDisplay._keepIpl = false;
         tempFrameDisplay.freeIpl();
@@ -535,7 +533,6 @@ namespace MultipleCameraTracking
                 }
                 probimg.convert2img().display(    ("Probability map, "+ m_simpleTrackerParamsPtr->m_displayFigureNameStr).c_str(),
                                                 2 );
-                cvWaitKey(1);
             }
 
             int bestind, worstind;
@@ -576,7 +573,6 @@ namespace MultipleCameraTracking
                     probimg(m_testSampleSet[k].m_row, m_testSampleSet[k].m_col) = m_liklihoodProbabilityList[k];
                 }
                 probimg.convert2img().display( ("Probability map2, "+ m_simpleTrackerParamsPtr->m_displayFigureNameStr).c_str(), 2 );
-                cvWaitKey(1);
             }
 
             //draw the weight of all unique particles
@@ -598,7 +594,6 @@ namespace MultipleCameraTracking
                 }
 
                 probimg.convert2img().display( ("Particle Weight Before Update:"+ m_simpleTrackerParamsPtr->m_displayFigureNameStr).c_str(), 2 );
-                cvWaitKey(1);
             }
 
             //Update particle weight 
@@ -627,7 +622,6 @@ namespace MultipleCameraTracking
                 }
 
                 probimg.convert2img().display( ("Particle Weight after update:"+ m_simpleTrackerParamsPtr->m_displayFigureNameStr).c_str(), 2 );
-                cvWaitKey(1);
             }
 
             EstimateGroundPoint();
@@ -876,6 +870,7 @@ namespace MultipleCameraTracking
                                 m_positiveSampleSet[i].m_pImgGray    = pFrameImageGray;
                                 m_positiveSampleSet[i].m_pImgColor    = pFrameImageColor;
                                 m_positiveSampleSet[i].m_pImgHSV    = pFrameImageHSV;
+                                m_positiveSampleSet[i].m_pFrameImageCache = m_frameImageCachePtr.get();
                                 m_positiveSampleSet[i].m_col        = leftX;
                                 m_positiveSampleSet[i].m_row        = topY;
                                 m_positiveSampleSet[i].m_height        = cvRound( m_currentStateList[3] );
@@ -1286,6 +1281,13 @@ namespace MultipleCameraTracking
                     //outside images range, assign zero weight
                     m_particleFilterPtr->UpdateParticleWeight(p, 0);
                 }
+                else if ( m_isRestrictedToRegionOfInterest &&
+                          ( leftX < m_regionOfInterest.x || leftX + width >= m_regionOfInterest.x + m_regionOfInterest.width ||
+                            topY < m_regionOfInterest.y || topY + height >= m_regionOfInterest.y + m_regionOfInterest.height ) )
+                {
+                    //outside the prepared part of the frame (a motion beyond PF_REGION_OF_INTEREST_SIGMAS), treated as outside the image
+                    m_particleFilterPtr->UpdateParticleWeight(p, 0);
+                }
                 else if ( particle[4] != 0 ) 
                 {
                     m_testSampleSet.PushBackSample( pFrameImageGray, 
@@ -1304,6 +1306,62 @@ namespace MultipleCameraTracking
         EXCEPTION_CATCH_AND_ABORT( "Failed to generate Test Sample Set" );
     }
 
+    /**************************************************************************
+    ComputeRegionOfInterest
+        Region of the next frame read by the tracker: the particles after
+        a prediction of up to PF_REGION_OF_INTEREST_SIGMAS standard
+        deviations, plus the training sample ring around the new state.
+        Particles predicted beyond it get zero weight.
+    Exceptions:
+        None
+    **************************************************************************/
+    bool    ParticleFilterTracker::ComputeRegionOfInterest( const int frameWidth, const int frameHeight, IppiRect& regionOfInterest )
+    {
+        try
+        {
+            ASSERT_TRUE( m_isInitialized );
+
+            const float maxScale    = m_particleFilterPtr->GetMaxScale();
+            const float maxWidth    = m_currentStateList[2] * maxScale;
+            const float maxHeight    = m_currentStateList[3] * maxScale;
+
+            //bounding box of the particle centers
+            float minX = (float)frameWidth, maxX = 0.0f, minY = (float)frameHeight, maxY = 0.0f;
+            for ( int p = 0; p < m_particleFilterPtr->GetNumberOfParticles(); p++ )
+            {
+                vectorf particle;
+                m_particleFilterPtr->GetParticle( p, particle );
+
+                minX = min( minX, particle[0] );
+                maxX = max( maxX, particle[0] );
+                minY = min( minY, particle[1] );
+                maxY = max( maxY, particle[1] );
+            }
+
+            //the motion is scaled by the particle scale
+            const float motionX            = PF_REGION_OF_INTEREST_SIGMAS * m_particleFilterTrackerParamsPtr->m_standardDeviationX * maxScale;
+            const float motionY            = PF_REGION_OF_INTEREST_SIGMAS * m_particleFilterTrackerParamsPtr->m_standardDeviationY * maxScale;
+            const float trainingRadius    = max( (float)m_simpleTrackerParamsPtr->m_posRadiusTrain, 1.5f*m_simpleTrackerParamsPtr->m_searchWindSize );
+
+            //a sample spans at most one scaled object size from the center it was drawn around
+            const float left    = minX - motionX - trainingRadius - maxWidth;
+            const float top        = minY - motionY - trainingRadius - maxHeight;
+            const float right    = maxX + motionX + trainingRadius + maxWidth;
+            const float bottom    = maxY + motionY + trainingRadius + maxHeight;
+
+            regionOfInterest.x        = max( 0, (int)floor( left ) - 1 );
+            regionOfInterest.y        = max( 0, (int)floor( top ) - 1 );
+            regionOfInterest.width    = min( frameWidth, (int)ceil( right ) + 2 ) - regionOfInterest.x;
+            regionOfInterest.height    = min( frameHeight, (int)ceil( bottom ) + 2 ) - regionOfInterest.y;
+
+            m_regionOfInterest                = regionOfInterest;
+            m_isRestrictedToRegionOfInterest= true;
+        }
+        EXCEPTION_CATCH_AND_ABORT( "Failed to compute the region of interest" );
+
+        return true;
+    }
+
     /**************************************************************************
     UpdateParticleWeights
         Update Particle Weights
@@ -1384,7 +1442,6 @@ namespace MultipleCameraTracking
                 }
                 probimg.convert2img().display(    ("Probability map, "+ m_simpleTrackerParamsPtr->m_displayFigureNameStr).c_str(),
                     2 );
-                cvWaitKey(1);
             }
 
             int bestind, worstind;
@@ -1422,7 +1479,6 @@ namespace MultipleCameraTracking
                     probimg(m_testSampleSet[k].m_row, m_testSampleSet[k].m_col) = m_liklihoodProbabilityList[k];
                 }
                 probimg.convert2img().display( ("Probability map2, "+ m_simpleTrackerParamsPtr->m_displayFigureNameStr).c_str(), 2 );
-                cvWaitKey(1);
             }
 
             //draw the weight of all unique particles
@@ -1444,7 +1500,6 @@ namespace MultipleCameraTracking
                 }
 
                 probimg.convert2img().display( ("Particle Weight Before Update:"+ m_simpleTrackerParamsPtr->m_displayFigureNameStr).c_str(), 2 );
-                cvWaitKey(1);
             }
 
             //Update particle weight 
@@ -1473,7 +1528,6 @@ namespace MultipleCameraTracking
                 }
 
                 probimg.convert2img().display( ("Particle Weight after update:"+ m_simpleTrackerParamsPtr->m_displayFigureNameStr).c_str(), 2 );
-                cvWaitKey(1);
             }
 
             EstimateGroundPoint();        
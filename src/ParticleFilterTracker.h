@@ -6,6 +6,9 @@
 #include "ParticleFilter.h"
 #include "AppearanceBasedInformationFuser.h"
 
+//particle motion (in standard deviations) covered by the region of interest of the tracker
+#define PF_REGION_OF_INTEREST_SIGMAS    4.0f
+
 namespace MultipleCameraTracking
 {
     //Forward Declaration
@@ -31,7 +34,8 @@ namespace MultipleCameraTracking
             m_particleFilterTrackerParamsPtr( ),
             m_pWeightedAverageParticleMatrix( cvCreateMat( 1, 2, CV_32FC1 ) ),
             m_appearanceFuserPtr( appearanceFuserPtr ),
-            m_isAppearanceFusionEnabled( isAppearanceFusionEnabled )
+            m_isAppearanceFusionEnabled( isAppearanceFusionEnabled ),
+            m_isRestrictedToRegionOfInterest( false )
         {
             if ( m_isAppearanceFusionEnabled )
             {
@@ -115,6 +119,9 @@ namespace MultipleCameraTracking
         void            ResumeTracking( ) {};
         virtual void    DrawObjectFootPosition( Matrixu* pFrameDisplay ) const;
 
+        //(override SimpleTracker) region spanned by the predicted particles and the training samples
+        virtual bool    ComputeRegionOfInterest( const int frameWidth, const int frameHeight, IppiRect& regionOfInterest );
+
     protected:
         bool            InitializeTracker(  Matrixu*                pFrameImageColor, 
                                             Matrixu*                pFrameImageGray,  
@@ -163,6 +170,8 @@ namespace MultipleCameraTracking
         CvMat*                                    m_pWeightedAverageParticleMatrix;
         AppearanceBasedInformationFuserPtr        m_appearanceFuserPtr;
         bool                                    m_isAppearanceFusionEnabled;
+        bool                                    m_isRestrictedToRegionOfInterest;    // the frame is prepared only inside m_regionOfInterest
+        IppiRect                                m_regionOfInterest;
     };
 }
 #endif
\ No newline at end of file
@@ -0,0 +1,189 @@
+#include "PrefetchingFrameSource.h"
+
+namespace MultipleCameraTracking
+{
+    /********************************************************************
+    PrefetchingFrameSource
+        Constructor. Decodes the first frame to find the frame size
+        and starts the decoder thread for the remaining frames.
+    Exceptions:
+        None
+    *********************************************************************/
+    PrefetchingFrameSource::PrefetchingFrameSource( const string&    inputPath,
+                                                    const bool        readImages,
+                                                    const int        startFrameIndex,
+                                                    const int        endFrameIndex,
+                                                    const bool        isColor,
+                                                    const int        readAheadSize )
+        : FrameSource( isColor ),
+        m_frameDecoder( inputPath, readImages, startFrameIndex, isColor ),
+        m_frameSlotList( ),
+        m_slotFrameIndexList( ),
+        m_decodedSlotQueue( readAheadSize + 1 ),
+        m_freeSlotQueue( readAheadSize + 1 ),
+        m_currentSlot( -1 ),
+        m_decodedMutex( ),
+        m_decodedCondition( ),
+        m_freeMutex( ),
+        m_freeCondition( ),
+        m_stopDecoding( false )
+    {
+        try
+        {
+            ASSERT_TRUE( readAheadSize > 0 );
+            ASSERT_TRUE( endFrameIndex >= startFrameIndex );
+
+            m_numberOfFrames = endFrameIndex - startFrameIndex + 1;
+
+            //one slot more than the read ahead, which is held by the tracking thread
+            m_frameSlotList.resize( readAheadSize + 1 );
+            m_slotFrameIndexList.assign( readAheadSize + 1, -1 );
+
+            //decode the first frame to get the proper size
+            m_frameDecoder.DecodeFrame( 0, m_frameSlotList[0] );
+            m_slotFrameIndexList[0] = 0;
+            m_decodedSlotQueue.push( 0 );
+
+            m_frameWidth    = m_frameSlotList[0].cols();
+            m_frameHeight    = m_frameSlotList[0].rows();
+
+            for ( int slotIndex = 1; slotIndex < (int)m_frameSlotList.size(); slotIndex++ )
+            {
+                m_freeSlotQueue.push( slotIndex );
+            }
+
+            m_decoderThread = boost::thread( &PrefetchingFrameSource::DecodeFrames, this );
+        }
+        EXCEPTION_CATCH_AND_ABORT( "Failed to construct PrefetchingFrameSource" );
+    }
+
+    /********************************************************************
+    ~PrefetchingFrameSource
+        Destructor. Stops the decoder thread.
+    Exceptions:
+        None
+    *********************************************************************/
+    PrefetchingFrameSource::~PrefetchingFrameSource( )
+    {
+        //set under the lock, so a decoder waiting for a free slot can't miss it
+        {
+            boost::lock_guard<boost::mutex> lock( m_freeMutex );
+            m_stopDecoding = true;
+        }
+        m_freeCondition.notify_one();
+        m_decoderThread.join();
+    }
+
+    /********************************************************************
+    GetFrame
+        Get the frame at the given index. The previously returned frame
+        is given back to the decoder thread. Waits for the decoder if
+        the frame is not ready yet.
+    Exceptions:
+        None
+    *********************************************************************/
+    Matrixu* PrefetchingFrameSource::GetFrame( const int frameInd )
+    {
+        ASSERT_TRUE( frameInd >= 0 && frameInd < m_numberOfFrames );
+
+        if ( m_currentSlot >= 0 )
+        {
+            if ( m_slotFrameIndexList[m_currentSlot] == frameInd )
+            {
+                return &m_frameSlotList[m_currentSlot];
+            }
+
+            if ( frameInd < m_slotFrameIndexList[m_currentSlot] )
+            {
+                abortError( __LINE__, __FILE__, "Frames must be requested in increasing order" );
+            }
+
+            //hand the current frame back to the decoder
+            FreeSlot( m_currentSlot );
+            m_currentSlot = -1;
+        }
+
+        //take decoded frames until the requested one shows up; skipped frames are recycled
+        while ( true )
+        {
+            int slotIndex;
+            if ( !m_decodedSlotQueue.pop( slotIndex ) )
+            {
+                //sleep until the decoder pushes a slot; checked again under the lock so no signal is missed
+                boost::unique_lock<boost::mutex> lock( m_decodedMutex );
+                while ( !m_decodedSlotQueue.pop( slotIndex ) )
+                {
+                    m_decodedCondition.wait( lock );
+                }
+            }
+
+            if ( m_slotFrameIndexList[slotIndex] == frameInd )
+            {
+                m_currentSlot = slotIndex;
+                break;
+            }
+
+            FreeSlot( slotIndex );
+        }
+
+        return &m_frameSlotList[m_currentSlot];
+    }
+
+    /********************************************************************
+    FreeSlot
+        Give a slot back to the decoder thread, waking it if the read
+        ahead was full.
+    Exceptions:
+        None
+    *********************************************************************/
+    void PrefetchingFrameSource::FreeSlot( const int slotIndex )
+    {
+        m_freeSlotQueue.push( slotIndex );
+
+        {
+            boost::lock_guard<boost::mutex> lock( m_freeMutex );
+        }
+        m_freeCondition.notify_one();
+    }
+
+    /********************************************************************
+    DecodeFrames
+        Decoder thread. Decodes the frames in order into the free
+        slots until all the frames are decoded or it is stopped.
+    Exceptions:
+        None
+    *********************************************************************/
+    void PrefetchingFrameSource::DecodeFrames( )
+    {
+        for ( int frameInd = 1; frameInd < m_numberOfFrames && !m_stopDecoding; )
+        {
+            int slotIndex;
+            if ( !m_freeSlotQueue.pop( slotIndex ) )
+            {
+                //read ahead is full: sleep until the tracking thread frees a slot or stops the decoder
+                boost::unique_lock<boost::mutex> lock( m_freeMutex );
+                bool isSlotFree = false;
+                while ( !m_stopDecoding && !( isSlotFree = m_freeSlotQueue.pop( slotIndex ) ) )
+                {
+                    m_freeCondition.wait( lock );
+                }
+                if ( !isSlotFree )
+                {
+                    break;
+                }
+            }
+
+            m_frameDecoder.DecodeFrame( frameInd, m_frameSlotList[slotIndex] );
+            m_slotFrameIndexList[slotIndex] = frameInd;
+            m_decodedSlotQueue.push( slotIndex );
+
+            //wake the tracking thread if it waits for this frame
+            {
+                boost::lock_guard<boost::mutex> lock( m_decodedMutex );
+            }
+            m_decodedCondition.notify_one();
+
+            frameInd++;
+        }
+    }
+}
@@ -0,0 +1,66 @@
+#ifndef PREFETCHING_FRAME_SOURCE_HEADER
+#define PREFETCHING_FRAME_SOURCE_HEADER
+
+#include "FrameSource.h"
+#include "FrameDecoder.h"
+
+#include <boost/thread.hpp>
+#include <boost/atomic.hpp>
+#include <boost/lockfree/spsc_queue.hpp>
+
+namespace MultipleCameraTracking
+{
+    /****************************************************************
+    PrefetchingFrameSource
+        Derives from FrameSource.
+        Owns a background decoder thread that reads ahead a fixed
+        number of frames, so decoding overlaps with tracking.
+        Decoded slots are handed to the tracking thread through a
+        lock-free single-producer/single-consumer queue and returned
+        to the decoder through a second one. The tracking thread
+        sleeps on a condition variable while no decoded frame is
+        ready. Frames must be requested in increasing order.
+    ****************************************************************/
+    class PrefetchingFrameSource : public FrameSource
+    {
+    public:
+        PrefetchingFrameSource( const string&    inputPath,
+                                const bool        readImages,
+                                const int        startFrameIndex,
+                                const int        endFrameIndex,
+                                const bool        isColor,
+                                const int        readAheadSize );
+
+        virtual ~PrefetchingFrameSource( );
+
+        virtual Matrixu*    GetFrame( const int frameInd );
+
+    private:
+        DISALLOW_IMPLICIT_CONSTRUCTORS( PrefetchingFrameSource );
+
+        typedef boost::lockfree::spsc_queue<int>    SlotQueue;
+
+        //body of the decoder thread
+        void                DecodeFrames( );
+
+        //give a slot back to the decoder thread and wake it
+        void                FreeSlot( const int slotIndex );
+
+        FrameDecoder        m_frameDecoder;            //decoder of the input sequence, used by the decoder thread only
+        vector<Matrixu>        m_frameSlotList;        //decoded frames (read-ahead frames + the current frame)
+        vectori                m_slotFrameIndexList;    //frame index held by each slot
+
+        SlotQueue            m_decodedSlotQueue;        //decoder thread -> tracking thread
+        SlotQueue            m_freeSlotQueue;        //tracking thread -> decoder thread
+        int                    m_currentSlot;            //slot held by the tracking thread (-1: none)
+
+        boost::mutex        m_decodedMutex;            //guards the wait for a decoded slot
+        boost::condition_variable    m_decodedCondition;    //signaled by the decoder thread after each decoded slot
+        boost::mutex        m_freeMutex;            //guards the wait for a free slot
+        boost::condition_variable    m_freeCondition;    //signaled by the tracking thread after each freed slot, and on stop
+
+        boost::atomic<bool>    m_stopDecoding;            //asks the decoder thread to finish
+        boost::thread        m_decoderThread;
+    };
+}
+#endif
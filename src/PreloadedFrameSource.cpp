@@ -0,0 +1,60 @@
+#include "PreloadedFrameSource.h"
+
+namespace MultipleCameraTracking
+{
+    /********************************************************************
+    PreloadedFrameSource
+        Constructor. Loads the whole video into the memory.
+    Exceptions:
+        None
+    *********************************************************************/
+    PreloadedFrameSource::PreloadedFrameSource( const string&    inputPath,
+                                                const bool        readImages,
+                                                const int        startFrameIndex,
+                                                const int        endFrameIndex,
+                                                const bool        isColor )
+        : FrameSource( isColor ),
+        m_videoMatrix( )
+    {
+        try
+        {
+            if ( readImages )
+            {
+                m_videoMatrix = Matrixu::LoadVideo( inputPath.c_str(),
+                                                    IMAGE_NAME_PREFIX,
+                                                    IMAGE_TYPE,
+                                                    startFrameIndex,
+                                                    endFrameIndex,
+                                                    IMAGE_NAME_DIGITS,
+                                                    isColor );
+            }
+            else
+            {
+                m_videoMatrix = Matrixu::LoadVideoStream( inputPath.c_str(),
+                                                          startFrameIndex,
+                                                          endFrameIndex,
+                                                          isColor );
+            }
+
+            ASSERT_TRUE( !m_videoMatrix.empty() );
+
+            m_numberOfFrames    = (int)m_videoMatrix.size();
+            m_frameWidth        = m_videoMatrix[0].cols();
+            m_frameHeight        = m_videoMatrix[0].rows();
+        }
+        EXCEPTION_CATCH_AND_ABORT( "Failed to construct PreloadedFrameSource" );
+    }
+
+    /********************************************************************
+    GetFrame
+        Get the frame at the given index.
+    Exceptions:
+        None
+    *********************************************************************/
+    Matrixu* PreloadedFrameSource::GetFrame( const int frameInd )
+    {
+        ASSERT_TRUE( frameInd >= 0 && frameInd < m_numberOfFrames );
+
+        return &m_videoMatrix[frameInd];
+    }
+}
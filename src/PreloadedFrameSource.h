@@ -0,0 +1,33 @@
+#ifndef PRELOADED_FRAME_SOURCE_HEADER
+#define PRELOADED_FRAME_SOURCE_HEADER
+
+#include "FrameSource.h"
+#include "CommonMacros.h"
+
+namespace MultipleCameraTracking
+{
+    /****************************************************************
+    PreloadedFrameSource
+        Derives from FrameSource.
+        Decodes the whole input sequence into memory at construction.
+    ****************************************************************/
+    class PreloadedFrameSource : public FrameSource
+    {
+    public:
+        PreloadedFrameSource( const string&    inputPath,
+                              const bool    readImages,
+                              const int        startFrameIndex,
+                              const int        endFrameIndex,
+                              const bool    isColor );
+
+        virtual ~PreloadedFrameSource( ) { }
+
+        virtual Matrixu*    GetFrame( const int frameInd );
+
+    private:
+        DISALLOW_IMPLICIT_CONSTRUCTORS( PreloadedFrameSource );
+
+        vector<Matrixu>        m_videoMatrix;        //Input video Sequence for tracking
+    };
+}
+#endif
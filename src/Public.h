@@ -28,8 +28,10 @@
 
 #include <boost/shared_ptr.hpp>
 
-#include "ipp.h"
-#if !defined(WIN64)
+#include "MatrixBackend.h"
+#if defined(MATRIX_BACKEND_PORTABLE)
+    // no IPP libraries to link
+#elif !defined(WIN64)
     #pragma comment(lib,"ippi.lib")
     #pragma comment(lib,"ippm.lib")
     #pragma comment(lib,"ippcore.lib")
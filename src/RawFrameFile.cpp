@@ -0,0 +1,84 @@
+#include "RawFrameFile.h"
+#include "CommonMacros.h"
+
+namespace MultipleCameraTracking
+{
+    /****************************************************************
+    RawFrameFile::Write
+        Decodes all the frames of the frame source and writes them
+        to the given raw frame file.
+    Exceptions:
+        None
+    ****************************************************************/
+    void    RawFrameFile::Write( FrameSourcePtr frameSourcePtr, const int startFrameIndex, const string& rawFrameFileName )
+    {
+        try
+        {
+            ASSERT_TRUE( frameSourcePtr != NULL );
+
+            RawFrameFileHeader header;
+            memset( &header, 0, sizeof(header) );
+            memcpy( header.m_magic, RAW_FRAME_FILE_MAGIC, sizeof(header.m_magic) );
+            header.m_width            = frameSourcePtr->GetFrameWidth();
+            header.m_height            = frameSourcePtr->GetFrameHeight();
+            header.m_channels        = frameSourcePtr->IsColor() ? 3 : 1;
+            header.m_frameCount        = frameSourcePtr->GetNumberOfFrames();
+            header.m_startFrameIndex= startFrameIndex;
+            header.m_frameStride    = GetFrameStride( header.m_width, header.m_height, header.m_channels );
+
+            FILE* pFile = fopen( rawFrameFileName.c_str(), "wb" );
+            if ( pFile == NULL )
+            {
+                abortError( __LINE__, __FILE__, "Error opening raw frame file for output" );
+            }
+
+            //the header occupies the first page
+            vector<char> pageBuffer( header.m_frameStride, 0 );
+            memcpy( &pageBuffer[0], &header, sizeof(header) );
+            ASSERT_TRUE( fwrite( &pageBuffer[0], 1, RAW_FRAME_FILE_PAGE_SIZE, pFile ) == RAW_FRAME_FILE_PAGE_SIZE );
+
+            for ( int frameInd = 0; frameInd < (int)header.m_frameCount; frameInd++ )
+            {
+                Matrixu* pFrame = frameSourcePtr->GetFrame( frameInd );
+                ASSERT_TRUE( pFrame != NULL );
+                ASSERT_TRUE( pFrame->depth() == (int)header.m_channels );
+                ASSERT_TRUE( pFrame->cols() == (int)header.m_width && pFrame->rows() == (int)header.m_height );
+
+                //copy the planes row by row into one contiguous, page padded frame
+                char* pDestination = &pageBuffer[0];
+                for ( int channel = 0; channel < pFrame->depth(); channel++ )
+                {
+                    for ( int row = 0; row < pFrame->rows(); row++ )
+                    {
+                        memcpy( pDestination, &(*pFrame)( row, 0, channel ), header.m_width );
+                        pDestination += header.m_width;
+                    }
+                }
+
+                if ( fwrite( &pageBuffer[0], 1, header.m_frameStride, pFile ) != header.m_frameStride )
+                {
+                    abortError( __LINE__, __FILE__, "Error writing raw frame file" );
+                }
+
+                LOG_CONSOLE( ERASELINE << "Converting to raw frames: " << frameInd + 1 << "/" << header.m_frameCount );
+            }
+
+            LOG_CONSOLE( endl );
+            fclose( pFile );
+        }
+        EXCEPTION_CATCH_AND_ABORT( "Failed to write the raw frame file" );
+    }
+
+    /****************************************************************
+    RawFrameFile::GetFrameStride
+        Size of one frame in the file, rounded up to the page size.
+    Exceptions:
+        None
+    ****************************************************************/
+    unsigned int    RawFrameFile::GetFrameStride( const unsigned int width, const unsigned int height, const unsigned int channels )
+    {
+        const unsigned int frameSize = width * height * channels;
+
+        return ( ( frameSize + RAW_FRAME_FILE_PAGE_SIZE - 1 ) / RAW_FRAME_FILE_PAGE_SIZE ) * RAW_FRAME_FILE_PAGE_SIZE;
+    }
+}
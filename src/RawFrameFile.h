@@ -0,0 +1,46 @@
+#ifndef RAW_FRAME_FILE_HEADER
+#define RAW_FRAME_FILE_HEADER
+
+#include "FrameSource.h"
+
+#define RAW_FRAME_FILE_MAGIC        "MCTRAW01"
+#define RAW_FRAME_FILE_PAGE_SIZE    4096
+#define RAW_FRAME_FILE_EXTENSION    ".raw"
+
+namespace MultipleCameraTracking
+{
+    /****************************************************************
+    RawFrameFileHeader
+        Header at the beginning of a raw frame file. It occupies
+        the first page of the file; the frames follow, each one
+        starting on a page boundary. A frame is stored as planes
+        (R, G, B or gray) of width x height bytes, the same layout
+        as Matrixu.
+    ****************************************************************/
+    struct RawFrameFileHeader
+    {
+        char            m_magic[8];            //RAW_FRAME_FILE_MAGIC
+        unsigned int    m_width;            //frame width in pixels
+        unsigned int    m_height;            //frame height in pixels
+        unsigned int    m_channels;            //1: gray, 3: RGB
+        unsigned int    m_frameCount;        //number of frames in the file
+        unsigned int    m_startFrameIndex;    //index of the first frame in the original input
+        unsigned int    m_frameStride;        //bytes between two frames (multiple of the page size)
+    };
+
+    /****************************************************************
+    RawFrameFile
+        Converts the frames of a frame source into an uncompressed,
+        page-aligned raw frame file, which can be memory mapped by
+        MappedFrameSource on later runs.
+    ****************************************************************/
+    class RawFrameFile
+    {
+    public:
+        //static functions
+        static void            Write( FrameSourcePtr frameSourcePtr, const int startFrameIndex, const string& rawFrameFileName );
+
+        static unsigned int    GetFrameStride( const unsigned int width, const unsigned int height, const unsigned int channels );
+    };
+}
+#endif
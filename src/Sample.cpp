@@ -17,7 +17,8 @@ namespace Classifier
         m_pImgHSV( NULL ),
         m_scaleX( 1 ),
         m_scaleY( 1 ),
-        m_cameraID( 0 )
+        m_cameraID( 0 ),
+        m_pFrameImageCache( NULL )
     {
     }
 
@@ -47,7 +48,8 @@ namespace Classifier
         m_pImgHSV( imgHSV ),
         m_scaleX( scaleX ),
         m_scaleY( scaleY ),
-        m_cameraID( 0 )
+        m_cameraID( 0 ),
+        m_pFrameImageCache( NULL )
     {
         ASSERT_TRUE( m_row >= 0 && m_col >= 0 && m_height >= 0 && m_width >= 0 && m_scaleY > 0 && m_scaleX );
     }
@@ -64,6 +66,7 @@ namespace Classifier
         m_pImgGray    = sample.m_pImgGray;
         m_pImgColor    = sample.m_pImgColor;
         m_pImgHSV    = sample.m_pImgHSV;
+        m_pFrameImageCache = sample.m_pFrameImageCache;
 
         m_row        = sample.m_row;
         m_col        = sample.m_col;
@@ -74,4 +77,52 @@ namespace Classifier
         
         return (*this);
     }
+
+    /****************************************************************
+    Sample::GetGrayImage
+        Gray image of the sample, taken from the frame image cache
+        if none was attached.
+    Exceptions:
+        None
+    ****************************************************************/
+    Matrixu* Sample::GetGrayImage( ) const
+    {
+        if ( m_pImgGray == NULL && m_pFrameImageCache != NULL )
+        {
+            return m_pFrameImageCache->GetGrayImage( );
+        }
+        return m_pImgGray;
+    }
+
+    /****************************************************************
+    Sample::GetHSVImage
+        HSV image of the sample, taken from the frame image cache
+        if none was attached.
+    Exceptions:
+        None
+    ****************************************************************/
+    Matrixu* Sample::GetHSVImage( ) const
+    {
+        if ( m_pImgHSV == NULL && m_pFrameImageCache != NULL )
+        {
+            return m_pFrameImageCache->GetHSVImage( );
+        }
+        return m_pImgHSV;
+    }
+
+    /****************************************************************
+    Sample::GetColorBinImage
+        Color histogram bin index image of the frame the sample
+        originates, NULL if the sample has no frame image cache.
+    Exceptions:
+        None
+    ****************************************************************/
+    const int* Sample::GetColorBinImage( const int numberOfBins, const bool useHSVColorSpace ) const
+    {
+        if ( m_pFrameImageCache == NULL )
+        {
+            return NULL;
+        }
+        return m_pFrameImageCache->GetColorBinImage( numberOfBins, useHSVColorSpace );
+    }
 }
@@ -4,6 +4,7 @@
 #include "Matrix.h"
 #include "Public.h"
 #include "CommonMacros.h"
+#include "FrameImageCache.h"
 
 namespace Classifier
 {
@@ -33,8 +34,11 @@ namespace Classifier
         Sample&    operator = ( const Sample& sample );
 
         Matrixu* GetColorImage( ) const { return m_pImgColor; }
-        Matrixu* GetGrayImage( ) const    { return m_pImgGray; }
-        Matrixu* GetHSVImage( ) const    { return m_pImgHSV;}
+        Matrixu* GetGrayImage( ) const;
+        Matrixu* GetHSVImage( ) const;
+
+        //per pixel color histogram bin index of the frame (NULL if not available)
+        const int* GetColorBinImage( const int numberOfBins, const bool useHSVColorSpace ) const;
 
     public:
 
@@ -49,6 +53,7 @@ namespace Classifier
         float                m_scaleX;
         float                m_scaleY;
         int                    m_cameraID; //which camera the sample originates
+        FrameImageCache*    m_pFrameImageCache; //derived images of the frame the sample originates (may be NULL)
     };
 }
 #endif
\ No newline at end of file
@@ -10,7 +10,12 @@ namespace Classifier
     ****************************************************************/
     SampleSet::SampleSet( )
         : m_sampleList( ),
-        m_featureMatrix( )
+        m_featureMatrix( ),
+        m_isFeatureComputed( ),
+        m_pFrameImageCache( NULL ),
+        m_denseGridSample( ),
+        m_denseGridRows( 0 ),
+        m_denseGridColumns( 0 )
     {
     }
 
@@ -21,6 +26,9 @@ namespace Classifier
         None
     ****************************************************************/
     SampleSet::SampleSet( const Sample& sample )
+        : m_pFrameImageCache( sample.m_pFrameImageCache ),
+        m_denseGridRows( 0 ),
+        m_denseGridColumns( 0 )
     {
         m_sampleList.push_back(sample); 
     }
@@ -28,15 +36,28 @@ namespace Classifier
 
     /****************************************************************
     Classifier::SampleSet::ResizeFeatures
-        resize the feature matrix to new size
+        resize the feature matrix to new size. The features already
+        computed are kept if neither the number of features nor the
+        number of samples changes.
     Exceptions:
         None
     ****************************************************************/
     void    SampleSet::ResizeFeatures( size_t newSize )
     {
-        m_featureMatrix.resize(newSize);
+        size_t numberOfSamples = Size();
 
-        size_t numberOfSamples = m_sampleList.size();
+        bool isShapeChanged = ( m_featureMatrix.size() != newSize );
+        for ( size_t k=0; k < m_featureMatrix.size() && !isShapeChanged; k++ )
+        {
+            isShapeChanged = ( m_featureMatrix[k].size() != numberOfSamples );
+        }
+
+        if ( isShapeChanged )
+        {
+            m_isFeatureComputed.assign( newSize, 0 );
+        }
+
+        m_featureMatrix.resize(newSize);
 
         if ( numberOfSamples > 0 )
         {
@@ -47,6 +68,72 @@ namespace Classifier
         }
     }
 
+    /****************************************************************
+    Classifier::SampleSet::IsFeatureComputed
+        true if all the features of the samples are computed
+    Exceptions:
+        None
+    ****************************************************************/
+    bool    SampleSet::IsFeatureComputed( ) const
+    {
+        if ( m_featureMatrix.empty() || Size() == 0 || m_featureMatrix[0].size() == 0 )
+        {
+            return false;
+        }
+
+        for ( size_t k=0; k < m_isFeatureComputed.size(); k++ )
+        {
+            if ( m_isFeatureComputed[k] == 0 )
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /****************************************************************
+    Classifier::SampleSet::IsFeatureComputed
+        true if the listed features of the samples are computed
+    Exceptions:
+        None
+    ****************************************************************/
+    bool    SampleSet::IsFeatureComputed( const vectori& featureIndices ) const
+    {
+        if ( Size() == 0 )
+        {
+            return false;
+        }
+
+        for ( size_t k=0; k < featureIndices.size(); k++ )
+        {
+            if ( !IsFeatureComputed( featureIndices[k] ) )
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /****************************************************************
+    Classifier::SampleSet::GetSamplePosition
+        row and column of the top left corner of the given sample
+    Exceptions:
+        None
+    ****************************************************************/
+    void    SampleSet::GetSamplePosition( int sampleIndex, int& row, int& col ) const
+    {
+        if ( IsDenseGrid() )
+        {
+            row = m_denseGridSample.m_row + sampleIndex / m_denseGridColumns;
+            col = m_denseGridSample.m_col + sampleIndex % m_denseGridColumns;
+        }
+        else
+        {
+            row = m_sampleList[sampleIndex].m_row;
+            col = m_sampleList[sampleIndex].m_col;
+        }
+    }
+
     /****************************************************************
     Classifier::SampleSet::PushBackSample
         Pushes the sample into the list.
@@ -65,6 +152,7 @@ namespace Classifier
                                         float        scaleY )
     { 
         Classifier::Sample sample( pGrayImageMatrix, y ,x, width ,height, weight, pRGBImageMatrix, pHSVImageMatrix, scaleX, scaleY ); 
+        sample.m_pFrameImageCache = m_pFrameImageCache;
         PushBackSample(sample); 
     }
 
@@ -152,6 +240,7 @@ namespace Classifier
                         m_sampleList[validSampleIndex].m_width        = width;
                         m_sampleList[validSampleIndex].m_pImgColor    = pRGBImageMatrix;
                         m_sampleList[validSampleIndex].m_pImgHSV    = pHSVImageMatrix;
+                        m_sampleList[validSampleIndex].m_pFrameImageCache = m_pFrameImageCache;
                         m_sampleList[validSampleIndex].m_scaleX        = scaleX;
                         m_sampleList[validSampleIndex].m_scaleY        = scaleY;
                         validSampleIndex++;
@@ -167,6 +256,66 @@ namespace Classifier
         EXCEPTION_CATCH_AND_ABORT( "Failed to sample images in the given ring of interest" );
     }
 
+    /****************************************************************
+    SampleImageDensely
+        Takes all the locations of the square of the given radius
+        around (x,y) whose samples fit in the image, the same bounds
+        as the ring sampling above, as a dense grid: a single sample
+        for the top left location and the grid size, instead of one
+        sample per location. Features of a dense grid are computed as
+        response maps over the grid (Haar features only).
+    Exceptions:
+        None
+    ****************************************************************/
+    void    SampleSet::SampleImageDensely(    Matrixu*    pGrayImageMatrix,
+                                        int            x, 
+                                        int            y,
+                                        int            width,
+                                        int            height,
+                                        float        radius,
+                                        Matrixu*    pRGBImageMatrix, 
+                                        Matrixu*    pHSVImageMatrix,
+                                        float        scaleX, 
+                                        float        scaleY )
+    {
+        try
+        {
+            ASSERT_TRUE( pGrayImageMatrix != NULL );
+
+            int scaledWidth        = cvRound( float(width) * scaleX );
+            int scaledHeight    = cvRound( float(height)* scaleY );
+
+            int numberOfRows    = pGrayImageMatrix->rows() - scaledHeight - 1;
+            int numberOfColumns    = pGrayImageMatrix->cols() - scaledWidth - 1;
+
+            int minrow = max( 0, y - (int)radius );
+            int maxrow = min( numberOfRows - 1, y + (int)radius );
+            int mincol = max( 0, x - (int)radius );
+            int maxcol = min( numberOfColumns - 1, x + (int)radius );
+
+            m_sampleList.clear();
+
+            m_denseGridSample.m_pImgGray        = pGrayImageMatrix;
+            m_denseGridSample.m_pImgColor        = pRGBImageMatrix;
+            m_denseGridSample.m_pImgHSV            = pHSVImageMatrix;
+            m_denseGridSample.m_pFrameImageCache = m_pFrameImageCache;
+            m_denseGridSample.m_row                = minrow;
+            m_denseGridSample.m_col                = mincol;
+            m_denseGridSample.m_width            = width;
+            m_denseGridSample.m_height            = height;
+            m_denseGridSample.m_scaleX            = scaleX;
+            m_denseGridSample.m_scaleY            = scaleY;
+
+            m_denseGridRows        = max( 0, maxrow - minrow + 1 );
+            m_denseGridColumns    = max( 0, maxcol - mincol + 1 );
+            if ( m_denseGridRows == 0 || m_denseGridColumns == 0 )
+            {
+                m_denseGridRows = m_denseGridColumns = 0;
+            }
+        }
+        EXCEPTION_CATCH_AND_ABORT( "Failed to sample the image densely" );
+    }
+
     /****************************************************************
     SampleImage
         Samples the image (constraint by two rectangles) and stores the sample in a list.
@@ -244,6 +393,7 @@ namespace Classifier
                         m_sampleList[validSampleIndex].m_width        = width;
                         m_sampleList[validSampleIndex].m_pImgColor    = pRGBImageMatrix;
                         m_sampleList[validSampleIndex].m_pImgHSV    = pHSVImageMatrix;
+                        m_sampleList[validSampleIndex].m_pFrameImageCache = m_pFrameImageCache;
                         m_sampleList[validSampleIndex].m_scaleX        = scaleX;
                         m_sampleList[validSampleIndex].m_scaleY        = scaleY;
                         validSampleIndex++;
@@ -315,6 +465,7 @@ namespace Classifier
                 m_sampleList[i].m_width        = w;
                 m_sampleList[i].m_pImgColor = pRGBImageMatrix;
                 m_sampleList[i].m_pImgHSV    = pHSVImageMatrix;
+                m_sampleList[i].m_pFrameImageCache = m_pFrameImageCache;
                 m_sampleList[i].m_scaleX    = scaleX;
                 m_sampleList[i].m_scaleY    = scaleY;
             }
@@ -18,12 +18,19 @@ namespace Classifier
         SampleSet( const Sample& s );
 
         //sample list related
-        const size_t        Size() const { return m_sampleList.size(); };
+        const size_t        Size() const { return IsDenseGrid() ? (size_t)m_denseGridRows*m_denseGridColumns : m_sampleList.size(); };
         //Careful while using Resize, its a partial clearing.
         void                Resize( size_t newSize ) { m_sampleList.resize(newSize); };
-        void                Clear() { m_featureMatrix.clear(); m_sampleList.clear(); };
+        void                Clear() { m_featureMatrix.clear(); m_isFeatureComputed.clear(); m_sampleList.clear(); m_denseGridRows = m_denseGridColumns = 0; };
         Classifier::Sample &            operator[] (const int sampleIndex)  { return m_sampleList[sampleIndex]; };
 
+        //dense grid: the samples are all the locations of a rectangle, row by row, with no Sample per location (no operator[])
+        bool                IsDenseGrid( ) const { return m_denseGridRows > 0; };
+        const Classifier::Sample&    GetDenseGridSample( ) const { return m_denseGridSample; };    //the sample at the top left location
+        int                    GetDenseGridRows( ) const { return m_denseGridRows; };
+        int                    GetDenseGridColumns( ) const { return m_denseGridColumns; };
+        void                GetSamplePosition( int sampleIndex, int& row, int& col ) const;
+
         void                PushBackSample( const Classifier::Sample &s ) { m_sampleList.push_back(s); };
         void                PushBackSample(    Matrixu*    pGrayImageMatrix,
                                             int            x, 
@@ -36,12 +43,18 @@ namespace Classifier
                                             float        scaleX = 1.0,
                                             float        scaleY = 1.0 );
 
-        //feature matrix related
+        //frame image cache stamped on the samples created by this set
+        void                SetFrameImageCache( FrameImageCache* pFrameImageCache ) { m_pFrameImageCache = pFrameImageCache; };
+
+        //feature matrix related; a resize that changes the shape marks all features not computed
         void                ResizeFeatures( size_t newSize );    
         float &                GetFeatureValue( int sample, int ftr) { return m_featureMatrix[ftr](sample); };
         float                GetFeatureValue( int sample, int ftr) const { return m_featureMatrix[ftr](sample); };
         Matrixf                FeatureValues(int ftr) const { return m_featureMatrix[ftr]; };
-        bool                IsFeatureComputed( ) const { return !m_featureMatrix.empty() && !m_sampleList.empty() && m_featureMatrix[0].size()>0; };
+        bool                IsFeatureComputed( ) const;                                    //all the features
+        bool                IsFeatureComputed( const vectori& featureIndices ) const;    //the listed features
+        bool                IsFeatureComputed( int ftr ) const { return ftr < (int)m_isFeatureComputed.size() && m_isFeatureComputed[ftr] != 0; };
+        void                SetFeatureComputed( int ftr ) { m_isFeatureComputed[ftr] = 1; };
         
         //Classifier::Sample images in the given ring of interest
         void                 SampleImage(    Matrixu*    pGrayImageMatrix,
@@ -68,6 +81,18 @@ namespace Classifier
                                             float        scaleY            =    1 );
         
 
+        //all the locations of the square of the given radius around (x,y), as a dense grid
+        void                SampleImageDensely(    Matrixu*    pGrayImageMatrix,
+                                                int            x, 
+                                                int            y,
+                                                int            width,
+                                                int            height,
+                                                float        radius,
+                                                Matrixu*    pRGBImageMatrix    = NULL, 
+                                                Matrixu*    pHSVImageMatrix    = NULL,
+                                                float        scaleX            = 1, 
+                                                float        scaleY            = 1 );
+
         //sample image between two rectangles
         void                SampleImage(    Matrixu*    pGrayImageMatrix,
                                             int            x, 
@@ -91,6 +116,11 @@ namespace Classifier
 
         vector<Classifier::Sample>        m_sampleList;
         vector<Matrixf>                    m_featureMatrix;
+        vector<char>                    m_isFeatureComputed;    //per feature column
+        FrameImageCache*                m_pFrameImageCache;    //derived images of the frame the samples are taken from
+        Classifier::Sample                m_denseGridSample;    //dense grid: the sample at its top left location
+        int                                m_denseGridRows;    //dense grid size, 0 if the samples are listed
+        int                                m_denseGridColumns;
     };
 }
 #endif
\ No newline at end of file
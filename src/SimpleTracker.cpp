@@ -46,6 +46,8 @@ namespace MultipleCameraTracking
 
             //create positive and negative sample sets
             Classifier::SampleSet positiveSampleSet, negativeSampleSet;
+            positiveSampleSet.SetFrameImageCache( m_frameImageCachePtr.get() );
+            negativeSampleSet.SetFrameImageCache( m_frameImageCachePtr.get() );
 
             LOG( "Initializing Simple Tracker..." << endl );
             LOG( "Initial object state: ["
@@ -152,11 +154,8 @@ namespace MultipleCameraTracking
                                         m_simpleTrackerParamsPtr->m_outputBoxColor[2] );                
             }
 
-            //save the state to states matrix
-            for( int s=0; s<4; s++ ) 
-            {
-                m_states(frameind,s) = m_currentStateList[s];
-            }
+            //append the state to the trajectory
+            StoreState( frameind, m_currentStateList[0], m_currentStateList[1], m_currentStateList[2], m_currentStateList[3] );
         }
         EXCEPTION_CATCH_AND_ABORT("Error while tracking and saving the object state" )
     }
@@ -309,23 +308,43 @@ namespace MultipleCameraTracking
                 
                 for( uint k=0; k < (uint)m_testSampleSet.Size(); k++ )
                 {
-                    probimg( m_testSampleSet[k].m_row, m_testSampleSet[k].m_col ) = m_liklihoodProbabilityList[k];
+                    int row, col;
+                    m_testSampleSet.GetSamplePosition( k, row, col );
+                    if ( IsInsideSearchWindow( k ) )
+                    {
+                        probimg( row, col ) = m_liklihoodProbabilityList[k];
+                    }
                 }    
 
                 probimg.convert2img().display(
                     ("Probability map, "+m_simpleTrackerParamsPtr->m_displayFigureNameStr).c_str(),
                     2 );                
-                cvWaitKey(1);
             }
 
             // find the best location - maximum probability
-            int bestind = max_idx( m_liklihoodProbabilityList );
+            int bestind = -1;
+            if ( m_testSampleSet.IsDenseGrid() )
+            {
+                for ( int k = 0; k < (int)m_testSampleSet.Size(); k++ )
+                {
+                    if ( IsInsideSearchWindow( k ) && ( bestind < 0 || m_liklihoodProbabilityList[k] > m_liklihoodProbabilityList[bestind] ) )
+                    {
+                        bestind = k;
+                    }
+                }
+            }
+            else
+            {
+                bestind = max_idx( m_liklihoodProbabilityList );
+            }
+            ASSERT_TRUE( bestind >= 0 );
             double resp = m_liklihoodProbabilityList[bestind];
 
             //set the y and x positions
-            
-            m_currentStateList[1] = (float)m_testSampleSet[bestind].m_row;
-            m_currentStateList[0] = (float)m_testSampleSet[bestind].m_col;
+            int bestRow, bestCol;
+            m_testSampleSet.GetSamplePosition( bestind, bestRow, bestCol );
+            m_currentStateList[1] = (float)bestRow;
+            m_currentStateList[0] = (float)bestCol;
 
             LOG( "SimpleTracker: Update object state to: ["<<m_currentStateList[0] <<" "<<m_currentStateList[1] 
             << " "<<m_currentStateList[2] <<" "<< m_currentStateList[3] << "]."<<endl );
@@ -478,6 +497,20 @@ namespace MultipleCameraTracking
             // Clear the test sample before using
             m_testSampleSet.Clear();
 
+            // the square around the search window as one grid, evaluated as feature response maps
+            if ( m_simpleTrackerParamsPtr->m_useDenseSearch && pFrameImageGray != NULL )
+            {
+                m_testSampleSet.SampleImageDensely( pFrameImageGray,
+                                                    (int)m_currentStateList[0],
+                                                    (int)m_currentStateList[1],
+                                                    (int)m_currentStateList[2],
+                                                    (int)m_currentStateList[3],
+                                                    (float)m_simpleTrackerParamsPtr->m_searchWindSize,
+                                                    pFrameImageColor,
+                                                    pFrameImageHSV );
+                return;
+            }
+
             // run current classifier on search window
             m_testSampleSet.SampleImage( pFrameImageGray,            //image
                                         (int)m_currentStateList[0],    //x - position
@@ -492,7 +525,76 @@ namespace MultipleCameraTracking
         EXCEPTION_CATCH_AND_ABORT( "Failed to generate Test Sample Set" );
     }
 
+    /********************************************************************
+    IsInsideSearchWindow
+        A dense test grid covers the square around the search window;
+        only its locations inside the circle are candidates, the same
+        locations as sampled one by one. Listed samples are all inside.
+    Exceptions:
+        None
+    *********************************************************************/
+    bool    SimpleTracker::IsInsideSearchWindow( const int sampleIndex ) const
+    {
+        if ( !m_testSampleSet.IsDenseGrid() )
+        {
+            return true;
+        }
+
+        int row, col;
+        m_testSampleSet.GetSamplePosition( sampleIndex, row, col );
+
+        const int   x                    = (int)m_currentStateList[0];
+        const int   y                    = (int)m_currentStateList[1];
+        const float searchWindowSize    = (float)m_simpleTrackerParamsPtr->m_searchWindSize;
+        const int    distance            = (y-row)*(y-row) + (x-col)*(x-col);
+
+        return distance < searchWindowSize*searchWindowSize;
+    }
+
     
+    /********************************************************************
+    ComputeRegionOfInterest
+        Region of the next frame read by the tracker: the search window
+        around the current state, plus the training sample ring around
+        the state found inside it.
+    Exceptions:
+        None
+    *********************************************************************/
+    bool    SimpleTracker::ComputeRegionOfInterest( const int frameWidth, const int frameHeight, IppiRect& regionOfInterest )
+    {
+        //negative samples from all over the image
+        if ( m_simpleTrackerParamsPtr->m_negSampleStrategy == 0 )
+        {
+            return false;
+        }
+
+        const float trainingRadius    = max( (float)m_simpleTrackerParamsPtr->m_posRadiusTrain, 1.5f*m_simpleTrackerParamsPtr->m_searchWindSize );
+        const int    reach            = (int)ceil( m_simpleTrackerParamsPtr->m_searchWindSize + trainingRadius ) + 1;
+
+        regionOfInterest.x            = max( 0, (int)m_currentStateList[0] - reach );
+        regionOfInterest.y            = max( 0, (int)m_currentStateList[1] - reach );
+        regionOfInterest.width        = min( frameWidth, (int)m_currentStateList[0] + (int)m_currentStateList[2] + reach + 1 ) - regionOfInterest.x;
+        regionOfInterest.height        = min( frameHeight, (int)m_currentStateList[1] + (int)m_currentStateList[3] + reach + 1 ) - regionOfInterest.y;
+
+        return true;
+    }
+
+    /********************************************************************
+    SetFrameImageCache
+        Share the derived images of the camera frames with the samples
+        generated by the tracker.
+    Exceptions:
+        None
+    *********************************************************************/
+    void    SimpleTracker::SetFrameImageCache( FrameImageCachePtr frameImageCachePtr )
+    {
+        m_frameImageCachePtr = frameImageCachePtr;
+
+        m_positiveSampleSet.SetFrameImageCache( m_frameImageCachePtr.get() );
+        m_negativeSampleSet.SetFrameImageCache( m_frameImageCachePtr.get() );
+        m_testSampleSet.SetFrameImageCache( m_frameImageCachePtr.get() );
+    }
+
     /********************************************************************
     SaveStates
         Saves States and clean up all video output
@@ -503,11 +605,19 @@ namespace MultipleCameraTracking
     {
         try
         {
-            // save states
-            if( !m_simpleTrackerParamsPtr->m_trajSave.empty() )
+            if( m_trajectoryFilePtr == NULL )
             {
-                //write into the specified text file
-                bool scs = m_states.DLMWrite( (m_simpleTrackerParamsPtr->m_trajSave+".txt").c_str() );
+                return;
+            }
+
+            //the states were written as they became final
+            m_trajectoryFilePtr->Close( );
+
+            // convert to the text layout
+            if( m_simpleTrackerParamsPtr->m_saveTextTrajectory )
+            {
+                bool scs = TrajectoryFile::ConvertToText( m_simpleTrackerParamsPtr->m_trajSave + TRAJECTORY_FILE_EXTENSION,
+                                                          m_simpleTrackerParamsPtr->m_trajSave + ".txt" );
                 if( !scs )
                 {
                     abortError(__LINE__,__FILE__,"error saving states to trajectory file");
@@ -534,9 +644,6 @@ namespace MultipleCameraTracking
                                                             Matrixu*                pFrameImageHSV,
                                                             Matrixf*                pGroundTruthMatrix ) 
     {    
-        // Resize the state matrix to correct size
-        m_states.Resize( videoLength, 4 );
-        
         // initialization
         if ( simpleTrackerParametersPtr->m_initializeWithFaceDetection )
         { //***********needs to be corrected 
@@ -554,15 +661,9 @@ namespace MultipleCameraTracking
 
             InitializeTracker( pFrameImageColor, pFrameImageGray, simpleTrackerParametersPtr, classifierParametersPtr, pFrameDisplay, pFrameDisplayTraining, pFrameImageHSV );
 
-            for (int i = 0; i < frameInd; i++)
-            {
-                m_states(i,0) = 0; m_states(i,1) = 0; m_states(i,2) = 0;m_states(i,3) = 0;
-            }
-            //store the state to state matrix
-            m_states(frameInd,0) = m_currentStateList[0];
-            m_states(frameInd,1) = m_currentStateList[1];
-            m_states(frameInd,2) = m_currentStateList[2];
-            m_states(frameInd,3) = m_currentStateList[3];
+            //the frames before the initialization have no record (zeros in the text layout)
+            OpenTrajectoryFile( videoLength );
+            StoreState( frameInd, m_currentStateList[0], m_currentStateList[1], m_currentStateList[2], m_currentStateList[3] );
         }
 
         if( pGroundTruthMatrix != NULL )
@@ -572,6 +673,43 @@ namespace MultipleCameraTracking
         }
     }
 
+    /********************************************************************
+    OpenTrajectoryFile
+        Create the trajectory file of the object, if it is saved.
+    Exceptions:
+        None
+    *********************************************************************/
+    void SimpleTracker::OpenTrajectoryFile( const uint videoLength )
+    {
+        if ( m_simpleTrackerParamsPtr->m_trajSave.empty() )
+        {
+            return;
+        }
+
+        m_trajectoryFilePtr = TrajectoryFilePtr( new TrajectoryFile( m_simpleTrackerParamsPtr->m_trajSave + TRAJECTORY_FILE_EXTENSION,
+                                                                     videoLength,
+                                                                     m_simpleTrackerParamsPtr->m_trajectorySyncInterval ) );
+    }
+
+    /********************************************************************
+    StoreState
+        Append the final state of a frame to the trajectory, mapped
+        back from the processing scale to the native resolution.
+    Exceptions:
+        None
+    *********************************************************************/
+    void SimpleTracker::StoreState( const int frameInd, const float leftX, const float topY, const float width, const float height )
+    {
+        if ( m_trajectoryFilePtr == NULL )
+        {
+            return;
+        }
+
+        const float nativeScale = 1.0f / m_simpleTrackerParamsPtr->m_processingScale;
+
+        m_trajectoryFilePtr->WriteState( frameInd, leftX * nativeScale, topY * nativeScale, width * nativeScale, height * nativeScale );
+    }
+
     /********************************************************************
     CalculateTrackingErrroFromGroundTruth
         Calculate the tracking error based on m_GroundTruthMatrix
@@ -583,37 +721,53 @@ namespace MultipleCameraTracking
 
         try
         {
-            if( m_groundTruthMatrix.rows( ) == 0 )
+            if( m_groundTruthMatrix.rows( ) == 0 || m_simpleTrackerParamsPtr->m_trajSave.empty() )
                 return;
             
-            int videoLength = m_states.rows();
+            //the track history is streamed back from the trajectory file, at the native resolution like the ground truth
+            TrajectoryFileReader reader;
+            if( !reader.Open( m_simpleTrackerParamsPtr->m_trajSave + TRAJECTORY_FILE_EXTENSION ) )
+            {
+                abortError(__LINE__,__FILE__,"error reading the trajectory file");
+            }
+            ASSERT_TRUE( reader.GetNumberOfFrames() <= m_groundTruthMatrix.rows() );
+
+            //the error is written one frame at a time, in the layout of DLMWrite
+            const string errorFileName = m_simpleTrackerParamsPtr->m_trajSave + "_Error.txt";
+            remove( errorFileName.c_str() );
+            ofstream strm( errorFileName.c_str(), std::ios::out );
+            if( strm.fail() )
+            {
+                abortError(__LINE__,__FILE__,"error saving trajectory error file");
+            }
 
-            Matrixf m_statesError( videoLength, 2 );
             //first column is the mean square error (pixels) of center position
             //first column: mean square error of center pixel
-            //second column:??????
-            for( int frameInd=0; frameInd < videoLength; frameInd++ )
+            //second column: f-measure of the overlap
+            int        frameInd;
+            float    state[TRAJECTORY_STATE_SIZE];
+            while( reader.ReadNextFrame( frameInd, state ) )
             {
-                float centerTrackedX = m_states( frameInd, 0 ) + m_states(frameInd, 2) / 2;
-                float centerTrackedY = m_states( frameInd, 1 ) + m_states(frameInd, 3) / 2;
+                float centerTrackedX = state[0] + state[2] / 2;
+                float centerTrackedY = state[1] + state[3] / 2;
                 float centerX = m_groundTruthMatrix( frameInd, 1 ) + m_groundTruthMatrix(frameInd, 3) / 2;
                 float centerY = m_groundTruthMatrix( frameInd, 2 ) + m_groundTruthMatrix(frameInd, 4) / 2;
                 
-                m_statesError( frameInd, 0 ) = sqrt( (centerX - centerTrackedX)*(centerX - centerTrackedX) +
-                                                     (centerY - centerTrackedY)*(centerY - centerTrackedY) );
+                float centerError = sqrt( (centerX - centerTrackedX)*(centerX - centerTrackedX) +
+                                          (centerY - centerTrackedY)*(centerY - centerTrackedY) );
 
                 //calculate overlapping area
                 float area = m_groundTruthMatrix(frameInd, 3)* m_groundTruthMatrix(frameInd, 4);
-                float area_tracked =  m_states(frameInd, 2) * m_states(frameInd, 3);
+                float area_tracked =  state[2] * state[3];
                 
-                float xleft = max( m_states( frameInd, 0 ), m_groundTruthMatrix( frameInd, 1 ) );
-                float xright = min( m_states( frameInd, 0 ) + m_states( frameInd, 2 ), 
+                float xleft = max( state[0], m_groundTruthMatrix( frameInd, 1 ) );
+                float xright = min( state[0] + state[2], 
                                      m_groundTruthMatrix( frameInd, 1 ) + m_groundTruthMatrix( frameInd, 3 ) );
 
                 float width = xright - xleft;  
 
-                float yTop = max( m_states( frameInd, 1), m_groundTruthMatrix( frameInd, 2 ) );
-                float yBottom = min( m_states( frameInd, 1 ) + m_states( frameInd, 3 ), 
+                float yTop = max( state[1], m_groundTruthMatrix( frameInd, 2 ) );
+                float yBottom = min( state[1] + state[3], 
                                     m_groundTruthMatrix( frameInd, 2 ) + m_groundTruthMatrix(frameInd, 4) );
 
                 float height = yBottom - yTop;
@@ -626,20 +780,13 @@ namespace MultipleCameraTracking
 
                 float precision = overLappingArea/area_tracked;
                 float recall = overLappingArea/area;
-                //m_statesError( frameInd, 1 ) = ( 2 * overLappingArea - area_tracked )/area ;
-                m_statesError( frameInd, 1 ) = 2*precision*recall/(precision+recall); //f-measure
+                //float overlapError = ( 2 * overLappingArea - area_tracked )/area ;
+                float overlapError = 2*precision*recall/(precision+recall); //f-measure
+
+                strm << centerError << "," << overlapError << endl;
             }
 
-            // save states
-            if( !m_simpleTrackerParamsPtr->m_trajSave.empty() )
-            {
-                //write into the specified text file
-                bool scs = m_statesError.DLMWrite( ( m_simpleTrackerParamsPtr->m_trajSave+"_Error.txt" ).c_str( ) );
-                if( !scs )
-                {
-                    abortError(__LINE__,__FILE__,"error saving trajectory error file");
-                }
-            }            
+            strm.close();
         }
         EXCEPTION_CATCH_AND_ABORT("Error while calculating and saving trajectory error file.");
     }
@@ -2,6 +2,7 @@
 #define SIMPLE_TRACKER_PUBLIC
 
 #include "Tracker.h"
+#include "TrajectoryFile.h"
 
 namespace MultipleCameraTracking
 {
@@ -42,7 +43,7 @@ namespace MultipleCameraTracking
                                                          Matrixu*                pFrameImageHSV            = NULL,
                                                          Matrixf*                pGroundTruthMatrix        = NULL ) ;  
                                                     
-        // Track each frame, store the results to m_states, and update pFrameDisplay and pFrameDisplayTraining (if required)
+        // Track each frame, store the results to the trajectory file, and update pFrameDisplay and pFrameDisplayTraining (if required)
         virtual void    TrackObjectAndSaveState( int        frameind, 
                                                   Matrixu*    pFrameImageColor, 
                                                  Matrixu*    pFrameImageGray, 
@@ -77,6 +78,10 @@ namespace MultipleCameraTracking
     
         virtual void    DrawObjectFootPosition( Matrixu* pFrameDisplay ) const { return; };
 
+        virtual bool    ComputeRegionOfInterest( const int frameWidth, const int frameHeight, IppiRect& regionOfInterest );
+
+        virtual void    SetFrameImageCache( FrameImageCachePtr frameImageCachePtr );
+
     protected:
         // Initializes tracker with first frame(s) and other parameters
         bool            InitializeTracker(  Matrixu*                pFrameImageColor, 
@@ -93,12 +98,16 @@ namespace MultipleCameraTracking
                                                     Matrixu*    pFrameImageGray,
                                                     Matrixu*    pFrameDisplayTraining= NULL,
                                                     Matrixu*    pFrameImageHSV        = NULL );
+
+        // Stream the track history to the trajectory file of the object (if any)
+        void            OpenTrajectoryFile( const uint videoLength );
+        void            StoreState( const int frameInd, const float leftX, const float topY, const float width, const float height );
         
         Classifier::StrongClassifierBasePtr            m_strongClassifierBasePtr;
         vectorf                                        m_currentStateList; //[leftX, topY, sizeX, sizeY, scaleX, scaleY]
         SimpleTrackerParametersPtr                    m_simpleTrackerParamsPtr;
         
-        Matrixf                                        m_states;                        //saves entire track history
+        TrajectoryFilePtr                            m_trajectoryFilePtr;            //track history, written as the states become final
         Classifier::SampleSet                        m_positiveSampleSet;            //positive samples
         Classifier::SampleSet                        m_negativeSampleSet;            //negative samples
         Classifier::SampleSet                        m_testSampleSet;                //detect samples
@@ -108,6 +117,8 @@ namespace MultipleCameraTracking
         
         CvMat*                                        m_pHomographyMatrix;
     private:
+        // false for the locations of a dense test grid outside the search window circle
+        bool            IsInsideSearchWindow( const int sampleIndex ) const;
 
         virtual void    GeneratePositiveTrainingSampleSet(    Matrixu*    pFrameImageColor, 
                                                             Matrixu*    pFrameImageGray, 
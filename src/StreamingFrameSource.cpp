@@ -0,0 +1,87 @@
+#include "StreamingFrameSource.h"
+
+namespace MultipleCameraTracking
+{
+    /********************************************************************
+    StreamingFrameSource
+        Constructor. Opens the input and decodes the first frame to
+        find the frame size.
+    Exceptions:
+        None
+    *********************************************************************/
+    StreamingFrameSource::StreamingFrameSource( const string&    inputPath,
+                                                const bool        readImages,
+                                                const int        startFrameIndex,
+                                                const int        endFrameIndex,
+                                                const bool        isColor,
+                                                const int        ringSize )
+        : FrameSource( isColor ),
+        m_frameDecoder( inputPath, readImages, startFrameIndex, isColor ),
+        m_frameRing( ),
+        m_ringFrameIndexList( )
+    {
+        try
+        {
+            ASSERT_TRUE( ringSize > 0 );
+            ASSERT_TRUE( endFrameIndex >= startFrameIndex );
+
+            m_numberOfFrames = endFrameIndex - startFrameIndex + 1;
+
+            m_frameRing.resize( ringSize );
+            m_ringFrameIndexList.assign( ringSize, -1 );
+
+            //decode the first frame to get the proper size
+            DecodeFrame( 0 );
+            m_frameWidth    = m_frameRing[0].cols();
+            m_frameHeight    = m_frameRing[0].rows();
+        }
+        EXCEPTION_CATCH_AND_ABORT( "Failed to construct StreamingFrameSource" );
+    }
+
+    /********************************************************************
+    GetFrame
+        Get the frame at the given index, decoding the frames up to it
+        if they are not in the ring yet.
+    Exceptions:
+        None
+    *********************************************************************/
+    Matrixu* StreamingFrameSource::GetFrame( const int frameInd )
+    {
+        ASSERT_TRUE( frameInd >= 0 && frameInd < m_numberOfFrames );
+
+        const int slotIndex = frameInd % (int)m_frameRing.size();
+
+        if ( m_ringFrameIndexList[slotIndex] != frameInd )
+        {
+            if ( !m_frameDecoder.IsRandomAccess() && frameInd < m_frameDecoder.GetNextFrameIndex() )
+            {
+                abortError( __LINE__, __FILE__, "Requested frame is no longer in the frame ring" );
+            }
+
+            //video streams are decoded into the ring up to the requested frame
+            int frameToDecode = m_frameDecoder.IsRandomAccess() ? frameInd : m_frameDecoder.GetNextFrameIndex();
+            for ( ; frameToDecode <= frameInd; frameToDecode++ )
+            {
+                DecodeFrame( frameToDecode );
+            }
+        }
+
+        return &m_frameRing[slotIndex];
+    }
+
+    /********************************************************************
+    DecodeFrame
+        Decode the given frame of the input into its ring slot.
+    Exceptions:
+        None
+    *********************************************************************/
+    void StreamingFrameSource::DecodeFrame( const int frameInd )
+    {
+        ASSERT_TRUE( frameInd < m_numberOfFrames );
+
+        const int slotIndex = frameInd % (int)m_frameRing.size();
+
+        m_frameDecoder.DecodeFrame( frameInd, m_frameRing[slotIndex] );
+        m_ringFrameIndexList[slotIndex] = frameInd;
+    }
+}
@@ -0,0 +1,43 @@
+#ifndef STREAMING_FRAME_SOURCE_HEADER
+#define STREAMING_FRAME_SOURCE_HEADER
+
+#include "FrameSource.h"
+#include "FrameDecoder.h"
+
+namespace MultipleCameraTracking
+{
+    /****************************************************************
+    StreamingFrameSource
+        Derives from FrameSource.
+        Decodes the input frames on demand into a fixed-size ring,
+        so the memory does not grow with the length of the sequence.
+        Frame k is held in ring slot (k % ringSize). Video files can
+        only be read forward; a frame that has already left the ring
+        cannot be requested again.
+    ****************************************************************/
+    class StreamingFrameSource : public FrameSource
+    {
+    public:
+        StreamingFrameSource( const string&    inputPath,
+                              const bool    readImages,
+                              const int        startFrameIndex,
+                              const int        endFrameIndex,
+                              const bool    isColor,
+                              const int        ringSize );
+
+        virtual ~StreamingFrameSource( ) { }
+
+        virtual Matrixu*    GetFrame( const int frameInd );
+
+    private:
+        DISALLOW_IMPLICIT_CONSTRUCTORS( StreamingFrameSource );
+
+        //decode the given frame into its ring slot
+        void                DecodeFrame( const int frameInd );
+
+        FrameDecoder        m_frameDecoder;            //decoder of the input sequence
+        vector<Matrixu>        m_frameRing;            //decoded frames
+        vectori                m_ringFrameIndexList;    //frame index held by each slot of the ring (-1: empty)
+    };
+}
+#endif
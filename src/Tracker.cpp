@@ -111,7 +111,6 @@ namespace MultipleCameraTracking
             colorframe.drawText(("#"+int2str(k,3)).c_str(),1,25,255,255,0);
             colorframe._keepIpl=true;
             colorframe.display(0,2);
-            cvWaitKey(1);
             if( w != NULL )
             {
                 cvWriteFrame( w, colorframe.getIpl() );
@@ -170,7 +169,6 @@ namespace MultipleCameraTracking
         {
             resvid[k]._keepIpl=true;
             resvid[k].display(0,2);
-            cvWaitKey(1);
             if( w!=NULL && k<vid.size()-1)
             {            
                 Matrixu::WriteFrame(w, resvid[k]);
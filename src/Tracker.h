@@ -5,6 +5,7 @@
 #include "Public.h"
 #include "TrackerParameters.h"
 #include "Config.h"
+#include "FrameImageCache.h"
 
 namespace MultipleCameraTracking
 {
@@ -66,6 +67,12 @@ namespace MultipleCameraTracking
 
         virtual void    DrawObjectFootPosition( Matrixu* pFrameDisplay ) const = 0;
 
+        // Region of the next frame the tracker reads while tracking and training (false: the whole frame)
+        virtual bool    ComputeRegionOfInterest( const int frameWidth, const int frameHeight, IppiRect& regionOfInterest ) { return false; }
+
+        // Share the derived images of the camera frames with the samples of the tracker
+        virtual void    SetFrameImageCache( FrameImageCachePtr frameImageCachePtr ) { m_frameImageCachePtr = frameImageCachePtr; }
+
     protected:
 
         virtual void    GeneratePositiveTrainingSampleSet(    Matrixu*    pFrameImageColor, 
@@ -79,6 +86,7 @@ namespace MultipleCameraTracking
         static CvHaarClassifierCascade*        s_faceCascade;
         CameraTrackingParametersPtr            m_cameraTrackingParametersPtr;        
         Matrixf                                m_groundTruthMatrix;
+        FrameImageCachePtr                    m_frameImageCachePtr;                //derived images of the camera frames
     };
 }
 #endif
\ No newline at end of file
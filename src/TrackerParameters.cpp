@@ -70,6 +70,9 @@ namespace MultipleCameraTracking
         m_initializeWithFaceDetection            = true;
         m_isColor                = true;
         m_trajSave                = "";
+        m_processingScale        = 1.0f;
+        m_trajectorySyncInterval= 25;
+        m_saveTextTrajectory    = true;
     }
 
     /****************************************************************
@@ -79,5 +82,6 @@ namespace MultipleCameraTracking
     {
         m_searchWindSize        = 30;
         m_negSampleStrategy     = 1;
+        m_useDenseSearch        = false;
     }
 }
\ No newline at end of file
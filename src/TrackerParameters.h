@@ -160,6 +160,9 @@ namespace MultipleCameraTracking
         string            m_displayFigureNameStr;    // Name of figure (window) to display video
         string            m_trajSave;                // filename - save file containing the coordinates of the box (text file with [x y width height] per row)
         bool            m_isColor;                // load as color images
+        float            m_processingScale;        // tracking resolution relative to the native frames; states are saved at the native resolution
+        int                m_trajectorySyncInterval;// frames between two syncs of the binary trajectory file (0: only at the end)
+        bool            m_saveTextTrajectory;    // convert the binary trajectory file to text at the end
 };
 
     /****************************************************************
@@ -173,6 +176,7 @@ namespace MultipleCameraTracking
 
         uint            m_searchWindSize;        // size of search window
         uint            m_negSampleStrategy;    // [0] all over image [1 - default] close to the search window
+        bool            m_useDenseSearch;        // evaluate the search window as dense Haar feature response maps
     };
 
     /****************************************************************
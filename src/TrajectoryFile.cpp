@@ -0,0 +1,275 @@
+#include "TrajectoryFile.h"
+
+#if defined(WIN32) || defined(WIN64)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace MultipleCameraTracking
+{
+    /****************************************************************
+    TrajectoryFile
+        Constructor. Creates the file and writes its header.
+    Exceptions:
+        None
+    ****************************************************************/
+    TrajectoryFile::TrajectoryFile( const string& fileName, const int numberOfFrames, const int syncInterval )
+        : m_pFile( NULL ),
+        m_syncInterval( syncInterval ),
+        m_numberOfRecordsSinceSync( 0 )
+    {
+        try
+        {
+            ASSERT_TRUE( numberOfFrames >= 0 );
+            ASSERT_TRUE( syncInterval >= 0 );
+
+            m_pFile = fopen( fileName.c_str(), "wb" );
+            if ( m_pFile == NULL )
+            {
+                abortError( __LINE__, __FILE__, ( "Error opening trajectory file " + fileName + " for output" ).c_str() );
+            }
+
+            TrajectoryFileHeader header;
+            memset( &header, 0, sizeof(header) );
+            memcpy( header.m_magic, TRAJECTORY_FILE_MAGIC, sizeof(header.m_magic) );
+            header.m_numberOfFrames    = numberOfFrames;
+            header.m_recordSize        = sizeof(TrajectoryRecord);
+
+            if ( fwrite( &header, sizeof(header), 1, m_pFile ) != 1 )
+            {
+                abortError( __LINE__, __FILE__, "Error writing trajectory file" );
+            }
+            fflush( m_pFile );
+        }
+        EXCEPTION_CATCH_AND_ABORT( "Failed to create the trajectory file" );
+    }
+
+    /****************************************************************
+    ~TrajectoryFile
+        Destructor.
+    Exceptions:
+        None
+    ****************************************************************/
+    TrajectoryFile::~TrajectoryFile( )
+    {
+        Close( );
+    }
+
+    /****************************************************************
+    WriteState
+        Append the state of the given frame. The record is flushed to
+        the system, and synced to the disk every few records.
+    Exceptions:
+        None
+    ****************************************************************/
+    void TrajectoryFile::WriteState( const int frameInd, const float leftX, const float topY, const float width, const float height )
+    {
+        ASSERT_TRUE( m_pFile != NULL );
+
+        TrajectoryRecord record;
+        record.m_frameIndex    = frameInd;
+        record.m_state[0]    = leftX;
+        record.m_state[1]    = topY;
+        record.m_state[2]    = width;
+        record.m_state[3]    = height;
+
+        if ( fwrite( &record, sizeof(record), 1, m_pFile ) != 1 )
+        {
+            abortError( __LINE__, __FILE__, "Error writing trajectory file" );
+        }
+        fflush( m_pFile );
+
+        m_numberOfRecordsSinceSync++;
+        if ( m_syncInterval > 0 && m_numberOfRecordsSinceSync >= m_syncInterval )
+        {
+            Sync( );
+        }
+    }
+
+    /****************************************************************
+    Close
+        Sync and close the file.
+    Exceptions:
+        None
+    ****************************************************************/
+    void TrajectoryFile::Close( )
+    {
+        if ( m_pFile == NULL )
+        {
+            return;
+        }
+
+        Sync( );
+        fclose( m_pFile );
+        m_pFile = NULL;
+    }
+
+    /****************************************************************
+    Sync
+        Write the flushed records through to the disk.
+    Exceptions:
+        None
+    ****************************************************************/
+    void TrajectoryFile::Sync( )
+    {
+        fflush( m_pFile );
+#if defined(WIN32) || defined(WIN64)
+        _commit( _fileno( m_pFile ) );
+#else
+        fsync( fileno( m_pFile ) );
+#endif
+        m_numberOfRecordsSinceSync = 0;
+    }
+
+    /****************************************************************
+    TrajectoryFile::ConvertToText
+        Convert a trajectory file to the text layout of DLMWrite, one
+        frame at a time.
+    Exceptions:
+        None
+    ****************************************************************/
+    bool TrajectoryFile::ConvertToText( const string& fileName, const string& textFileName )
+    {
+        TrajectoryFileReader reader;
+        if ( !reader.Open( fileName ) )
+        {
+            return false;
+        }
+
+        remove( textFileName.c_str() );
+        ofstream strm( textFileName.c_str(), std::ios::out );
+        if ( strm.fail() )
+        {
+            return false;
+        }
+
+        int        frameInd;
+        float    state[TRAJECTORY_STATE_SIZE];
+        while ( reader.ReadNextFrame( frameInd, state ) )
+        {
+            for ( int column = 0; column < TRAJECTORY_STATE_SIZE; column++ )
+            {
+                strm << state[column];
+                if ( column < TRAJECTORY_STATE_SIZE - 1 ) strm << ",";
+            }
+            strm << endl;
+        }
+
+        strm.close();
+        return true;
+    }
+
+    /****************************************************************
+    TrajectoryFileReader
+        Constructor.
+    Exceptions:
+        None
+    ****************************************************************/
+    TrajectoryFileReader::TrajectoryFileReader( )
+        : m_pFile( NULL ),
+        m_nextFrameIndex( 0 ),
+        m_isRecordValid( false )
+    {
+        memset( &m_header, 0, sizeof(m_header) );
+    }
+
+    /****************************************************************
+    ~TrajectoryFileReader
+        Destructor.
+    Exceptions:
+        None
+    ****************************************************************/
+    TrajectoryFileReader::~TrajectoryFileReader( )
+    {
+        Close( );
+    }
+
+    /****************************************************************
+    TrajectoryFileReader::Open
+        Open a trajectory file and check its header. Returns false if
+        the file can not be read.
+    Exceptions:
+        None
+    ****************************************************************/
+    bool TrajectoryFileReader::Open( const string& fileName )
+    {
+        Close( );
+
+        m_pFile = fopen( fileName.c_str(), "rb" );
+        if ( m_pFile == NULL )
+        {
+            return false;
+        }
+
+        if ( fread( &m_header, sizeof(m_header), 1, m_pFile ) != 1
+            || memcmp( m_header.m_magic, TRAJECTORY_FILE_MAGIC, sizeof(m_header.m_magic) ) != 0
+            || m_header.m_recordSize != sizeof(TrajectoryRecord) )
+        {
+            Close( );
+            return false;
+        }
+
+        m_nextFrameIndex = 0;
+        ReadRecord( );
+        return true;
+    }
+
+    /****************************************************************
+    TrajectoryFileReader::Close
+        Close the file.
+    Exceptions:
+        None
+    ****************************************************************/
+    void TrajectoryFileReader::Close( )
+    {
+        if ( m_pFile != NULL )
+        {
+            fclose( m_pFile );
+            m_pFile = NULL;
+        }
+        m_isRecordValid = false;
+    }
+
+    /****************************************************************
+    TrajectoryFileReader::ReadNextFrame
+        State of the next frame: the last record stored for it, zeros
+        if there is none. Returns false past the last frame.
+    Exceptions:
+        None
+    ****************************************************************/
+    bool TrajectoryFileReader::ReadNextFrame( int& frameInd, float state[TRAJECTORY_STATE_SIZE] )
+    {
+        if ( m_pFile == NULL || m_nextFrameIndex >= (int)m_header.m_numberOfFrames )
+        {
+            return false;
+        }
+
+        frameInd = m_nextFrameIndex++;
+        memset( state, 0, TRAJECTORY_STATE_SIZE * sizeof(float) );
+
+        //records of frames already passed are out of order and left out
+        while ( m_isRecordValid && m_record.m_frameIndex <= frameInd )
+        {
+            if ( m_record.m_frameIndex == frameInd )
+            {
+                memcpy( state, m_record.m_state, TRAJECTORY_STATE_SIZE * sizeof(float) );
+            }
+            ReadRecord( );
+        }
+
+        return true;
+    }
+
+    /****************************************************************
+    TrajectoryFileReader::ReadRecord
+        Read the next record; a record cut short by a crash ends the
+        records.
+    Exceptions:
+        None
+    ****************************************************************/
+    void TrajectoryFileReader::ReadRecord( )
+    {
+        m_isRecordValid = fread( &m_record, sizeof(m_record), 1, m_pFile ) == 1;
+    }
+}
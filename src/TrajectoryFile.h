@@ -0,0 +1,116 @@
+#ifndef TRAJECTORY_FILE_HEADER
+#define TRAJECTORY_FILE_HEADER
+
+#include "Public.h"
+#include "CommonMacros.h"
+
+#include <boost/shared_ptr.hpp>
+
+#define TRAJECTORY_FILE_MAGIC        "MCTTRJ01"
+#define TRAJECTORY_FILE_EXTENSION    ".trj"
+#define TRAJECTORY_STATE_SIZE        4
+
+namespace MultipleCameraTracking
+{
+    /****************************************************************
+    TrajectoryFileHeader
+        Header at the beginning of a binary trajectory file. The
+        records follow, one per stored frame state, in the order
+        they were stored, which is the frame order; a frame stored
+        again overrides the earlier record.
+    ****************************************************************/
+    struct TrajectoryFileHeader
+    {
+        char            m_magic[8];            //TRAJECTORY_FILE_MAGIC
+        unsigned int    m_numberOfFrames;    //rows of the text layout (the video length)
+        unsigned int    m_recordSize;        //bytes per record
+    };
+
+    /****************************************************************
+    TrajectoryRecord
+        State of the object on one frame, [leftX, topY, width,
+        height] at the native resolution of the frames.
+    ****************************************************************/
+    struct TrajectoryRecord
+    {
+        int                m_frameIndex;
+        float            m_state[TRAJECTORY_STATE_SIZE];
+    };
+
+    //Forward Declaration
+    class TrajectoryFile;
+
+    //declarations of shared ptr
+    typedef boost::shared_ptr<TrajectoryFile>    TrajectoryFilePtr;
+
+    /****************************************************************
+    TrajectoryFile
+        Streams the states of a tracked object into a binary
+        trajectory file as they become final, so the memory does
+        not grow with the run and a crash loses at most the frames
+        since the last sync. Every record is flushed, so the file
+        can be followed while tracking runs; it is synced to the
+        disk every few frames. ConvertToText streams a file into
+        the text layout of Matrix::DLMWrite, one row per frame with
+        zeros for the frames not tracked.
+    ****************************************************************/
+    class TrajectoryFile
+    {
+    public:
+        TrajectoryFile( const string& fileName, const int numberOfFrames, const int syncInterval );
+        ~TrajectoryFile( );
+
+        //append the state of the given frame
+        void            WriteState( const int frameInd, const float leftX, const float topY, const float width, const float height );
+
+        //sync and close the file; done by the destructor too
+        void            Close( );
+
+        //static functions
+        static bool        ConvertToText( const string& fileName, const string& textFileName );
+
+    private:
+        DISALLOW_IMPLICIT_CONSTRUCTORS( TrajectoryFile );
+
+        void            Sync( );
+
+        FILE*            m_pFile;
+        const int        m_syncInterval;                    //records between two syncs (0: only when closing)
+        int                m_numberOfRecordsSinceSync;
+    };
+
+    /****************************************************************
+    TrajectoryFileReader
+        Reads a trajectory file back one frame at a time, from the
+        first frame to the last of the video, without holding more
+        than one record: the state of a frame without a record is
+        zeros, and a record cut short by a crash is left out.
+    ****************************************************************/
+    class TrajectoryFileReader
+    {
+    public:
+        TrajectoryFileReader( );
+        ~TrajectoryFileReader( );
+
+        //false if the file can not be read
+        bool            Open( const string& fileName );
+        void            Close( );
+
+        //state of the next frame; false past the last frame
+        bool            ReadNextFrame( int& frameInd, float state[TRAJECTORY_STATE_SIZE] );
+
+        int                GetNumberOfFrames( ) const { return (int)m_header.m_numberOfFrames; }
+
+    private:
+        DISALLOW_EVIL_CONSTRUCTORS( TrajectoryFileReader );
+
+        void            ReadRecord( );
+
+        FILE*                    m_pFile;
+        TrajectoryFileHeader    m_header;
+        int                        m_nextFrameIndex;
+        TrajectoryRecord        m_record;            //next record not consumed yet
+        bool                    m_isRecordValid;    //false once the records are exhausted
+    };
+}
+#endif
@@ -0,0 +1,262 @@
+#include "VideoEncoder.h"
+
+namespace MultipleCameraTracking
+{
+    /********************************************************************
+    VideoEncoder
+        Constructor. Starts the encoding threads.
+    Exceptions:
+        None
+    *********************************************************************/
+    VideoEncoder::VideoEncoder( const int numberOfThreads, const int queueSize, const bool dropFramesWhenBehind )
+        : m_numberOfThreads( numberOfThreads ),
+        m_queueSize( queueSize ),
+        m_dropFramesWhenBehind( dropFramesWhenBehind ),
+        m_videoList( ),
+        m_jobQueueList( numberOfThreads ),
+        m_reservedJobCountList( numberOfThreads, 0 ),
+        m_stopEncoding( false )
+    {
+        try
+        {
+            ASSERT_TRUE( m_numberOfThreads >= 0 );
+            ASSERT_TRUE( m_queueSize > 0 );
+
+            for ( int threadIndex = 0; threadIndex < m_numberOfThreads; threadIndex++ )
+            {
+                m_encodingThreads.create_thread( boost::bind( &VideoEncoder::EncodeFrames, this, threadIndex ) );
+            }
+        }
+        EXCEPTION_CATCH_AND_ABORT( "Failed to construct VideoEncoder" );
+    }
+
+    /********************************************************************
+    ~VideoEncoder
+        Destructor. Encodes the queued frames, closes the videos left
+        open and stops the encoding threads.
+    Exceptions:
+        None
+    *********************************************************************/
+    VideoEncoder::~VideoEncoder( )
+    {
+        for ( int videoId = 0; videoId < (int)m_videoList.size(); videoId++ )
+        {
+            CloseVideo( videoId );
+        }
+
+        {
+            boost::mutex::scoped_lock lock( m_mutex );
+            m_stopEncoding = true;
+        }
+        m_jobQueued.notify_all();
+        m_encodingThreads.join_all();
+    }
+
+    /********************************************************************
+    OpenVideo
+        Open an output video and assign it to an encoding thread.
+    Exceptions:
+        None
+    *********************************************************************/
+    int VideoEncoder::OpenVideo( const string& fileName, const int frameWidth, const int frameHeight )
+    {
+        CvVideoWriter* pVideoWriter = cvCreateVideoWriter(    fileName.c_str(),
+                                                            CV_FOURCC('x','v','i','d'),
+                                                            15,
+                                                            cvSize( frameWidth, frameHeight ),
+                                                            3 );
+        if ( pVideoWriter == NULL )
+        {
+            return -1;
+        }
+
+        boost::mutex::scoped_lock lock( m_mutex );
+
+        EncodedVideo video;
+        video.m_pVideoWriter            = pVideoWriter;
+        video.m_threadIndex                = ( m_numberOfThreads > 0 ) ? (int)m_videoList.size() % m_numberOfThreads : -1;
+        video.m_numberOfPendingFrames    = 0;
+        video.m_numberOfDroppedFrames    = 0;
+        m_videoList.push_back( video );
+
+        return (int)m_videoList.size() - 1;
+    }
+
+    /********************************************************************
+    WriteFrame
+        Queue a snapshot of the frame for the given video. The frame
+        can be drawn over again as soon as this returns.
+    Exceptions:
+        None
+    *********************************************************************/
+    bool VideoEncoder::WriteFrame( const int videoId, Matrixu& frame )
+    {
+        boost::mutex::scoped_lock lock( m_mutex );
+
+        if ( videoId < 0 || videoId >= (int)m_videoList.size() || m_videoList[videoId].m_pVideoWriter == NULL )
+        {
+            return false;
+        }
+
+        const int threadIndex = m_videoList[videoId].m_threadIndex;
+
+        //reserve room in the queue of the thread before taking the snapshot
+        if ( threadIndex >= 0 )
+        {
+            if ( m_reservedJobCountList[threadIndex] >= m_queueSize && m_dropFramesWhenBehind )
+            {
+                m_videoList[videoId].m_numberOfDroppedFrames++;
+                return false;
+            }
+
+            while ( m_reservedJobCountList[threadIndex] >= m_queueSize )
+            {
+                m_jobTaken.wait( lock );
+            }
+            m_reservedJobCountList[threadIndex]++;
+        }
+
+        IplImage* pFreeSnapshot = NULL;
+        if ( !m_videoList[videoId].m_freeSnapshotList.empty() )
+        {
+            pFreeSnapshot = m_videoList[videoId].m_freeSnapshotList.back();
+            m_videoList[videoId].m_freeSnapshotList.pop_back();
+        }
+        m_videoList[videoId].m_numberOfPendingFrames++;
+
+        //the copy does not need the lock
+        lock.unlock();
+        EncodingJob job;
+        job.m_videoId    = videoId;
+        job.m_pSnapshot    = TakeSnapshot( frame, pFreeSnapshot );
+        lock.lock();
+
+        if ( threadIndex < 0 )
+        {
+            //no encoding thread, encode on the caller
+            cvWriteFrame( m_videoList[videoId].m_pVideoWriter, job.m_pSnapshot );
+            m_videoList[videoId].m_freeSnapshotList.push_back( job.m_pSnapshot );
+            m_videoList[videoId].m_numberOfPendingFrames--;
+            return true;
+        }
+
+        m_jobQueueList[threadIndex].push_back( job );
+        m_jobQueued.notify_all();
+
+        return true;
+    }
+
+    /********************************************************************
+    CloseVideo
+        Wait for the queued frames of the video to be encoded and close
+        it.
+    Exceptions:
+        None
+    *********************************************************************/
+    void VideoEncoder::CloseVideo( const int videoId )
+    {
+        boost::mutex::scoped_lock lock( m_mutex );
+
+        if ( videoId < 0 || videoId >= (int)m_videoList.size() || m_videoList[videoId].m_pVideoWriter == NULL )
+        {
+            return;
+        }
+
+        while ( m_videoList[videoId].m_numberOfPendingFrames > 0 )
+        {
+            m_frameEncoded.wait( lock );
+        }
+
+        EncodedVideo& video = m_videoList[videoId];
+
+        cvReleaseVideoWriter( &video.m_pVideoWriter );
+        video.m_pVideoWriter = NULL;
+
+        for ( int snapshotIndex = 0; snapshotIndex < (int)video.m_freeSnapshotList.size(); snapshotIndex++ )
+        {
+            cvReleaseImage( &video.m_freeSnapshotList[snapshotIndex] );
+        }
+        video.m_freeSnapshotList.clear();
+
+        if ( video.m_numberOfDroppedFrames > 0 )
+        {
+            LOG( "Video encoder fell behind: " << video.m_numberOfDroppedFrames << " frames dropped" << endl );
+        }
+    }
+
+    /********************************************************************
+    EncodeFrames
+        Encoding thread. Encodes the queued snapshots in order until it
+        is stopped and its queue is empty. The codec runs without the
+        lock.
+    Exceptions:
+        None
+    *********************************************************************/
+    void VideoEncoder::EncodeFrames( const int threadIndex )
+    {
+        boost::mutex::scoped_lock lock( m_mutex );
+
+        std::deque<EncodingJob>& jobQueue = m_jobQueueList[threadIndex];
+
+        while ( true )
+        {
+            while ( jobQueue.empty() && !m_stopEncoding )
+            {
+                m_jobQueued.wait( lock );
+            }
+
+            if ( jobQueue.empty() )
+            {
+                return;
+            }
+
+            EncodingJob job = jobQueue.front();
+            jobQueue.pop_front();
+
+            m_reservedJobCountList[threadIndex]--;
+            m_jobTaken.notify_all();
+
+            CvVideoWriter* pVideoWriter = m_videoList[job.m_videoId].m_pVideoWriter;
+
+            lock.unlock();
+            cvWriteFrame( pVideoWriter, job.m_pSnapshot );
+            lock.lock();
+
+            m_videoList[job.m_videoId].m_freeSnapshotList.push_back( job.m_pSnapshot );
+            m_videoList[job.m_videoId].m_numberOfPendingFrames--;
+            m_frameEncoded.notify_all();
+        }
+    }
+
+    /********************************************************************
+    TakeSnapshot
+        Copy the interleaved image of the frame into the snapshot,
+        allocating a new one if there is no free snapshot of the right
+        size.
+    Exceptions:
+        None
+    *********************************************************************/
+    IplImage* VideoEncoder::TakeSnapshot( Matrixu& frame, IplImage* pFreeSnapshot )
+    {
+        frame.createIpl();
+        IplImage* pFrameImage = frame.getIpl();
+
+        IplImage* pSnapshot = pFreeSnapshot;
+        if ( pSnapshot != NULL && ( pSnapshot->width != pFrameImage->width || pSnapshot->height != pFrameImage->height ) )
+        {
+            cvReleaseImage( &pSnapshot );
+        }
+
+        if ( pSnapshot == NULL )
+        {
+            pSnapshot = cvCreateImage( cvSize( pFrameImage->width, pFrameImage->height ), IPL_DEPTH_8U, 3 );
+        }
+
+        cvCopy( pFrameImage, pSnapshot );
+
+        //same orientation as Matrixu::WriteFrame
+        pSnapshot->origin = 1;
+
+        return pSnapshot;
+    }
+}
@@ -0,0 +1,86 @@
+#ifndef VIDEO_ENCODER_HEADER
+#define VIDEO_ENCODER_HEADER
+
+#include "Matrix.h"
+#include "Public.h"
+#include "CommonMacros.h"
+
+#include <deque>
+#include <boost/shared_ptr.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread.hpp>
+
+namespace MultipleCameraTracking
+{
+    //Forward Declaration
+    class VideoEncoder;
+
+    //declarations of shared ptr
+    typedef boost::shared_ptr<VideoEncoder>    VideoEncoderPtr;
+
+    /****************************************************************
+    VideoEncoder
+        Encoding service for all the output videos of a camera
+        network. WriteFrame takes a snapshot of the frame and queues
+        it; the encoding itself runs on the threads of the service,
+        so the tracking threads do not wait for the codec. Each video
+        is encoded by one thread, which keeps its frames in order.
+        When the bounded queue of a thread is full, WriteFrame either
+        waits for room or drops the frame, depending on the policy.
+        With no thread the frames are encoded by the caller.
+    ****************************************************************/
+    class VideoEncoder
+    {
+    public:
+        VideoEncoder( const int numberOfThreads, const int queueSize, const bool dropFramesWhenBehind );
+        ~VideoEncoder( );
+
+        //open an xvid video of the given frame size; -1 if it can not be opened
+        int            OpenVideo( const string& fileName, const int frameWidth, const int frameHeight );
+
+        //queue a snapshot of the frame for the video; false if the video is not open or the frame was dropped
+        bool        WriteFrame( const int videoId, Matrixu& frame );
+
+        //encode the queued frames of the video and close it
+        void        CloseVideo( const int videoId );
+
+    private:
+        DISALLOW_IMPLICIT_CONSTRUCTORS( VideoEncoder );
+
+        struct EncodedVideo
+        {
+            CvVideoWriter*        m_pVideoWriter;                //NULL once closed
+            int                    m_threadIndex;                //thread encoding this video
+            int                    m_numberOfPendingFrames;    //queued and not encoded yet
+            long                m_numberOfDroppedFrames;
+            vector<IplImage*>    m_freeSnapshotList;            //snapshots given back by the encoding thread
+        };
+
+        struct EncodingJob
+        {
+            int                    m_videoId;
+            IplImage*            m_pSnapshot;
+        };
+
+        //body of the encoding threads
+        void                    EncodeFrames( const int threadIndex );
+
+        //copy the frame into a snapshot of the video, reusing a free one
+        static IplImage*        TakeSnapshot( Matrixu& frame, IplImage* pFreeSnapshot );
+
+        const int                            m_numberOfThreads;
+        const int                            m_queueSize;                //jobs per thread
+        const bool                            m_dropFramesWhenBehind;        //drop instead of waiting for room
+
+        boost::mutex                        m_mutex;                    //guards the videos and the queues
+        boost::condition_variable            m_jobQueued;
+        boost::condition_variable            m_jobTaken;
+        boost::condition_variable            m_frameEncoded;
+        vector<EncodedVideo>                m_videoList;                //indexed by video id
+        vector< std::deque<EncodingJob> >    m_jobQueueList;                //one queue per thread
+        vectori                                m_reservedJobCountList;        //queued jobs plus jobs being snapshot, per thread
+        bool                                m_stopEncoding;
+        boost::thread_group                    m_encodingThreads;
+    };
+}
+#endif
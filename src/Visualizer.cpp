@@ -0,0 +1,275 @@
+#include "Visualizer.h"
+
+#include <set>
+
+Visualizer Visualizer::s_instance;
+
+/********************************************************************
+Visualizer
+    Constructor. The visualization thread is started by the first
+    snapshot.
+Exceptions:
+    None
+*********************************************************************/
+Visualizer::Visualizer( )
+    : m_windowSnapshotMap( ),
+    m_isRunning( false ),
+    m_stop( false ),
+    m_lastKey( -1 ),
+    m_numberOfKeysPressed( 0 )
+{
+}
+
+/********************************************************************
+~Visualizer
+    Destructor. Runs during static destruction, where joining a
+    thread is unsafe: the visualization thread must have been
+    stopped already (see Stop).
+Exceptions:
+    None
+*********************************************************************/
+Visualizer::~Visualizer( )
+{
+    assert( !m_isRunning || m_stop );
+}
+
+/********************************************************************
+GetInstance
+    Get the visualizer of the process.
+Exceptions:
+    None
+*********************************************************************/
+Visualizer& Visualizer::GetInstance( )
+{
+    return s_instance;
+}
+
+/********************************************************************
+Show
+    Copy the image into the snapshot of the window. A snapshot not
+    shown yet is overwritten.
+Exceptions:
+    None
+*********************************************************************/
+void Visualizer::Show( const char* windowName, const IplImage* pImage, const float p )
+{
+#ifndef HEADLESS
+    ASSERT_TRUE( windowName != NULL && pImage != NULL );
+
+    boost::mutex::scoped_lock lock( m_mutex );
+
+    if ( m_stop )
+    {
+        return;
+    }
+
+    if ( !m_isRunning )
+    {
+        m_visualizationThread    = boost::thread( &Visualizer::ShowWindows, this );
+        m_isRunning                = true;
+    }
+
+    WindowSnapshot& snapshot = m_windowSnapshotMap[windowName];
+
+    IplImage* pSnapshotImage = snapshot.m_pImage;
+    if ( pSnapshotImage == NULL )
+    {
+        pSnapshotImage            = snapshot.m_pSpareImage;
+        snapshot.m_pSpareImage    = NULL;
+    }
+
+    if ( pSnapshotImage != NULL &&
+         ( pSnapshotImage->width != pImage->width || pSnapshotImage->height != pImage->height ||
+           pSnapshotImage->depth != pImage->depth || pSnapshotImage->nChannels != pImage->nChannels ) )
+    {
+        cvReleaseImage( &pSnapshotImage );
+    }
+
+    if ( pSnapshotImage == NULL )
+    {
+        pSnapshotImage = cvCreateImage( cvSize( pImage->width, pImage->height ), pImage->depth, pImage->nChannels );
+    }
+
+    cvCopy( pImage, pSnapshotImage );
+    pSnapshotImage->origin = pImage->origin;
+
+    snapshot.m_pImage    = pSnapshotImage;
+    snapshot.m_scale    = p;
+#endif
+}
+
+/********************************************************************
+WaitKey
+    Wait for a key pressed in one of the windows. The events are
+    pumped by the visualization thread; without windows there is no
+    key to wait for.
+Exceptions:
+    None
+*********************************************************************/
+int Visualizer::WaitKey( const int delay )
+{
+    boost::mutex::scoped_lock lock( m_mutex );
+
+    if ( !m_isRunning || m_stop )
+    {
+        if ( delay > 0 )
+        {
+            lock.unlock();
+            boost::this_thread::sleep( boost::posix_time::milliseconds( delay ) );
+        }
+        return -1;
+    }
+
+    const long numberOfKeysPressed = m_numberOfKeysPressed;
+
+    if ( delay <= 0 )
+    {
+        while ( m_numberOfKeysPressed == numberOfKeysPressed && !m_stop )
+        {
+            m_keyPressed.wait( lock );
+        }
+    }
+    else
+    {
+        const boost::system_time timeout = boost::get_system_time() + boost::posix_time::milliseconds( delay );
+        while ( m_numberOfKeysPressed == numberOfKeysPressed && !m_stop )
+        {
+            if ( !m_keyPressed.timed_wait( lock, timeout ) )
+            {
+                break;
+            }
+        }
+    }
+
+    return ( m_numberOfKeysPressed != numberOfKeysPressed ) ? m_lastKey : -1;
+}
+
+/********************************************************************
+Stop
+    Stop the visualization thread, which closes the windows.
+Exceptions:
+    None
+*********************************************************************/
+void Visualizer::Stop( )
+{
+    {
+        boost::mutex::scoped_lock lock( m_mutex );
+        if ( m_stop )
+        {
+            return;
+        }
+        m_stop = true;
+    }
+
+    if ( m_isRunning )
+    {
+        m_visualizationThread.join();
+    }
+
+    //wake up anybody still waiting for a key
+    m_keyPressed.notify_all();
+
+    for ( std::map<string, WindowSnapshot>::iterator iter = m_windowSnapshotMap.begin(); iter != m_windowSnapshotMap.end(); iter++ )
+    {
+        if ( iter->second.m_pImage != NULL )
+        {
+            cvReleaseImage( &iter->second.m_pImage );
+        }
+        if ( iter->second.m_pSpareImage != NULL )
+        {
+            cvReleaseImage( &iter->second.m_pSpareImage );
+        }
+    }
+    m_windowSnapshotMap.clear();
+}
+
+/********************************************************************
+ShowWindows
+    Visualization thread. Shows the new snapshots and pumps the
+    window events until it is stopped. HighGUI runs without the lock.
+Exceptions:
+    None
+*********************************************************************/
+void Visualizer::ShowWindows( )
+{
+#ifndef HEADLESS
+    std::set<string>    openWindowSet;
+    vector<string>        windowNameList;
+    vector<IplImage*>    imageList;
+    vectorf                scaleList;
+
+    while ( true )
+    {
+        windowNameList.clear();
+        imageList.clear();
+        scaleList.clear();
+
+        //take the new snapshots
+        {
+            boost::mutex::scoped_lock lock( m_mutex );
+
+            if ( m_stop )
+            {
+                break;
+            }
+
+            for ( std::map<string, WindowSnapshot>::iterator iter = m_windowSnapshotMap.begin(); iter != m_windowSnapshotMap.end(); iter++ )
+            {
+                if ( iter->second.m_pImage != NULL )
+                {
+                    windowNameList.push_back( iter->first );
+                    imageList.push_back( iter->second.m_pImage );
+                    scaleList.push_back( iter->second.m_scale );
+                    iter->second.m_pImage = NULL;
+                }
+            }
+        }
+
+        for ( uint windowIndex = 0; windowIndex < windowNameList.size(); windowIndex++ )
+        {
+            const char* windowName    = windowNameList[windowIndex].c_str();
+            const int    cols        = imageList[windowIndex]->width;
+            const int    rows        = imageList[windowIndex]->height;
+            const float    p            = scaleList[windowIndex];
+
+            if ( openWindowSet.insert( windowNameList[windowIndex] ).second )
+            {
+                cvNamedWindow( windowName, 0/*CV_WINDOW_AUTOSIZE*/ );
+            }
+
+            cvShowImage( windowName, imageList[windowIndex] );
+            cvResizeWindow( windowName, max((int)(cols*p),(int)200), (int)max((int)(rows*p),(int)(rows*(200.0f/cols))) );
+        }
+
+        //give the shown snapshots back for reuse
+        {
+            boost::mutex::scoped_lock lock( m_mutex );
+
+            for ( uint windowIndex = 0; windowIndex < windowNameList.size(); windowIndex++ )
+            {
+                WindowSnapshot& snapshot = m_windowSnapshotMap[windowNameList[windowIndex]];
+                if ( snapshot.m_pSpareImage == NULL )
+                {
+                    snapshot.m_pSpareImage = imageList[windowIndex];
+                }
+                else
+                {
+                    cvReleaseImage( &imageList[windowIndex] );
+                }
+            }
+        }
+
+        //pump the window events
+        const int key = cvWaitKey( VISUALIZER_EVENT_INTERVAL_MS );
+        if ( key >= 0 )
+        {
+            boost::mutex::scoped_lock lock( m_mutex );
+            m_lastKey = key;
+            m_numberOfKeysPressed++;
+            m_keyPressed.notify_all();
+        }
+    }
+
+    cvDestroyAllWindows();
+#endif
+}
@@ -0,0 +1,68 @@
+#ifndef VISUALIZER_HEADER
+#define VISUALIZER_HEADER
+
+#include "Public.h"
+#include "CommonMacros.h"
+
+#include <map>
+#include <boost/thread.hpp>
+
+//window event pump period of the visualization thread
+#define VISUALIZER_EVENT_INTERVAL_MS    10
+
+/****************************************************************
+Visualizer
+    Owns every HighGUI window and key event of the process.
+    Tracking code publishes snapshots of the images to show; a
+    single visualization thread, started on the first snapshot,
+    creates the windows, shows the latest snapshot of each window
+    and pumps the events, so the tracking threads never call
+    into HighGUI nor sleep in cvWaitKey. A window only keeps its
+    latest snapshot: publishing never waits for the display.
+    Built with HEADLESS defined, no window is ever created and
+    publishing costs nothing.
+****************************************************************/
+class Visualizer
+{
+public:
+    static Visualizer&    GetInstance( );
+
+    //publish a copy of the image to the named window, shown p times its size
+    void                Show( const char* windowName, const IplImage* pImage, const float p );
+
+    //same as cvWaitKey: the key pressed within delay ms (forever if delay <= 0), -1 if none
+    int                    WaitKey( const int delay );
+
+    //close the windows and stop the visualization thread; to be called before main returns
+    void                Stop( );
+
+    ~Visualizer( );
+
+private:
+    Visualizer( );
+    DISALLOW_EVIL_CONSTRUCTORS( Visualizer );
+
+    struct WindowSnapshot
+    {
+        WindowSnapshot( ) : m_pImage( NULL ), m_pSpareImage( NULL ), m_scale( 1.0f ) { }
+
+        IplImage*    m_pImage;            //latest snapshot, NULL once taken by the visualization thread
+        IplImage*    m_pSpareImage;        //shown snapshot given back for reuse
+        float        m_scale;
+    };
+
+    static Visualizer                        s_instance;
+
+    //body of the visualization thread
+    void                ShowWindows( );
+
+    boost::mutex                            m_mutex;                //guards everything below but the windows
+    boost::condition_variable                m_keyPressed;
+    std::map<string, WindowSnapshot>        m_windowSnapshotMap;    //latest snapshot of each window
+    bool                                    m_isRunning;            //the visualization thread was started
+    bool                                    m_stop;
+    int                                        m_lastKey;
+    long                                    m_numberOfKeysPressed;
+    boost::thread                            m_visualizationThread;
+};
+#endif
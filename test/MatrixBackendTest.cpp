@@ -0,0 +1,563 @@
+// Equivalence test of the Matrix primitives (see MatrixBackend.h): every MatrixBackend function is run on
+// random planes and compared with plain scalar loops that spell out the contract of the header. Built
+// against either backend (make test, make test BACKEND=portable), so the IPP and the portable results are
+// held to the same reference. The widths are odd and straddle the vector widths (4, 8, 16 and 32 elements),
+// so the remainder loops run; the bytes past the roi of each destination row must be left untouched.
+// Prints the failed checks and returns non zero if there is any.
+
+#include "MatrixBackend.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+// planes smaller than the vector width, straddling it, and with long tails
+static const int    s_widths[]    = { 1, 2, 3, 7, 15, 17, 31, 33, 47, 65, 101 };
+static const int    s_heights[]    = { 1, 3, 8 };
+
+#define NUMBER_OF_WIDTHS    (int)(sizeof(s_widths)/sizeof(s_widths[0]))
+#define NUMBER_OF_HEIGHTS    (int)(sizeof(s_heights)/sizeof(s_heights[0]))
+
+// value of the bytes past the roi, which no primitive may write
+#define PADDING_BYTE        0xA5
+
+// differing elements reported per plane
+#define MAXIMUM_REPORTED_FAILURES    5
+
+static int            s_numberOfChecks    = 0;
+static int            s_numberOfFailures    = 0;
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////
+// random numbers: a fixed generator, so a failure reproduces on every platform
+
+static unsigned int    s_seed = 12345;
+
+static unsigned int    randomInt()
+{
+    s_seed = s_seed*1103515245u + 12345u;
+    return ( s_seed >> 8 ) & 0xFFFFFF;
+}
+
+static int            randomInt(int n)
+{
+    return (int)( randomInt() % (unsigned int)n );
+}
+
+static float        randomFloat(float low, float high)
+{
+    return low + ( high - low )*( (float)randomInt()/(float)0xFFFFFF );
+}
+
+// a quarter of the values at the ends of the range, so the saturation is exercised
+static Ipp8u        random8u()
+{
+    static const Ipp8u s_extremes[] = { 0, 1, 254, 255 };
+    return randomInt(4) == 0 ? s_extremes[randomInt(4)] : (Ipp8u)randomInt(256);
+}
+
+static Ipp8u        saturate8u(int v)
+{
+    return (Ipp8u)( v < 0 ? 0 : ( v > 255 ? 255 : v ) );
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////
+// planes allocated by the backend, with their padding filled
+
+template<class P> class Plane
+{
+public:
+    Plane(int cols, int rows) : m_cols(cols), m_rows(rows)
+    {
+        m_data = (P*)MatrixBackend::AllocPlane(sizeof(P), cols, rows, m_step);
+        memset(m_data, PADDING_BYTE, (size_t)m_step*rows);
+    }
+    ~Plane() { MatrixBackend::FreePlane(m_data); }
+
+    P&            operator()(int row, int col) { return ((P*)((char*)m_data + (size_t)row*m_step))[col]; }
+    P            operator()(int row, int col) const { return ((const P*)((const char*)m_data + (size_t)row*m_step))[col]; }
+
+    P*            data() { return m_data; }
+    const P*    data() const { return m_data; }
+    int            step() const { return m_step; }
+    int            cols() const { return m_cols; }
+    int            rows() const { return m_rows; }
+    IppiSize    size() const { IppiSize s = { m_cols, m_rows }; return s; }
+
+    // true if the bytes past the first cols elements of every row still hold the padding
+    bool        isPaddingIntact(int cols) const
+    {
+        for( int row=0; row<m_rows; row++ ){
+            const unsigned char *rs = (const unsigned char*)m_data + (size_t)row*m_step;
+            for( int k=cols*(int)sizeof(P); k<m_step; k++ )
+                if( rs[k] != PADDING_BYTE ) return false;
+        }
+        return true;
+    }
+
+private:
+    Plane(const Plane&);
+    void operator=(const Plane&);
+
+    P*            m_data;
+    int            m_step;
+    int            m_cols;
+    int            m_rows;
+};
+
+static void            fill(Plane<Ipp8u> &plane)
+{
+    for( int row=0; row<plane.rows(); row++ )
+        for( int col=0; col<plane.cols(); col++ )
+            plane(row,col) = random8u();
+}
+
+static void            fill(Plane<Ipp32f> &plane, float low, float high)
+{
+    for( int row=0; row<plane.rows(); row++ )
+        for( int col=0; col<plane.cols(); col++ )
+            plane(row,col) = randomFloat(low, high);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////
+// checks
+
+static bool            check(bool ok, const char *name, int cols, int rows, const char *detail)
+{
+    s_numberOfChecks++;
+    if( !ok ){
+        s_numberOfFailures++;
+        printf("FAILED %s (%d x %d): %s\n", name, cols, rows, detail);
+    }
+    return ok;
+}
+
+static bool            near(double value, double reference, double relativeTolerance)
+{
+    return fabs(value - reference) <= relativeTolerance*std::max(1.0, fabs(reference));
+}
+
+// compares the roi of a plane with the reference plane, and checks its padding
+template<class P> static void    checkPlane(const char *name, const Plane<P> &res, const Plane<P> &ref, double tolerance)
+{
+    int failures = 0;
+    char detail[256];
+    for( int row=0; row<ref.rows(); row++ )
+        for( int col=0; col<ref.cols(); col++ )
+            if( !near(res(row,col), ref(row,col), tolerance) && failures++ < MAXIMUM_REPORTED_FAILURES ){
+                sprintf(detail, "(%d,%d) is %g, expected %g", row, col, (double)res(row,col), (double)ref(row,col));
+                check(false, name, ref.cols(), ref.rows(), detail);
+            }
+    if( failures == 0 )
+        check(true, name, ref.cols(), ref.rows(), "");
+    check(res.isPaddingIntact(ref.cols()), name, ref.cols(), ref.rows(), "wrote past the roi");
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////
+// element wise primitives
+
+static void            testElementWise8u(int cols, int rows)
+{
+    Plane<Ipp8u> a(cols,rows), b(cols,rows), res(cols,rows), ref(cols,rows);
+    fill(a); fill(b);
+    const IppiSize roi = a.size();
+    const Ipp8u c = random8u();
+
+    MatrixBackend::Copy_8u(a.data(), a.step(), res.data(), res.step(), roi);
+    checkPlane("Copy_8u", res, a, 0);
+
+    MatrixBackend::Set_8u(c, res.data(), res.step(), roi);
+    for( int row=0; row<rows; row++ ) for( int col=0; col<cols; col++ ) ref(row,col) = c;
+    checkPlane("Set_8u", res, ref, 0);
+
+    MatrixBackend::Add_8u(a.data(), a.step(), b.data(), b.step(), res.data(), res.step(), roi);
+    for( int row=0; row<rows; row++ ) for( int col=0; col<cols; col++ ) ref(row,col) = saturate8u(a(row,col) + b(row,col));
+    checkPlane("Add_8u", res, ref, 0);
+
+    MatrixBackend::AddC_8u(a.data(), a.step(), c, res.data(), res.step(), roi);
+    for( int row=0; row<rows; row++ ) for( int col=0; col<cols; col++ ) ref(row,col) = saturate8u(a(row,col) + c);
+    checkPlane("AddC_8u", res, ref, 0);
+
+    MatrixBackend::MulC_8u(a.data(), a.step(), c, res.data(), res.step(), roi);
+    for( int row=0; row<rows; row++ ) for( int col=0; col<cols; col++ ) ref(row,col) = saturate8u(a(row,col) * c);
+    checkPlane("MulC_8u", res, ref, 0);
+
+    // the product halved (scale factor 1), rounded half to even
+    MatrixBackend::Mul_8u(a.data(), a.step(), b.data(), b.step(), res.data(), res.step(), roi);
+    for( int row=0; row<rows; row++ ) for( int col=0; col<cols; col++ ){
+        const int p = a(row,col)*b(row,col);
+        ref(row,col) = saturate8u(( p + ((p >> 1) & 1) ) >> 1);
+    }
+    checkPlane("Mul_8u", res, ref, 0);
+
+    MatrixBackend::Sqr_8u(a.data(), a.step(), res.data(), res.step(), roi);
+    for( int row=0; row<rows; row++ ) for( int col=0; col<cols; col++ ) ref(row,col) = saturate8u(a(row,col) * a(row,col));
+    checkPlane("Sqr_8u", res, ref, 0);
+
+    MatrixBackend::Exp_8u(a.data(), a.step(), res.data(), res.step(), roi);
+    for( int row=0; row<rows; row++ ) for( int col=0; col<cols; col++ )
+        ref(row,col) = saturate8u((int)floor(std::min(exp((double)a(row,col)), 255.0) + 0.5));
+    checkPlane("Exp_8u", res, ref, 0);
+}
+
+static void            testMul8uRounding()
+{
+    // every product, so each rounding tie and the saturation are hit
+    Plane<Ipp8u> a(256,256), b(256,256), res(256,256), ref(256,256);
+    for( int row=0; row<256; row++ )
+        for( int col=0; col<256; col++ ){
+            a(row,col) = (Ipp8u)row;
+            b(row,col) = (Ipp8u)col;
+            const int p = row*col;
+            ref(row,col) = saturate8u(( p + ((p >> 1) & 1) ) >> 1);
+        }
+    MatrixBackend::Mul_8u(a.data(), a.step(), b.data(), b.step(), res.data(), res.step(), a.size());
+    checkPlane("Mul_8u (all products)", res, ref, 0);
+}
+
+static void            testElementWise32f(int cols, int rows)
+{
+    Plane<Ipp32f> a(cols,rows), b(cols,rows), res(cols,rows), ref(cols,rows);
+    fill(a, -100.0f, 100.0f); fill(b, -100.0f, 100.0f);
+    const IppiSize roi = a.size();
+    const Ipp32f c = randomFloat(-10.0f, 10.0f);
+
+    MatrixBackend::Copy_32f(a.data(), a.step(), res.data(), res.step(), roi);
+    checkPlane("Copy_32f", res, a, 0);
+
+    MatrixBackend::Set_32f(c, res.data(), res.step(), roi);
+    for( int row=0; row<rows; row++ ) for( int col=0; col<cols; col++ ) ref(row,col) = c;
+    checkPlane("Set_32f", res, ref, 0);
+
+    // single float operations are exact in every implementation
+    MatrixBackend::Add_32f(a.data(), a.step(), b.data(), b.step(), res.data(), res.step(), roi);
+    for( int row=0; row<rows; row++ ) for( int col=0; col<cols; col++ ) ref(row,col) = a(row,col) + b(row,col);
+    checkPlane("Add_32f", res, ref, 0);
+
+    MatrixBackend::AddC_32f(a.data(), a.step(), c, res.data(), res.step(), roi);
+    for( int row=0; row<rows; row++ ) for( int col=0; col<cols; col++ ) ref(row,col) = a(row,col) + c;
+    checkPlane("AddC_32f", res, ref, 0);
+
+    MatrixBackend::MulC_32f(a.data(), a.step(), c, res.data(), res.step(), roi);
+    for( int row=0; row<rows; row++ ) for( int col=0; col<cols; col++ ) ref(row,col) = a(row,col) * c;
+    checkPlane("MulC_32f", res, ref, 0);
+
+    MatrixBackend::Mul_32f(a.data(), a.step(), b.data(), b.step(), res.data(), res.step(), roi);
+    for( int row=0; row<rows; row++ ) for( int col=0; col<cols; col++ ) ref(row,col) = a(row,col) * b(row,col);
+    checkPlane("Mul_32f", res, ref, 0);
+
+    MatrixBackend::Sqr_32f(a.data(), a.step(), res.data(), res.step(), roi);
+    for( int row=0; row<rows; row++ ) for( int col=0; col<cols; col++ ) ref(row,col) = a(row,col) * a(row,col);
+    checkPlane("Sqr_32f", res, ref, 0);
+
+    fill(a, -10.0f, 10.0f);
+    MatrixBackend::Exp_32f(a.data(), a.step(), res.data(), res.step(), roi);
+    for( int row=0; row<rows; row++ ) for( int col=0; col<cols; col++ ) ref(row,col) = (Ipp32f)exp((double)a(row,col));
+    checkPlane("Exp_32f", res, ref, 2e-6);
+}
+
+static void            testTranspose(int cols, int rows)
+{
+    Plane<Ipp8u> a(cols,rows), res(rows,cols), ref(rows,cols);
+    fill(a);
+    MatrixBackend::Transpose_8u(a.data(), a.step(), res.data(), res.step(), a.size());
+    for( int row=0; row<rows; row++ ) for( int col=0; col<cols; col++ ) ref(col,row) = a(row,col);
+    checkPlane("Transpose_8u", res, ref, 0);
+}
+
+static void            testGradients(int cols, int rows)
+{
+    // the filters read two elements past the roi along their direction
+    Plane<Ipp8u> a(cols+2,rows+2), res(cols,rows), ref(cols,rows);
+    fill(a);
+    const IppiSize roi = res.size();
+
+    MatrixBackend::FilterRowGradient_8u(a.data(), a.step(), res.data(), res.step(), roi);
+    for( int row=0; row<rows; row++ ) for( int col=0; col<cols; col++ ) ref(row,col) = saturate8u(a(row,col+2) - a(row,col));
+    checkPlane("FilterRowGradient_8u", res, ref, 0);
+
+    MatrixBackend::FilterColumnGradient_8u(a.data(), a.step(), res.data(), res.step(), roi);
+    for( int row=0; row<rows; row++ ) for( int col=0; col<cols; col++ ) ref(row,col) = saturate8u(a(row+2,col) - a(row,col));
+    checkPlane("FilterColumnGradient_8u", res, ref, 0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////
+// statistics
+
+// first extremum in row major order
+template<class P> static void    referenceExtremum(const Plane<P> &a, bool findMax, P &val, int &col, int &row)
+{
+    val = a(0,0); col = 0; row = 0;
+    for( int r=0; r<a.rows(); r++ )
+        for( int c=0; c<a.cols(); c++ )
+            if( findMax ? a(r,c) > val : a(r,c) < val ){
+                val = a(r,c); col = c; row = r;
+            }
+}
+
+template<class P> static void    checkExtremum(const char *name, const Plane<P> &a, bool findMax, P val)
+{
+    P refVal; int refCol, refRow;
+    referenceExtremum(a, findMax, refVal, refCol, refRow);
+
+    char detail[256];
+    sprintf(detail, "%g, expected %g", (double)val, (double)refVal);
+    check(val == refVal, name, a.cols(), a.rows(), detail);
+}
+
+template<class P> static void    checkExtremum(const char *name, const Plane<P> &a, bool findMax, P val, int col, int row)
+{
+    P refVal; int refCol, refRow;
+    referenceExtremum(a, findMax, refVal, refCol, refRow);
+
+    char detail[256];
+    sprintf(detail, "%g at (%d,%d), expected %g at (%d,%d)", (double)val, row, col, (double)refVal, refRow, refCol);
+    check(val == refVal && col == refCol && row == refRow, name, a.cols(), a.rows(), detail);
+}
+
+// several copies of the extremum, the last one in the remainder of a row, so the tie order shows
+template<class P> static void    plantTies(Plane<P> &a, P extremum)
+{
+    const int numberOfTies = 2 + randomInt(3);
+    for( int k=0; k<numberOfTies; k++ )
+        a(randomInt(a.rows()), randomInt(a.cols())) = extremum;
+    a(a.rows()-1, a.cols()-1) = extremum;
+}
+
+static void            testStatistics8u(int cols, int rows)
+{
+    Plane<Ipp8u> a(cols,rows);
+    const IppiSize roi = a.size();
+    Ipp8u val; int col, row;
+    char detail[256];
+
+    for( int findMax=0; findMax<2; findMax++ ){
+        for( int row0=0; row0<rows; row0++ ) for( int col0=0; col0<cols; col0++ ) a(row0,col0) = (Ipp8u)(10 + randomInt(200));
+        plantTies(a, (Ipp8u)( findMax ? 250 : 3 ));
+
+        if( findMax ){
+            MatrixBackend::Max_8u(a.data(), a.step(), roi, val);
+            checkExtremum("Max_8u", a, true, val);
+            MatrixBackend::MaxIndx_8u(a.data(), a.step(), roi, val, col, row);
+            checkExtremum("MaxIndx_8u", a, true, val, col, row);
+        }else{
+            MatrixBackend::Min_8u(a.data(), a.step(), roi, val);
+            checkExtremum("Min_8u", a, false, val);
+            MatrixBackend::MinIndx_8u(a.data(), a.step(), roi, val, col, row);
+            checkExtremum("MinIndx_8u", a, false, val, col, row);
+        }
+    }
+
+    // every element ties
+    for( int row0=0; row0<rows; row0++ ) for( int col0=0; col0<cols; col0++ ) a(row0,col0) = 77;
+    MatrixBackend::MaxIndx_8u(a.data(), a.step(), roi, val, col, row);
+    checkExtremum("MaxIndx_8u (constant)", a, true, val, col, row);
+    MatrixBackend::MinIndx_8u(a.data(), a.step(), roi, val, col, row);
+    checkExtremum("MinIndx_8u (constant)", a, false, val, col, row);
+
+    fill(a);
+    double sum = 0.0, sumSq = 0.0;
+    for( int row0=0; row0<rows; row0++ ) for( int col0=0; col0<cols; col0++ ){
+        sum += a(row0,col0);
+        sumSq += (double)a(row0,col0)*a(row0,col0);
+    }
+    const double n = (double)cols*rows, refMean = sum/n, refStdDev = sqrt(std::max(0.0, sumSq/n - refMean*refMean));
+
+    const double resSum = MatrixBackend::Sum_8u(a.data(), a.step(), roi);
+    sprintf(detail, "%f, expected %f", resSum, sum);
+    check(resSum == sum, "Sum_8u", cols, rows, detail);
+
+    double mean, stdDev;
+    MatrixBackend::MeanStdDev_8u(a.data(), a.step(), roi, mean, stdDev);
+    sprintf(detail, "%f %f, expected %f %f", mean, stdDev, refMean, refStdDev);
+    check(near(mean, refMean, 1e-9) && near(stdDev, refStdDev, 1e-6), "MeanStdDev_8u", cols, rows, detail);
+}
+
+static void            testStatistics32f(int cols, int rows)
+{
+    Plane<Ipp32f> a(cols,rows);
+    const IppiSize roi = a.size();
+    Ipp32f val; int col, row;
+    char detail[256];
+
+    for( int findMax=0; findMax<2; findMax++ ){
+        fill(a, -100.0f, 100.0f);
+        plantTies(a, findMax ? 1000.0f : -1000.0f);
+
+        if( findMax ){
+            MatrixBackend::Max_32f(a.data(), a.step(), roi, val);
+            checkExtremum("Max_32f", a, true, val);
+            MatrixBackend::MaxIndx_32f(a.data(), a.step(), roi, val, col, row);
+            checkExtremum("MaxIndx_32f", a, true, val, col, row);
+        }else{
+            MatrixBackend::Min_32f(a.data(), a.step(), roi, val);
+            checkExtremum("Min_32f", a, false, val);
+            MatrixBackend::MinIndx_32f(a.data(), a.step(), roi, val, col, row);
+            checkExtremum("MinIndx_32f", a, false, val, col, row);
+        }
+    }
+
+    for( int row0=0; row0<rows; row0++ ) for( int col0=0; col0<cols; col0++ ) a(row0,col0) = 0.5f;
+    MatrixBackend::MaxIndx_32f(a.data(), a.step(), roi, val, col, row);
+    checkExtremum("MaxIndx_32f (constant)", a, true, val, col, row);
+    MatrixBackend::MinIndx_32f(a.data(), a.step(), roi, val, col, row);
+    checkExtremum("MinIndx_32f (constant)", a, false, val, col, row);
+
+    fill(a, -100.0f, 100.0f);
+    double sum = 0.0, sumAbs = 0.0, sumSq = 0.0;
+    for( int row0=0; row0<rows; row0++ ) for( int col0=0; col0<cols; col0++ ){
+        sum += a(row0,col0);
+        sumAbs += fabs(a(row0,col0));
+        sumSq += (double)a(row0,col0)*a(row0,col0);
+    }
+    const double n = (double)cols*rows, refMean = sum/n, refStdDev = sqrt(std::max(0.0, sumSq/n - refMean*refMean));
+
+    // the fast hint sums in float partial sums: the error scales with the magnitudes, not the result
+    const double resSum = MatrixBackend::Sum_32f(a.data(), a.step(), roi);
+    sprintf(detail, "%f, expected %f", resSum, sum);
+    check(fabs(resSum - sum) <= 1e-5*std::max(1.0, sumAbs), "Sum_32f", cols, rows, detail);
+
+    double mean, stdDev;
+    MatrixBackend::MeanStdDev_32f(a.data(), a.step(), roi, mean, stdDev);
+    sprintf(detail, "%f %f, expected %f %f", mean, stdDev, refMean, refStdDev);
+    check(fabs(mean - refMean) <= 1e-5*std::max(1.0, sumAbs/n) && near(stdDev, refStdDev, 1e-4), "MeanStdDev_32f", cols, rows, detail);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////
+// resampling: bilinear with the pixel centers at integer coordinates; the border conventions differ
+// between the implementations, so only the pixels interpolated from inside the source are compared, and
+// the fixed point interpolation of the libraries is allowed to be off by one
+
+static bool            bilinear(const Plane<Ipp8u> &src, double x, double y, int &value)
+{
+    if( x < 0.0 || y < 0.0 || x > src.cols()-1 || y > src.rows()-1 )
+        return false;
+
+    const int x0 = std::min((int)x, std::max(src.cols()-2, 0)), y0 = std::min((int)y, std::max(src.rows()-2, 0));
+    const int x1 = std::min(x0+1, src.cols()-1), y1 = std::min(y0+1, src.rows()-1);
+    const double fx = x - x0, fy = y - y0;
+    const double top    = src(y0,x0)*(1.0-fx) + src(y0,x1)*fx;
+    const double bottom    = src(y1,x0)*(1.0-fx) + src(y1,x1)*fx;
+    value = (int)floor(top*(1.0-fy) + bottom*fy + 0.5);
+    return true;
+}
+
+static void            testResize(int cols, int rows, double xFactor, double yFactor)
+{
+    Plane<Ipp8u> src(cols,rows);
+    fill(src);
+
+    const int dstCols = std::max(1, (int)(cols*xFactor)), dstRows = std::max(1, (int)(rows*yFactor));
+    Plane<Ipp8u> res(dstCols,dstRows);
+    MatrixBackend::Resize_8u(src.data(), src.size(), src.step(), res.data(), res.step(), res.size(), xFactor, yFactor);
+
+    char name[64], detail[256];
+    sprintf(name, "Resize_8u x%g y%g", xFactor, yFactor);
+    int failures = 0;
+    for( int row=0; row<dstRows; row++ )
+        for( int col=0; col<dstCols; col++ ){
+            int value;
+            if( !bilinear(src, (col+0.5)/xFactor - 0.5, (row+0.5)/yFactor - 0.5, value) )
+                continue;
+            if( abs(res(row,col) - value) > 1 && failures++ < MAXIMUM_REPORTED_FAILURES ){
+                sprintf(detail, "(%d,%d) is %d, expected %d", row, col, res(row,col), value);
+                check(false, name, cols, rows, detail);
+            }
+        }
+    if( failures == 0 )
+        check(true, name, cols, rows, "");
+    check(res.isPaddingIntact(dstCols), name, cols, rows, "wrote past the roi");
+}
+
+static void            testWarpAffine(int cols, int rows, double angle, double scale)
+{
+    // the source rectangle mapped to a rotated and scaled copy of itself, centered in the destination
+    const IppiRect srcRect = { 0, 0, cols, rows };
+    const double c = cos(angle)*scale, s = sin(angle)*scale;
+    const double cx = 0.5*(cols-1), cy = 0.5*(rows-1);
+    const double corners[3][2] = { { 0.0, 0.0 }, { double(cols-1), 0.0 }, { double(cols-1), double(rows-1) } };
+    double quad[4][2];
+    for( int k=0; k<3; k++ ){
+        quad[k][0] = c*(corners[k][0]-cx) - s*(corners[k][1]-cy) + cx;
+        quad[k][1] = s*(corners[k][0]-cx) + c*(corners[k][1]-cy) + cy;
+    }
+    quad[3][0] = quad[0][0] + quad[2][0] - quad[1][0];
+    quad[3][1] = quad[0][1] + quad[2][1] - quad[1][1];
+
+    double coeffs[2][3];
+    MatrixBackend::GetAffineTransform(srcRect, quad, coeffs);
+
+    const double refCoeffs[2][3] = { { c, -s, cx - c*cx + s*cy }, { s, c, cy - s*cx - c*cy } };
+    char name[64], detail[256];
+    sprintf(name, "GetAffineTransform a%g s%g", angle, scale);
+    bool ok = true;
+    for( int row=0; row<2; row++ ) for( int col=0; col<3; col++ ) ok = ok && near(coeffs[row][col], refCoeffs[row][col], 1e-4);
+    sprintf(detail, "[%g %g %g; %g %g %g]", coeffs[0][0], coeffs[0][1], coeffs[0][2], coeffs[1][0], coeffs[1][1], coeffs[1][2]);
+    check(ok, name, cols, rows, detail);
+
+    Plane<Ipp8u> src(cols,rows), res(cols,rows);
+    fill(src);
+    for( int row=0; row<rows; row++ ) for( int col=0; col<cols; col++ ) res(row,col) = 42;
+    MatrixBackend::WarpAffine_8u(src.data(), src.size(), src.step(), res.data(), res.step(), res.size(), refCoeffs);
+
+    // inverse of the transform: destination to source
+    const double det = c*c + s*s;
+    sprintf(name, "WarpAffine_8u a%g s%g", angle, scale);
+    int failures = 0;
+    for( int row=0; row<rows; row++ )
+        for( int col=0; col<cols; col++ ){
+            const double dx = col - refCoeffs[0][2], dy = row - refCoeffs[1][2];
+            const double x = ( c*dx + s*dy )/det, y = ( -s*dx + c*dy )/det;
+            int value;
+            if( x < -1.0 || y < -1.0 || x > cols || y > rows ){
+                // mapped clearly outside the source: left as it was
+                value = 42;
+            }else if( x < 0.5 || y < 0.5 || x > cols-1.5 || y > rows-1.5 || !bilinear(src, x, y, value) ){
+                continue;
+            }
+            if( abs(res(row,col) - value) > 1 && failures++ < MAXIMUM_REPORTED_FAILURES ){
+                sprintf(detail, "(%d,%d) is %d, expected %d", row, col, res(row,col), value);
+                check(false, name, cols, rows, detail);
+            }
+        }
+    if( failures == 0 )
+        check(true, name, cols, rows, "");
+    check(res.isPaddingIntact(cols), name, cols, rows, "wrote past the roi");
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int                    main()
+{
+    printf("Matrix backend: %s\n", MatrixBackend::GetName());
+
+    for( int h=0; h<NUMBER_OF_HEIGHTS; h++ )
+        for( int w=0; w<NUMBER_OF_WIDTHS; w++ ){
+            const int cols = s_widths[w], rows = s_heights[h];
+            testElementWise8u(cols, rows);
+            testElementWise32f(cols, rows);
+            testTranspose(cols, rows);
+            testGradients(cols, rows);
+            testStatistics8u(cols, rows);
+            testStatistics32f(cols, rows);
+        }
+    testMul8uRounding();
+
+    static const double s_factors[] = { 0.5, 0.75, 1.5, 2.0 };
+    for( int w=4; w<NUMBER_OF_WIDTHS; w++ )
+        for( int f=0; f<4; f++ ){
+            testResize(s_widths[w], 9, s_factors[f], s_factors[f]);
+            testResize(s_widths[w], 15, s_factors[f], s_factors[3-f]);
+        }
+
+    for( int w=4; w<NUMBER_OF_WIDTHS; w++ ){
+        testWarpAffine(s_widths[w], 21, 0.0, 1.0);
+        testWarpAffine(s_widths[w], 21, 0.3, 1.0);
+        testWarpAffine(s_widths[w], 17, -0.7, 0.8);
+        testWarpAffine(s_widths[w], 17, 1.2, 1.25);
+    }
+
+    printf("%d checks, %d failed\n", s_numberOfChecks, s_numberOfFailures);
+    return s_numberOfFailures == 0 ? 0 : 1;
+}